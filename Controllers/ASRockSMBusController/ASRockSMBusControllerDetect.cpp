@@ -114,7 +114,7 @@ void DetectASRockSMBusControllers(std::vector<i2c_smbus_interface*>& busses)
         {
             if(busses[bus]->pci_subsystem_vendor == ASROCK_SUB_VEN)
             {
-                LOG_DEBUG(SMBUS_CHECK_DEVICE_MESSAGE_EN, ASROCK_DETECTOR_NAME, bus, VENDOR_NAME, SMBUS_ADDRESS);
+                LOG_DEBUG(SMBUS_CHECK_DEVICE_MESSAGE_EN, ASROCK_DETECTOR_NAME, busses[bus]->bus_id, VENDOR_NAME, SMBUS_ADDRESS);
                 // Check for Polychrome controller at 0x6A
                 if(TestForPolychromeSMBusController(busses[bus], SMBUS_ADDRESS))
                 {
@@ -162,12 +162,12 @@ void DetectASRockSMBusControllers(std::vector<i2c_smbus_interface*>& busses)
                 }
                 else
                 {
-                    LOG_DEBUG("[%s] Bus %02d has no response at 0x%02X", ASROCK_DETECTOR_NAME, bus, SMBUS_ADDRESS);
+                    LOG_DEBUG("[%s] Bus %02d has no response at 0x%02X", ASROCK_DETECTOR_NAME, busses[bus]->bus_id, SMBUS_ADDRESS);
                 }
             }
             else
             {
-                LOG_DEBUG(SMBUS_CHECK_DEVICE_FAILURE_EN, ASROCK_DETECTOR_NAME, bus, VENDOR_NAME);
+                LOG_DEBUG(SMBUS_CHECK_DEVICE_FAILURE_EN, ASROCK_DETECTOR_NAME, busses[bus]->bus_id, VENDOR_NAME);
             }
         }
     }
@@ -123,7 +123,7 @@ void DetectCorsairDominatorPlatinumControllers(std::vector<i2c_smbus_interface *
     {
         IF_DRAM_SMBUS(busses[bus]->pci_vendor, busses[bus]->pci_device)
         {
-            LOG_DEBUG("[%s] Testing bus %d", CORSAIR_DOMINATOR_PLATINUM_NAME, bus);
+            LOG_DEBUG("[%s] Testing bus %d", CORSAIR_DOMINATOR_PLATINUM_NAME, busses[bus]->bus_id);
 
             std::vector<unsigned char> addresses;
 
@@ -169,7 +169,7 @@ void DetectCorsairDominatorPlatinumControllers(std::vector<i2c_smbus_interface *
         }
         else
         {
-            LOG_DEBUG("[%s] Bus %d is not a DRAM bus", CORSAIR_DOMINATOR_PLATINUM_NAME, bus);
+            LOG_DEBUG("[%s] Bus %d is not a DRAM bus", CORSAIR_DOMINATOR_PLATINUM_NAME, busses[bus]->bus_id);
         }
     }
 }   /* DetectCorsairDominatorPlatinumControllers() */
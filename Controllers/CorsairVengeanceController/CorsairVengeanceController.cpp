@@ -17,13 +17,15 @@ CorsairVengeanceController::CorsairVengeanceController(i2c_smbus_interface* bus,
     this->bus = bus;
     this->dev = dev;
 
+    register_cache = new i2c_smbus_register_cache(bus);
+
     strcpy(device_name, "Corsair Vengeance RGB");
     led_count = 1;
 }
 
 CorsairVengeanceController::~CorsairVengeanceController()
 {
-
+    delete register_cache;
 }
 
 std::string CorsairVengeanceController::GetDeviceName()
@@ -48,10 +50,31 @@ unsigned int CorsairVengeanceController::GetLEDCount()
 
 void CorsairVengeanceController::SetLEDColor(unsigned char red, unsigned char green, unsigned char blue)
 {
-    bus->i2c_smbus_write_byte_data(dev, CORSAIR_VENGEANCE_RGB_CMD_FADE_TIME, 0x00);
-    bus->i2c_smbus_write_byte_data(dev, CORSAIR_VENGEANCE_RGB_CMD_RED_VAL, red);
-    bus->i2c_smbus_write_byte_data(dev, CORSAIR_VENGEANCE_RGB_CMD_GREEN_VAL, green);
-    bus->i2c_smbus_write_byte_data(dev, CORSAIR_VENGEANCE_RGB_CMD_BLUE_VAL, blue);
+    unsigned char colors[3] = { red, green, blue };
+
+    /*-----------------------------------------------------*\
+    | Skip the update when the color is already shown       |
+    \*-----------------------------------------------------*/
+    if(register_cache->matches(dev, CORSAIR_VENGEANCE_RGB_CMD_FADE_TIME, 0x00)
+    && register_cache->matches(dev, CORSAIR_VENGEANCE_RGB_CMD_RED_VAL, colors, 3))
+    {
+        return;
+    }
+
+    s32 result = bus->i2c_smbus_write_byte_data(dev, CORSAIR_VENGEANCE_RGB_CMD_FADE_TIME, 0x00);
+
+    register_cache->update(dev, CORSAIR_VENGEANCE_RGB_CMD_FADE_TIME, 0x00, result);
+
+    result = bus->i2c_smbus_write_byte_data(dev, CORSAIR_VENGEANCE_RGB_CMD_RED_VAL, red);
+
+    if(bus->i2c_smbus_write_byte_data(dev, CORSAIR_VENGEANCE_RGB_CMD_GREEN_VAL, green) < 0
+    || bus->i2c_smbus_write_byte_data(dev, CORSAIR_VENGEANCE_RGB_CMD_BLUE_VAL, blue) < 0)
+    {
+        result = -1;
+    }
+
+    register_cache->update(dev, CORSAIR_VENGEANCE_RGB_CMD_RED_VAL, colors, 3, result);
+
     bus->i2c_smbus_write_byte_data(dev, CORSAIR_VENGEANCE_RGB_CMD_MODE, CORSAIR_VENGEANCE_RGB_MODE_SINGLE);
 }
 
@@ -13,6 +13,7 @@
 
 #include <string>
 #include "i2c_smbus.h"
+#include "i2c_smbus_register_cache.h"
 
 typedef unsigned char	corsair_dev_id;
 typedef unsigned char   corsair_cmd;
@@ -49,8 +50,9 @@ public:
     void            SetLEDColor(unsigned char red, unsigned char green, unsigned char blue);
 
 private:
-    char                    device_name[32];
-    unsigned int            led_count;
-    i2c_smbus_interface *   bus;
-    corsair_dev_id          dev;
+    char                        device_name[32];
+    unsigned int                led_count;
+    i2c_smbus_interface *       bus;
+    i2c_smbus_register_cache *  register_cache;
+    corsair_dev_id              dev;
 };
@@ -14,10 +14,13 @@
 
 using namespace std::chrono_literals;
 
-CorsairVengeanceProController::CorsairVengeanceProController(i2c_smbus_interface* bus, corsair_dev_id dev)
+CorsairVengeanceProController::CorsairVengeanceProController(i2c_smbus_interface* bus, corsair_dev_id dev, std::shared_ptr<i2c_smbus_group_updater> group_updater)
 {
-    this->bus = bus;
-    this->dev = dev;
+    this->bus           = bus;
+    this->dev           = dev;
+    this->group_updater = group_updater;
+
+    group_updater->add_member();
 
     strcpy(device_name, "Corsair Vengeance Pro RGB");
     led_count = CORSAIR_PRO_LED_COUNT;
@@ -35,7 +38,7 @@ CorsairVengeanceProController::CorsairVengeanceProController(i2c_smbus_interface
 
 CorsairVengeanceProController::~CorsairVengeanceProController()
 {
-
+    group_updater->remove_member();
 }
 
 std::string CorsairVengeanceProController::GetDeviceName()
@@ -82,6 +85,14 @@ void CorsairVengeanceProController::SetLEDColor(unsigned int led, unsigned char
 
 void CorsairVengeanceProController::ApplyColors()
 {
+    /*-----------------------------------------------------*\
+    | The update is sent through the group updater, which   |
+    | sends the same step of every module on the bus in one |
+    | batch and waits out the 1ms settle time once for all  |
+    | of them                                               |
+    \*-----------------------------------------------------*/
+    i2c_smbus_frame frame;
+
     if(direct_mode)
     {
         unsigned char   full_packet[32];
@@ -106,25 +117,34 @@ void CorsairVengeanceProController::ApplyColors()
 
         full_packet[31] = footer;
 
-        bus->i2c_smbus_write_block_data(dev, CORSAIR_PRO_DIRECT_COMMAND, 32, full_packet);
+        frame.resize(1);
+
+        i2c_smbus_group_updater::add_write_block_data(&frame[0], dev, CORSAIR_PRO_DIRECT_COMMAND, 32, full_packet);
+        frame[0].settle = 0us;
     }
     else
     {
-        bus->i2c_smbus_write_byte_data(dev, 0x26, 0x02);
-        std::this_thread::sleep_for(1ms);
-        bus->i2c_smbus_write_byte_data(dev, 0x21, 0x00);
-        std::this_thread::sleep_for(1ms);
+        frame.resize(3);
+
+        i2c_smbus_group_updater::add_write_byte_data(&frame[0], dev, 0x26, 0x02);
+        frame[0].settle = 1ms;
+
+        i2c_smbus_group_updater::add_write_byte_data(&frame[1], dev, 0x21, 0x00);
+        frame[1].settle = 1ms;
 
         for (int i = 0; i < 10; i++)
         {
-            bus->i2c_smbus_write_byte_data(dev, CORSAIR_PRO_REG_COMMAND, led_red[i]);
-            bus->i2c_smbus_write_byte_data(dev, CORSAIR_PRO_REG_COMMAND, led_green[i]);
-            bus->i2c_smbus_write_byte_data(dev, CORSAIR_PRO_REG_COMMAND, led_blue[i]);
-            bus->i2c_smbus_write_byte_data(dev, CORSAIR_PRO_REG_COMMAND, 0xFF);
+            i2c_smbus_group_updater::add_write_byte_data(&frame[2], dev, CORSAIR_PRO_REG_COMMAND, led_red[i]);
+            i2c_smbus_group_updater::add_write_byte_data(&frame[2], dev, CORSAIR_PRO_REG_COMMAND, led_green[i]);
+            i2c_smbus_group_updater::add_write_byte_data(&frame[2], dev, CORSAIR_PRO_REG_COMMAND, led_blue[i]);
+            i2c_smbus_group_updater::add_write_byte_data(&frame[2], dev, CORSAIR_PRO_REG_COMMAND, 0xFF);
         }
 
-        bus->i2c_smbus_write_byte_data(dev, 0x82, 0x02);
+        i2c_smbus_group_updater::add_write_byte_data(&frame[2], dev, 0x82, 0x02);
+        frame[2].settle = 0us;
     }
+
+    group_updater->update(dev, frame);
 }
 
 void CorsairVengeanceProController::SetEffect(unsigned char mode,
@@ -11,8 +11,10 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include "i2c_smbus.h"
+#include "i2c_smbus_group_updater.h"
 #include "CRC.h"
 
 typedef unsigned char	corsair_dev_id;
@@ -69,7 +71,7 @@ enum
 class CorsairVengeanceProController
 {
 public:
-    CorsairVengeanceProController(i2c_smbus_interface* bus, corsair_dev_id dev);
+    CorsairVengeanceProController(i2c_smbus_interface* bus, corsair_dev_id dev, std::shared_ptr<i2c_smbus_group_updater> group_updater);
     ~CorsairVengeanceProController();
 
     std::string     GetDeviceName();
@@ -106,4 +108,10 @@ private:
 
     i2c_smbus_interface*    bus;
     corsair_dev_id          dev;
+
+    /*-----------------------------------------*\
+    | Shared by the modules on the bus, sends   |
+    | their color updates in one batch          |
+    \*-----------------------------------------*/
+    std::shared_ptr<i2c_smbus_group_updater> group_updater;
 };
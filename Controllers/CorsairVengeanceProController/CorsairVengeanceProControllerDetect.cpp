@@ -9,6 +9,7 @@
 |   SPDX-License-Identifier: GPL-2.0-only                   |
 \*---------------------------------------------------------*/
 
+#include <memory>
 #include <vector>
 #include "Detector.h"
 #include "CorsairVengeanceProController.h"
@@ -81,15 +82,20 @@ void DetectCorsairVengeanceProControllers(std::vector<i2c_smbus_interface*> &bus
 {
     for(unsigned int bus = 0; bus < busses.size(); bus++)
     {
-        LOG_DEBUG("[%s] Testing bus %d", CORSAIR_VENGEANCE_RGB_PRO_NAME, bus);
+        LOG_DEBUG("[%s] Testing bus %d", CORSAIR_VENGEANCE_RGB_PRO_NAME, busses[bus]->bus_id);
 
         IF_DRAM_SMBUS(busses[bus]->pci_vendor, busses[bus]->pci_device)
         {
+            /*---------------------------------------------*\
+            | The modules on a bus update together          |
+            \*---------------------------------------------*/
+            std::shared_ptr<i2c_smbus_group_updater> group_updater = std::make_shared<i2c_smbus_group_updater>(busses[bus]);
+
             for(unsigned char addr = 0x58; addr <= 0x5F; addr++)
             {
                 if(TestForCorsairVengeanceProController(busses[bus], addr))
                 {
-                    CorsairVengeanceProController*     new_controller    = new CorsairVengeanceProController(busses[bus], addr);
+                    CorsairVengeanceProController*     new_controller    = new CorsairVengeanceProController(busses[bus], addr, group_updater);
                     RGBController_CorsairVengeancePro* new_rgbcontroller = new RGBController_CorsairVengeancePro(new_controller);
 
                     ResourceManager::get()->RegisterRGBController(new_rgbcontroller);
@@ -98,7 +104,7 @@ void DetectCorsairVengeanceProControllers(std::vector<i2c_smbus_interface*> &bus
         }
         else
         {
-            LOG_DEBUG("[%s] Bus %d is not a DRAM bus", CORSAIR_VENGEANCE_RGB_PRO_NAME, bus);
+            LOG_DEBUG("[%s] Bus %d is not a DRAM bus", CORSAIR_VENGEANCE_RGB_PRO_NAME, busses[bus]->bus_id);
         }
     }
 
@@ -284,4 +284,4 @@ void DetectE131Controllers()
 
 }   /* DetectE131Controllers() */
 
-REGISTER_DETECTOR("E1.31", DetectE131Controllers);
+REGISTER_NETWORK_DETECTOR("E1.31", DetectE131Controllers);
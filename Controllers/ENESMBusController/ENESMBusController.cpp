@@ -35,6 +35,12 @@ ENESMBusController::ENESMBusController(ENESMBusInterface* interface, ene_dev_id
     this->dev           = dev;
     supports_mode_14    = false;
 
+    /*-----------------------------------------------------*\
+    | Writing the apply register applies and saves changes, |
+    | it must be written even when the value is the same    |
+    \*-----------------------------------------------------*/
+    interface->ENERegisterSetVolatile(dev, ENE_REG_APPLY);
+
     if(interface->GetInterfaceType() != ENE_INTERFACE_TYPE_ROG_ARION)
     {
         UpdateDeviceName();
@@ -344,7 +350,6 @@ void ENESMBusController::SaveMode()
 void ENESMBusController::SetAllColorsDirect(RGBColor* colors)
 {
     unsigned char* color_buf   = new unsigned char[led_count * 3];
-    unsigned int   bytes_sent  = 0;
 
     for(unsigned int i = 0; i < (led_count * 3); i += 3)
     {
@@ -353,19 +358,7 @@ void ENESMBusController::SetAllColorsDirect(RGBColor* colors)
         color_buf[i + 2] = RGBGetGValue(colors[i / 3]);
     }
 
-    while(bytes_sent < (led_count * 3))
-    {
-        int bytes_to_send = (led_count * 3) - bytes_sent;
-
-        if(bytes_to_send > interface->GetMaxBlock())
-        {
-            bytes_to_send = interface->GetMaxBlock();
-        }
-
-        ENERegisterWriteBlock(direct_reg + bytes_sent, &color_buf[bytes_sent], bytes_to_send);
-
-        bytes_sent += bytes_to_send;
-    }
+    ENERegisterWriteBlocks(direct_reg, color_buf, led_count * 3);
 
     delete[] color_buf;
 }
@@ -373,7 +366,6 @@ void ENESMBusController::SetAllColorsDirect(RGBColor* colors)
 void ENESMBusController::SetAllColorsEffect(RGBColor* colors)
 {
     unsigned char* color_buf   = new unsigned char[led_count * 3];
-    unsigned int   bytes_sent  = 0;
 
     for(unsigned int i = 0; i < (led_count * 3); i += 3)
     {
@@ -382,19 +374,7 @@ void ENESMBusController::SetAllColorsEffect(RGBColor* colors)
         color_buf[i + 2] = RGBGetGValue(colors[i / 3]);
     }
 
-    while(bytes_sent < (led_count * 3))
-    {
-        int bytes_to_send = (led_count * 3) - bytes_sent;
-
-        if(bytes_to_send > interface->GetMaxBlock())
-        {
-            bytes_to_send = interface->GetMaxBlock();
-        }
-
-        ENERegisterWriteBlock(effect_reg + bytes_sent, &color_buf[bytes_sent], bytes_to_send);
-
-        bytes_sent += bytes_to_send;
-    }
+    ENERegisterWriteBlocks(effect_reg, color_buf, led_count * 3);
 
     ENERegisterWrite(ENE_REG_APPLY, ENE_APPLY_VAL);
 
@@ -459,3 +439,8 @@ void ENESMBusController::ENERegisterWriteBlock(ene_register reg, unsigned char *
 {
     interface->ENERegisterWriteBlock(dev, reg, data, sz);
 }
+
+void ENESMBusController::ENERegisterWriteBlocks(ene_register reg, unsigned char * data, unsigned int sz)
+{
+    interface->ENERegisterWriteBlocks(dev, reg, data, sz);
+}
@@ -127,6 +127,7 @@ public:
     unsigned char ENERegisterRead(ene_register reg);
     void          ENERegisterWrite(ene_register reg, unsigned char val);
     void          ENERegisterWriteBlock(ene_register reg, unsigned char * data, unsigned char sz);
+    void          ENERegisterWriteBlocks(ene_register reg, unsigned char * data, unsigned int sz);
 
 private:
     char                    device_name[16];
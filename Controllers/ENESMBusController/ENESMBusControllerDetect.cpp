@@ -7,6 +7,7 @@
 |   SPDX-License-Identifier: GPL-2.0-only                   |
 \*---------------------------------------------------------*/
 
+#include <memory>
 #include <vector>
 #include "Detector.h"
 #include "ENESMBusController.h"
@@ -240,12 +241,14 @@ void DetectENESMBusDRAMControllers(std::vector<i2c_smbus_interface*> &busses)
                 }
             }
 
-            // Add ENE controllers at their remapped addresses
+            // Add ENE controllers at their remapped addresses, the modules on a bus update together
+            std::shared_ptr<i2c_smbus_group_updater> group_updater = std::make_shared<i2c_smbus_group_updater>(busses[bus]);
+
             for (unsigned int address_list_idx = 0; address_list_idx < ENE_RAM_ADDRESS_COUNT; address_list_idx++)
             {
                 if (TestForENESMBusController(busses[bus], ene_ram_addresses[address_list_idx]))
                 {
-                    ENESMBusInterface_i2c_smbus* interface      = new ENESMBusInterface_i2c_smbus(busses[bus]);
+                    ENESMBusInterface_i2c_smbus* interface      = new ENESMBusInterface_i2c_smbus(busses[bus], group_updater);
                     ENESMBusController*          controller     = new ENESMBusController(interface, ene_ram_addresses[address_list_idx]);
                     RGBController_ENESMBus*      rgb_controller = new RGBController_ENESMBus(controller);
 
@@ -280,7 +283,7 @@ void DetectENESMBusMotherboardControllers(std::vector<i2c_smbus_interface*> &bus
             {
                 for (unsigned int address_list_idx = 0; address_list_idx < AURA_MOBO_ADDRESS_COUNT; address_list_idx++)
                 {
-                    LOG_DEBUG(SMBUS_CHECK_DEVICE_MESSAGE_EN, DETECTOR_NAME, bus, VENDOR_NAME, aura_mobo_addresses[address_list_idx]);
+                    LOG_DEBUG(SMBUS_CHECK_DEVICE_MESSAGE_EN, DETECTOR_NAME, busses[bus]->bus_id, VENDOR_NAME, aura_mobo_addresses[address_list_idx]);
 
                     if (TestForENESMBusController(busses[bus], aura_mobo_addresses[address_list_idx]))
                     {
@@ -300,7 +303,7 @@ void DetectENESMBusMotherboardControllers(std::vector<i2c_smbus_interface*> &bus
             }
             else
             {
-                LOG_DEBUG(SMBUS_CHECK_DEVICE_FAILURE_EN, DETECTOR_NAME, bus, VENDOR_NAME);
+                LOG_DEBUG(SMBUS_CHECK_DEVICE_FAILURE_EN, DETECTOR_NAME, busses[bus]->bus_id, VENDOR_NAME);
             }
         }
     }
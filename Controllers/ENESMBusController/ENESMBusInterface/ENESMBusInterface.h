@@ -38,4 +38,37 @@ public:
     virtual unsigned char       ENERegisterRead(ene_dev_id dev, ene_register reg) = 0;
     virtual void                ENERegisterWrite(ene_dev_id dev, ene_register reg, unsigned char val) = 0;
     virtual void                ENERegisterWriteBlock(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned char sz) = 0;
+
+    /*-----------------------------------------*\
+    | Registers that trigger an action and must |
+    | be written every time, for interfaces     |
+    | that skip writes of unchanged values      |
+    \*-----------------------------------------*/
+    virtual void                ENERegisterSetVolatile(ene_dev_id /*dev*/, ene_register /*reg*/)
+    {
+    }
+
+    /*-----------------------------------------*\
+    | Writes consecutive registers in blocks of |
+    | up to GetMaxBlock() bytes.  Interfaces    |
+    | that can queue transfers override this    |
+    \*-----------------------------------------*/
+    virtual void                ENERegisterWriteBlocks(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned int sz)
+    {
+        unsigned int bytes_sent = 0;
+
+        while(bytes_sent < sz)
+        {
+            unsigned int bytes_to_send = sz - bytes_sent;
+
+            if(bytes_to_send > (unsigned int)GetMaxBlock())
+            {
+                bytes_to_send = GetMaxBlock();
+            }
+
+            ENERegisterWriteBlock(dev, reg + bytes_sent, &data[bytes_sent], bytes_to_send);
+
+            bytes_sent += bytes_to_send;
+        }
+    }
 };
@@ -9,16 +9,41 @@
 |   SPDX-License-Identifier: GPL-2.0-only                   |
 \*---------------------------------------------------------*/
 
+#include <cstring>
+#include <vector>
 #include "ENESMBusInterface_i2c_smbus.h"
 
+/*---------------------------------------------------------*\
+| Block sizes of the ENE register block write.  Blocks of 3 |
+| bytes are sent when the adapter takes no longer blocks,   |
+| 24 is the largest block the other ENE interfaces use      |
+\*---------------------------------------------------------*/
+#define ENE_I2C_SMBUS_MIN_BLOCK         3
+#define ENE_I2C_SMBUS_MAX_BLOCK         24
+
 ENESMBusInterface_i2c_smbus::ENESMBusInterface_i2c_smbus(i2c_smbus_interface* bus)
 {
-    this->bus = bus;
+    this->bus       = bus;
+    register_cache  = new i2c_smbus_register_cache(bus);
+}
+
+ENESMBusInterface_i2c_smbus::ENESMBusInterface_i2c_smbus(i2c_smbus_interface* bus, std::shared_ptr<i2c_smbus_group_updater> group_updater)
+{
+    this->bus           = bus;
+    this->group_updater = group_updater;
+    register_cache      = new i2c_smbus_register_cache(bus);
+
+    group_updater->add_member();
 }
 
 ENESMBusInterface_i2c_smbus::~ENESMBusInterface_i2c_smbus()
 {
+    if(group_updater)
+    {
+        group_updater->remove_member();
+    }
 
+    delete register_cache;
 }
 
 ene_interface_type ENESMBusInterface_i2c_smbus::GetInterfaceType()
@@ -34,7 +59,19 @@ std::string ENESMBusInterface_i2c_smbus::GetLocation()
 
 int ENESMBusInterface_i2c_smbus::GetMaxBlock()
 {
-    return(3);
+    int max_block = bus->get_max_block_size();
+
+    if(max_block < ENE_I2C_SMBUS_MIN_BLOCK)
+    {
+        return(ENE_I2C_SMBUS_MIN_BLOCK);
+    }
+
+    if(max_block > ENE_I2C_SMBUS_MAX_BLOCK)
+    {
+        return(ENE_I2C_SMBUS_MAX_BLOCK);
+    }
+
+    return(max_block);
 }
 
 unsigned char ENESMBusInterface_i2c_smbus::ENERegisterRead(ene_dev_id dev, ene_register reg)
@@ -48,18 +85,126 @@ unsigned char ENESMBusInterface_i2c_smbus::ENERegisterRead(ene_dev_id dev, ene_r
 
 void ENESMBusInterface_i2c_smbus::ENERegisterWrite(ene_dev_id dev, ene_register reg, unsigned char val)
 {
+    //Skip values the register already holds
+    if(register_cache->matches(dev, reg, val))
+    {
+        return;
+    }
+
     //Write ENE register
-    bus->i2c_smbus_write_word_data(dev, 0x00, ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF));
+    s32 result = bus->i2c_smbus_write_word_data(dev, 0x00, ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF));
 
     //Write ENE value
-    bus->i2c_smbus_write_byte_data(dev, 0x01, val);
+    if(bus->i2c_smbus_write_byte_data(dev, 0x01, val) < 0)
+    {
+        result = -1;
+    }
+
+    register_cache->update(dev, reg, val, result);
 }
 
-void ENESMBusInterface_i2c_smbus::ENERegisterWriteBlock(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned char sz)
+/*---------------------------------------------------------*\
+| Fills the register select and block write transactions of |
+| one register block                                        |
+\*---------------------------------------------------------*/
+static void ENEBlockTransactions(i2c_smbus_transaction* transactions, ene_dev_id dev, ene_register reg, unsigned char * data, unsigned char sz)
 {
     //Write ENE register
-    bus->i2c_smbus_write_word_data(dev, 0x00, ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF));
+    transactions[0].addr            = dev;
+    transactions[0].read_write      = I2C_SMBUS_WRITE;
+    transactions[0].command         = 0x00;
+    transactions[0].size            = I2C_SMBUS_WORD_DATA;
+    transactions[0].data.word       = ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF);
 
     //Write ENE block data
-    bus->i2c_smbus_write_block_data(dev, 0x03, sz, data);
+    transactions[1].addr            = dev;
+    transactions[1].read_write      = I2C_SMBUS_WRITE;
+    transactions[1].command         = 0x03;
+    transactions[1].size            = I2C_SMBUS_BLOCK_DATA;
+    transactions[1].data.block[0]   = sz;
+
+    memcpy(&transactions[1].data.block[1], data, sz);
+}
+
+void ENESMBusInterface_i2c_smbus::ENERegisterWriteBlock(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned char sz)
+{
+    i2c_smbus_transaction transactions[2];
+
+    //Skip values the registers already hold
+    if(register_cache->matches(dev, reg, data, sz))
+    {
+        return;
+    }
+
+    ENEBlockTransactions(transactions, dev, reg, data, sz);
+
+    s32 result = bus->i2c_smbus_xfer_batch_call(transactions, 2);
+
+    register_cache->update(dev, reg, data, sz, result);
+}
+
+void ENESMBusInterface_i2c_smbus::ENERegisterWriteBlocks(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned int sz)
+{
+    //Queue the register select and block write of every block
+    std::vector<i2c_smbus_transaction> transactions;
+    std::vector<unsigned int>          block_offsets;
+    unsigned int                       bytes_sent = 0;
+
+    transactions.reserve(((sz + GetMaxBlock() - 1) / GetMaxBlock()) * 2);
+
+    while(bytes_sent < sz)
+    {
+        unsigned int bytes_to_send = sz - bytes_sent;
+
+        if(bytes_to_send > (unsigned int)GetMaxBlock())
+        {
+            bytes_to_send = GetMaxBlock();
+        }
+
+        //Skip blocks the registers already hold
+        if(!register_cache->matches(dev, reg + bytes_sent, &data[bytes_sent], bytes_to_send))
+        {
+            transactions.resize(transactions.size() + 2);
+            block_offsets.push_back(bytes_sent);
+
+            ENEBlockTransactions(&transactions[transactions.size() - 2], dev, reg + bytes_sent, &data[bytes_sent], bytes_to_send);
+        }
+
+        bytes_sent += bytes_to_send;
+    }
+
+    if(transactions.empty())
+    {
+        return;
+    }
+
+    s32 result;
+
+    //Send the blocks together with the updates of the other modules of the group
+    if(group_updater)
+    {
+        i2c_smbus_frame frame(1);
+
+        frame[0].transactions   = transactions;
+        frame[0].settle         = std::chrono::microseconds(0);
+
+        result = group_updater->update(dev, frame);
+    }
+    else
+    {
+        result = bus->i2c_smbus_xfer_batch_call(transactions.data(), (int)transactions.size());
+    }
+
+    //A failed batch does not tell which block failed, forget all of the blocks sent
+    for(std::size_t block_idx = 0; block_idx < block_offsets.size(); block_idx++)
+    {
+        unsigned int offset = block_offsets[block_idx];
+
+        register_cache->update(dev, reg + offset, &data[offset], transactions[block_idx * 2 + 1].data.block[0], result);
+    }
+}
+
+void ENESMBusInterface_i2c_smbus::ENERegisterSetVolatile(ene_dev_id dev, ene_register reg)
+{
+    register_cache->set_volatile(dev, reg);
 }
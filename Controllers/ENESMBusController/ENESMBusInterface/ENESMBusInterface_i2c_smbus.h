@@ -11,13 +11,17 @@
 
 #pragma once
 
+#include <memory>
 #include "ENESMBusInterface.h"
 #include "i2c_smbus.h"
+#include "i2c_smbus_group_updater.h"
+#include "i2c_smbus_register_cache.h"
 
 class ENESMBusInterface_i2c_smbus : public ENESMBusInterface
 {
 public:
     ENESMBusInterface_i2c_smbus(i2c_smbus_interface* bus);
+    ENESMBusInterface_i2c_smbus(i2c_smbus_interface* bus, std::shared_ptr<i2c_smbus_group_updater> group_updater);
     ~ENESMBusInterface_i2c_smbus();
 
     ene_interface_type  GetInterfaceType();
@@ -26,7 +30,16 @@ public:
     unsigned char       ENERegisterRead(ene_dev_id dev, ene_register reg);
     void                ENERegisterWrite(ene_dev_id dev, ene_register reg, unsigned char val);
     void                ENERegisterWriteBlock(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned char sz);
+    void                ENERegisterWriteBlocks(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned int sz);
+    void                ENERegisterSetVolatile(ene_dev_id dev, ene_register reg);
 
 private:
-    i2c_smbus_interface *   bus;
+    i2c_smbus_interface *       bus;
+    i2c_smbus_register_cache *  register_cache;
+
+    /*-----------------------------------------*\
+    | Shared by the DRAM modules on the bus,    |
+    | NULL for controllers that update alone    |
+    \*-----------------------------------------*/
+    std::shared_ptr<i2c_smbus_group_updater> group_updater;
 };
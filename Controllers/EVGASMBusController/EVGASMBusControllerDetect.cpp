@@ -66,7 +66,7 @@ void DetectAcx30SMBusControllers(std::vector<i2c_smbus_interface *> &busses)
         {
             if(busses[bus]->pci_subsystem_vendor == EVGA_SUB_VEN)
             {
-                LOG_DEBUG(SMBUS_CHECK_DEVICE_MESSAGE_EN, EVGA_DETECTOR_NAME, bus, VENDOR_NAME, SMBUS_ADDRESS);
+                LOG_DEBUG(SMBUS_CHECK_DEVICE_MESSAGE_EN, EVGA_DETECTOR_NAME, busses[bus]->bus_id, VENDOR_NAME, SMBUS_ADDRESS);
                 // Check for ACX 30 controller at 0x28
                 if(TestForAcx30SMBusController(busses[bus], SMBUS_ADDRESS))
                 {
@@ -78,7 +78,7 @@ void DetectAcx30SMBusControllers(std::vector<i2c_smbus_interface *> &busses)
             }
             else
             {
-                LOG_DEBUG(SMBUS_CHECK_DEVICE_FAILURE_EN, EVGA_DETECTOR_NAME, bus, VENDOR_NAME);
+                LOG_DEBUG(SMBUS_CHECK_DEVICE_FAILURE_EN, EVGA_DETECTOR_NAME, busses[bus]->bus_id, VENDOR_NAME);
             }
         }
     }
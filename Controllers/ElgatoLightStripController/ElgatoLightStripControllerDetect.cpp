@@ -47,4 +47,4 @@ void DetectElgatoLightStripControllers()
     }
 }
 
-REGISTER_DETECTOR("Elgato Light Strip", DetectElgatoLightStripControllers);
+REGISTER_NETWORK_DETECTOR("Elgato Light Strip", DetectElgatoLightStripControllers);
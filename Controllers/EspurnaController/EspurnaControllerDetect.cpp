@@ -77,4 +77,4 @@ void DetectEspurnaControllers()
 
 }   /* DetectEspurnaControllers() */
 
-REGISTER_DETECTOR("Espurna", DetectEspurnaControllers);
+REGISTER_NETWORK_DETECTOR("Espurna", DetectEspurnaControllers);
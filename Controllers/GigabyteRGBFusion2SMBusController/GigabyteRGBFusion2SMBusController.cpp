@@ -22,6 +22,8 @@ RGBFusion2SMBusController::RGBFusion2SMBusController(i2c_smbus_interface* bus, r
     this->dev   = dev;
     this->name  = mb_name;
 
+    register_cache = new i2c_smbus_register_cache(bus);
+
     memset(led_data, 0, 10*16);
 
     led_count   = 10;	// Protocol supports 10 'slots'
@@ -29,7 +31,7 @@ RGBFusion2SMBusController::RGBFusion2SMBusController(i2c_smbus_interface* bus, r
 
 RGBFusion2SMBusController::~RGBFusion2SMBusController()
 {
-
+    delete register_cache;
 }
 
 unsigned int RGBFusion2SMBusController::GetLEDCount()
@@ -69,7 +71,18 @@ void RGBFusion2SMBusController::WriteLED(int led)
         led -= 1;
     }
 
-    bus->i2c_smbus_write_block_data(RGB_FUSION_2_SMBUS_ADDR, (u8)write_register, 32, led_data[led]);
+    // The 32 bytes are one block command rather than separate registers, cache them as
+    // command << 8 so the blocks of neighbouring commands do not overlap
+    unsigned short cache_register = write_register << 8;
+
+    if(register_cache->matches(RGB_FUSION_2_SMBUS_ADDR, cache_register, led_data[led], 32))
+    {
+        return;
+    }
+
+    s32 result = bus->i2c_smbus_write_block_data(RGB_FUSION_2_SMBUS_ADDR, (u8)write_register, 32, led_data[led]);
+
+    register_cache->update(RGB_FUSION_2_SMBUS_ADDR, cache_register, led_data[led], 32, result);
 }
 
 void RGBFusion2SMBusController::Apply()
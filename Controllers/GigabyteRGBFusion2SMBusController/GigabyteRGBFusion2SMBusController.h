@@ -15,6 +15,7 @@
 
 #include <string>
 #include "i2c_smbus.h"
+#include "i2c_smbus_register_cache.h"
 
 typedef unsigned char	rgb_fusion_dev_id;
 
@@ -109,12 +110,13 @@ public:
                         );
 
 private:
-    unsigned int            led_count;
-    i2c_smbus_interface*    bus;
-    rgb_fusion_dev_id       dev;
-    std::string             name;
+    unsigned int                led_count;
+    i2c_smbus_interface*        bus;
+    i2c_smbus_register_cache*   register_cache;
+    rgb_fusion_dev_id           dev;
+    std::string                 name;
 
-    unsigned char           led_data[10][16];
+    unsigned char               led_data[10][16];
 
     void		    WriteLED(int);
 };
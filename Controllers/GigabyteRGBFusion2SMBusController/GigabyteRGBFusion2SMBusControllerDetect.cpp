@@ -140,7 +140,7 @@ void DetectGigabyteRGBFusion2SMBusControllers(std::vector<i2c_smbus_interface*>&
 
                     if(device_name.find("dmdc") == std::string::npos)
                     {
-                        LOG_DEBUG(SMBUS_CHECK_DEVICE_MESSAGE_EN, DETECTOR_NAME, bus, VENDOR_NAME, SMBUS_ADDRESS);
+                        LOG_DEBUG(SMBUS_CHECK_DEVICE_MESSAGE_EN, DETECTOR_NAME, busses[bus]->bus_id, VENDOR_NAME, SMBUS_ADDRESS);
 
                         // Check for RGB Fusion 2 controller at 0x68
                         if(TestForGigabyteRGBFusion2SMBusController(busses[bus], SMBUS_ADDRESS))
@@ -154,7 +154,7 @@ void DetectGigabyteRGBFusion2SMBusControllers(std::vector<i2c_smbus_interface*>&
                 }
                 else
                 {
-                    LOG_DEBUG(SMBUS_CHECK_DEVICE_FAILURE_EN, DETECTOR_NAME, bus, VENDOR_NAME);
+                    LOG_DEBUG(SMBUS_CHECK_DEVICE_FAILURE_EN, DETECTOR_NAME, busses[bus]->bus_id, VENDOR_NAME);
                 }
             }
         }
@@ -72,7 +72,7 @@ void DetectGigabyteRGBFusionControllers(std::vector<i2c_smbus_interface*>& busse
         {
             if(busses[bus]->pci_subsystem_vendor == GIGABYTE_SUB_VEN)
             {
-                LOG_DEBUG(SMBUS_CHECK_DEVICE_MESSAGE_EN, DETECTOR_NAME, bus, VENDOR_NAME, SMBUS_ADDRESS);
+                LOG_DEBUG(SMBUS_CHECK_DEVICE_MESSAGE_EN, DETECTOR_NAME, busses[bus]->bus_id, VENDOR_NAME, SMBUS_ADDRESS);
 
                 // Check for RGB Fusion controller at 0x28
                 if(TestForGigabyteRGBFusionController(busses[bus], SMBUS_ADDRESS))
@@ -85,7 +85,7 @@ void DetectGigabyteRGBFusionControllers(std::vector<i2c_smbus_interface*>& busse
             }
             else
             {
-                LOG_DEBUG(SMBUS_CHECK_DEVICE_FAILURE_EN, DETECTOR_NAME, bus, VENDOR_NAME);
+                LOG_DEBUG(SMBUS_CHECK_DEVICE_FAILURE_EN, DETECTOR_NAME, busses[bus]->bus_id, VENDOR_NAME);
             }
         }
     }
@@ -75,12 +75,12 @@ void DetectHyperXDRAMControllers(std::vector<i2c_smbus_interface*> &busses)
         bool          fury_detected = false;
         bool          pred_detected = false;
 
-        LOG_DEBUG("[%s] Checking VID/PID on bus %d...", HYPERX_CONTROLLER_NAME, bus);
+        LOG_DEBUG("[%s] Checking VID/PID on bus %d...", HYPERX_CONTROLLER_NAME, busses[bus]->bus_id);
 
         IF_DRAM_SMBUS(busses[bus]->pci_vendor, busses[bus]->pci_device)
         {
             // Check for HyperX controller at 0x27
-            LOG_DEBUG("[%s] Testing bus %d at address 0x27", HYPERX_CONTROLLER_NAME, bus);
+            LOG_DEBUG("[%s] Testing bus %d at address 0x27", HYPERX_CONTROLLER_NAME, busses[bus]->bus_id);
 
             if(TestForHyperXDRAMController(busses[bus], 0x27))
             {
@@ -57,4 +57,4 @@ void DetectKasaSmartControllers()
 
 }   /* DetectKasaSmartControllers() */
 
-REGISTER_DETECTOR("KasaSmart", DetectKasaSmartControllers);
+REGISTER_NETWORK_DETECTOR("KasaSmart", DetectKasaSmartControllers);
@@ -84,6 +84,11 @@ bool KingstonFuryDRAMController::SmbusRead(int slot_idx, unsigned char reg, unsi
                       FURY_CONTROLLER_NAME, device_addr, reg, *val, res);
             return true;
         }
+        else if(bus->is_degraded(device_addr))
+        {
+            // the bus retries a degraded module on its own, don't hold up the update
+            break;
+        }
         else
         {
             std::this_thread::sleep_for(3 * retries * FURY_DELAY);
@@ -107,6 +112,11 @@ bool KingstonFuryDRAMController::SmbusWrite(int slot_idx, unsigned char reg, uns
         {
             return true;
         }
+        else if(bus->is_degraded(device_addr))
+        {
+            // the bus retries a degraded module on its own, don't hold up the update
+            break;
+        }
         else
         {
             std::this_thread::sleep_for(3 * retries * FURY_DELAY);
@@ -53,4 +53,4 @@ void DetectLIFXControllers()
 
 }   /* DetectLIFXControllers() */
 
-REGISTER_DETECTOR("LIFX", DetectLIFXControllers);
+REGISTER_NETWORK_DETECTOR("LIFX", DetectLIFXControllers);
@@ -48,4 +48,4 @@ void DetectNanoleafControllers()
     }
 }   /* DetectNanoleafControllers() */
 
-REGISTER_DETECTOR("Nanoleaf", DetectNanoleafControllers);
+REGISTER_NETWORK_DETECTOR("Nanoleaf", DetectNanoleafControllers);
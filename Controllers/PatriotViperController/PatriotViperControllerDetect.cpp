@@ -66,7 +66,7 @@ void DetectPatriotViperControllers(std::vector<i2c_smbus_interface*> &busses)
         IF_DRAM_SMBUS(busses[bus]->pci_vendor, busses[bus]->pci_device)
         {
             // Check for Patriot Viper controller at 0x77
-            LOG_DEBUG("[%s] Testing bus %d at address 0x77", PATRIOT_CONTROLLER_NAME, bus);
+            LOG_DEBUG("[%s] Testing bus %d at address 0x77", PATRIOT_CONTROLLER_NAME, busses[bus]->bus_id);
 
             if(TestForPatriotViperController(busses[bus], 0x77))
             {
@@ -64,7 +64,7 @@ void DetectPatriotViperSteelControllers(std::vector<i2c_smbus_interface *> &buss
         IF_DRAM_SMBUS(busses[bus]->pci_vendor, busses[bus]->pci_device)
         {
             // Check for Patriot Viper Steel controller at 0x77
-            LOG_DEBUG("[%s] Testing bus %d at address 0x77", PATRIOT_CONTROLLER_NAME, bus);
+            LOG_DEBUG("[%s] Testing bus %d at address 0x77", PATRIOT_CONTROLLER_NAME, busses[bus]->bus_id);
 
             if(TestForPatriotViperSteelController(busses[bus], 0x77))
             {
@@ -252,7 +252,11 @@ RGBController_QMKOpenRGBRev9::RGBController_QMKOpenRGBRev9(QMKOpenRGBRev9Control
 
     active_mode = controller->GetMode() - 1;
 
-    SetupZones();
+    /*-----------------------------------------------------*\
+    | Reading the LED information takes a request per few   |
+    | LEDs, defer it so the keyboard is listed right away   |
+    \*-----------------------------------------------------*/
+    DeferInitialization();
 }
 
 RGBController_QMKOpenRGBRev9::~RGBController_QMKOpenRGBRev9()
@@ -266,6 +270,11 @@ RGBController_QMKOpenRGBRev9::~RGBController_QMKOpenRGBRev9()
     }
 }
 
+void RGBController_QMKOpenRGBRev9::DeviceInitialize()
+{
+    SetupZones();
+}
+
 void RGBController_QMKOpenRGBRev9::SetupZones()
 {
     /*---------------------------------------------------------*\
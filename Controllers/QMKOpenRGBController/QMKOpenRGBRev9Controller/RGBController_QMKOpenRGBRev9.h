@@ -30,6 +30,7 @@ public:
     RGBController_QMKOpenRGBRev9(QMKOpenRGBRev9Controller* controller_ptr);
     ~RGBController_QMKOpenRGBRev9();
 
+    void                                    DeviceInitialize();
     void                                    SetupZones();
     void                                    ResizeZone(int zone, int new_size);
 
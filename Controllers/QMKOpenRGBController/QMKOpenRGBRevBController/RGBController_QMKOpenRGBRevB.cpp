@@ -254,7 +254,11 @@ RGBController_QMKOpenRGBRevB::RGBController_QMKOpenRGBRevB(QMKOpenRGBRevBControl
         active_mode = controller->GetMode();
     }
 
-    SetupZones();
+    /*-----------------------------------------------------*\
+    | Reading the LED information takes a request per few   |
+    | LEDs, defer it so the keyboard is listed right away   |
+    \*-----------------------------------------------------*/
+    DeferInitialization();
 }
 
 RGBController_QMKOpenRGBRevB::~RGBController_QMKOpenRGBRevB()
@@ -268,6 +272,11 @@ RGBController_QMKOpenRGBRevB::~RGBController_QMKOpenRGBRevB()
     }
 }
 
+void RGBController_QMKOpenRGBRevB::DeviceInitialize()
+{
+    SetupZones();
+}
+
 void RGBController_QMKOpenRGBRevB::SetupZones()
 {
     /*---------------------------------------------------------*\
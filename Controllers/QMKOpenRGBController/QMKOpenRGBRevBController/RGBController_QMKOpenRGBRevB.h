@@ -30,6 +30,7 @@ public:
     RGBController_QMKOpenRGBRevB(QMKOpenRGBRevBController* controller_ptr, bool save);
     ~RGBController_QMKOpenRGBRevB();
 
+    void                                    DeviceInitialize();
     void                                    SetupZones();
     void                                    ResizeZone(int zone, int new_size);
 
@@ -253,7 +253,11 @@ RGBController_QMKOpenRGBRevD::RGBController_QMKOpenRGBRevD(QMKOpenRGBRevDControl
         active_mode = controller->GetMode();
     }
 
-    SetupZones();
+    /*-----------------------------------------------------*\
+    | Reading the LED information takes a request per few   |
+    | LEDs, defer it so the keyboard is listed right away   |
+    \*-----------------------------------------------------*/
+    DeferInitialization();
 }
 
 RGBController_QMKOpenRGBRevD::~RGBController_QMKOpenRGBRevD()
@@ -267,6 +271,11 @@ RGBController_QMKOpenRGBRevD::~RGBController_QMKOpenRGBRevD()
     }
 }
 
+void RGBController_QMKOpenRGBRevD::DeviceInitialize()
+{
+    SetupZones();
+}
+
 void RGBController_QMKOpenRGBRevD::SetupZones()
 {
     /*---------------------------------------------------------*\
@@ -29,6 +29,7 @@ public:
     RGBController_QMKOpenRGBRevD(QMKOpenRGBRevDController* controller_ptr, bool save);
     ~RGBController_QMKOpenRGBRevD();
 
+    void                                    DeviceInitialize();
     void                                    SetupZones();
     void                                    ResizeZone(int zone, int new_size);
 
@@ -269,7 +269,11 @@ RGBController_QMKOpenRGBRevE::RGBController_QMKOpenRGBRevE(QMKOpenRGBRevDControl
         active_mode = controller->GetMode();
     }
 
-    SetupZones();
+    /*-----------------------------------------------------*\
+    | Reading the LED information takes a request per few   |
+    | LEDs, defer it so the keyboard is listed right away   |
+    \*-----------------------------------------------------*/
+    DeferInitialization();
 }
 
 RGBController_QMKOpenRGBRevE::~RGBController_QMKOpenRGBRevE()
@@ -283,6 +287,11 @@ RGBController_QMKOpenRGBRevE::~RGBController_QMKOpenRGBRevE()
     }
 }
 
+void RGBController_QMKOpenRGBRevE::DeviceInitialize()
+{
+    SetupZones();
+}
+
 void RGBController_QMKOpenRGBRevE::SetupZones()
 {
     /*---------------------------------------------------------*\
@@ -30,6 +30,7 @@ public:
     RGBController_QMKOpenRGBRevE(QMKOpenRGBRevDController* controller_ptr, bool save);
     ~RGBController_QMKOpenRGBRevE();
 
+    void                                    DeviceInitialize();
     void                                    SetupZones();
     void                                    ResizeZone(int zone, int new_size);
 
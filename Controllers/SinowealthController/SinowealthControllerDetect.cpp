@@ -229,7 +229,7 @@ static bool DetectUsages(hid_device_info* info, std::string name, unsigned int d
     return true;
 }
 
-static void DetectGenesisXenon200(hid_device_info* info, const std::string name)
+static void DetectGenesisXenon200(hid_device_info* info, const std::string& name)
 {
     expected_reports reports{expected_report(0x04, 154), expected_report(0x08, 9)};
     if(!DetectUsages(info, name, 5, reports))
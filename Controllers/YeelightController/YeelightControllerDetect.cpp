@@ -65,4 +65,4 @@ void DetectYeelightControllers()
 
 }   /* DetectYeelightControllers() */
 
-REGISTER_DETECTOR("Yeelight", DetectYeelightControllers);
+REGISTER_NETWORK_DETECTOR("Yeelight", DetectYeelightControllers);
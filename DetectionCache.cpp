@@ -0,0 +1,230 @@
+/*---------------------------------------------------------*\
+| DetectionCache.cpp                                        |
+|                                                           |
+|   Fingerprint of the last complete device detection, used |
+|   to only run the detectors that found something before   |
+|   when the hardware has not changed                       |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <cstdio>
+#include <fstream>
+#include <hidapi.h>
+#include "DetectionCache.h"
+#include "LogManager.h"
+#include "SettingsManager.h"
+#include "StringUtils.h"
+
+/*---------------------------------------------------------*\
+| The cache is only valid for the build that wrote it, as   |
+| detector names and matching rules change between builds   |
+\*---------------------------------------------------------*/
+static const std::string detection_cache_build = std::string(VERSION_STRING) + " " + GIT_COMMIT_ID;
+
+static std::string BusFingerprint(i2c_smbus_interface* bus)
+{
+    char ids[32];
+
+    snprintf(ids, sizeof(ids), "%04X:%04X:%04X:%04X ", bus->pci_vendor, bus->pci_device, bus->pci_subsystem_vendor, bus->pci_subsystem_device);
+
+    return(std::string(ids) + bus->device_name);
+}
+
+DetectionCache::DetectionCache()
+{
+    build = detection_cache_build;
+}
+
+bool DetectionCache::Load(const filesystem::path& filename)
+{
+    json cache_data;
+
+    Clear();
+
+    if(!filesystem::exists(filename))
+    {
+        return(false);
+    }
+
+    std::ifstream cache_file(filename, std::ios::in | std::ios::binary);
+
+    if(!cache_file)
+    {
+        return(false);
+    }
+
+    try
+    {
+        cache_file >> cache_data;
+
+        if(cache_data["build"].get<std::string>() != detection_cache_build)
+        {
+            LOG_INFO("[DetectionCache] Cache was written by a different build, ignoring it");
+            return(false);
+        }
+
+        std::lock_guard<std::mutex> guard(mutex);
+
+        busses          = cache_data["busses"].get<std::vector<std::string>>();
+        spd_jedec_ids   = cache_data["spd"].get<std::vector<std::vector<uint16_t>>>();
+        claims          = cache_data["claims"].get<std::set<std::string>>();
+    }
+    catch(const std::exception& e)
+    {
+        LOG_ERROR("[DetectionCache] JSON parsing failed: %s", e.what());
+
+        Clear();
+        return(false);
+    }
+
+    LOG_INFO("[DetectionCache] Loaded %d busses and %d claims", (int)busses.size(), (int)claims.size());
+
+    return(true);
+}
+
+void DetectionCache::Save(const filesystem::path& filename)
+{
+    json cache_data;
+
+    mutex.lock();
+
+    cache_data["build"]     = build;
+    cache_data["busses"]    = busses;
+    cache_data["spd"]       = spd_jedec_ids;
+    cache_data["claims"]    = claims;
+
+    mutex.unlock();
+
+    std::ofstream cache_file(filename, std::ios::out | std::ios::binary);
+
+    if(cache_file)
+    {
+        try
+        {
+            cache_file << cache_data.dump(4);
+        }
+        catch(const std::exception& e)
+        {
+            LOG_ERROR("[DetectionCache] Cannot write to file: %s", e.what());
+        }
+
+        cache_file.close();
+    }
+}
+
+void DetectionCache::Clear()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    busses.clear();
+    spd_jedec_ids.clear();
+    claims.clear();
+}
+
+void DetectionCache::SetBusses(std::vector<i2c_smbus_interface*>& bus_list)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    busses.clear();
+
+    for(std::size_t bus_idx = 0; bus_idx < bus_list.size(); bus_idx++)
+    {
+        busses.push_back(BusFingerprint(bus_list[bus_idx]));
+    }
+
+    spd_jedec_ids.assign(bus_list.size(), std::vector<uint16_t>());
+}
+
+void DetectionCache::SetSPDJedecIDs(unsigned int bus, std::vector<uint16_t>& jedec_ids)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if(bus < spd_jedec_ids.size())
+    {
+        spd_jedec_ids[bus] = jedec_ids;
+    }
+}
+
+void DetectionCache::AddClaim(const std::string& claim)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    claims.insert(claim);
+}
+
+bool DetectionCache::MatchBusses(std::vector<i2c_smbus_interface*>& bus_list)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if(bus_list.size() != busses.size())
+    {
+        return(false);
+    }
+
+    for(std::size_t bus_idx = 0; bus_idx < bus_list.size(); bus_idx++)
+    {
+        if(BusFingerprint(bus_list[bus_idx]) != busses[bus_idx])
+        {
+            return(false);
+        }
+    }
+
+    return(true);
+}
+
+bool DetectionCache::MatchSPDJedecIDs(unsigned int bus, std::vector<uint16_t>& jedec_ids)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    return((bus < spd_jedec_ids.size()) && (spd_jedec_ids[bus] == jedec_ids));
+}
+
+bool DetectionCache::HasClaim(const std::string& claim)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    return(claims.count(claim) > 0);
+}
+
+std::string DetectionCache::BusClaim(const char* type, const std::string& detector, unsigned int bus)
+{
+    return(std::string(type) + "|" + detector + "|" + std::to_string(bus));
+}
+
+/*---------------------------------------------------------*\
+| The part of a HID claim that names the interface, its     |
+| IDs, path and serial number                               |
+\*---------------------------------------------------------*/
+static std::string HIDClaimInterface(hid_device_info* info)
+{
+    char        ids[32];
+    std::string serial;
+
+    snprintf(ids, sizeof(ids), "%04X:%04X", info->vendor_id, info->product_id);
+
+    if(info->serial_number != NULL)
+    {
+        serial = StringUtils::wstring_to_string(info->serial_number);
+    }
+
+    return(std::string(ids) + "|" + (info->path ? info->path : "") + "|" + serial);
+}
+
+std::string DetectionCache::HIDClaim(const std::string& detector, hid_device_info* info)
+{
+    return(std::string(DETECTION_CLAIM_HID) + "|" + detector + "|" + HIDClaimInterface(info));
+}
+
+bool DetectionCache::HIDClaimMatches(const std::string& claim, hid_device_info* info)
+{
+    std::string interface_key = "|" + HIDClaimInterface(info);
+
+    return((claim.size() > interface_key.size()) && (claim.compare(claim.size() - interface_key.size(), interface_key.size(), interface_key) == 0));
+}
+
+std::string DetectionCache::OtherClaim(const std::string& detector)
+{
+    return(std::string(DETECTION_CLAIM_OTHER) + "|" + detector);
+}
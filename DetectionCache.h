@@ -0,0 +1,69 @@
+/*---------------------------------------------------------*\
+| DetectionCache.h                                          |
+|                                                           |
+|   Fingerprint of the last complete device detection, used |
+|   to only run the detectors that found something before   |
+|   when the hardware has not changed                       |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include "i2c_smbus.h"
+#include "filesystem.h"
+
+struct hid_device_info;
+
+/*---------------------------------------------------------*\
+| Claim types, the kind of detector that found a device     |
+\*---------------------------------------------------------*/
+#define DETECTION_CLAIM_I2C         "i2c"
+#define DETECTION_CLAIM_I2C_DIMM    "dimm"
+#define DETECTION_CLAIM_I2C_PCI     "pci"
+#define DETECTION_CLAIM_HID         "hid"
+#define DETECTION_CLAIM_OTHER       "other"
+
+class DetectionCache
+{
+public:
+    DetectionCache();
+
+    bool Load(const filesystem::path& filename);
+    void Save(const filesystem::path& filename);
+    void Clear();
+
+    /*-----------------------------------------------------*\
+    | Fingerprint recording                                 |
+    \*-----------------------------------------------------*/
+    void SetBusses(std::vector<i2c_smbus_interface*>& busses);
+    void SetSPDJedecIDs(unsigned int bus, std::vector<uint16_t>& jedec_ids);
+    void AddClaim(const std::string& claim);
+
+    /*-----------------------------------------------------*\
+    | Fingerprint matching                                  |
+    \*-----------------------------------------------------*/
+    bool MatchBusses(std::vector<i2c_smbus_interface*>& busses);
+    bool MatchSPDJedecIDs(unsigned int bus, std::vector<uint16_t>& jedec_ids);
+    bool HasClaim(const std::string& claim);
+
+    /*-----------------------------------------------------*\
+    | Claim keys                                            |
+    \*-----------------------------------------------------*/
+    static std::string BusClaim(const char* type, const std::string& detector, unsigned int bus);
+    static std::string HIDClaim(const std::string& detector, hid_device_info* info);
+    static bool        HIDClaimMatches(const std::string& claim, hid_device_info* info);
+    static std::string OtherClaim(const std::string& detector);
+
+private:
+    std::mutex                          mutex;
+    std::string                         build;
+    std::vector<std::string>            busses;
+    std::vector<std::vector<uint16_t>>  spd_jedec_ids;
+    std::set<std::string>               claims;
+};
@@ -0,0 +1,201 @@
+/*---------------------------------------------------------*\
+| DetectionProfiler.cpp                                     |
+|                                                           |
+|   Per-detector timing and bus activity of a device        |
+|   detection, used to find slow or unneeded detectors      |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include "DetectionProfiler.h"
+#include "LogManager.h"
+#include "SettingsManager.h"
+
+static thread_local unsigned int found_count = 0;
+
+static bool CompareProfileEntries(const std::pair<std::string, DetectionProfileEntry>& a, const std::pair<std::string, DetectionProfileEntry>& b)
+{
+    return(a.second.wall_ns > b.second.wall_ns);
+}
+
+DetectionProfiler::DetectionProfiler()
+{
+    enabled = false;
+}
+
+void DetectionProfiler::Clear()
+{
+    mutex.lock();
+    entries.clear();
+    mutex.unlock();
+}
+
+void DetectionProfiler::SetEnabled(bool new_enabled)
+{
+    enabled = new_enabled;
+}
+
+bool DetectionProfiler::GetEnabled()
+{
+    return(enabled);
+}
+
+void DetectionProfiler::AddRun(const std::string& detector, const DetectionProfileEntry& run)
+{
+    mutex.lock();
+
+    std::map<std::string, DetectionProfileEntry>::iterator entry = entries.find(detector);
+
+    if(entry == entries.end())
+    {
+        entries[detector] = run;
+    }
+    else
+    {
+        entry->second.runs                 += run.runs;
+        entry->second.wall_ns              += run.wall_ns;
+        entry->second.blocked_ns           += run.blocked_ns;
+        entry->second.smbus_transactions   += run.smbus_transactions;
+        entry->second.hid_interfaces       += run.hid_interfaces;
+        entry->second.found                += run.found;
+    }
+
+    mutex.unlock();
+}
+
+std::vector<std::pair<std::string, DetectionProfileEntry>> DetectionProfiler::GetSortedEntries()
+{
+    mutex.lock();
+
+    std::vector<std::pair<std::string, DetectionProfileEntry>> sorted(entries.begin(), entries.end());
+
+    mutex.unlock();
+
+    std::stable_sort(sorted.begin(), sorted.end(), CompareProfileEntries);
+
+    return(sorted);
+}
+
+std::vector<std::string> DetectionProfiler::GetTable()
+{
+    std::vector<std::pair<std::string, DetectionProfileEntry>> sorted = GetSortedEntries();
+    std::vector<std::string>                                   table;
+    char                                                       line[160];
+    unsigned long long                                         total_ns = 0;
+
+    snprintf(line, sizeof(line), "%-40s %6s %10s %10s %8s %6s %6s", "Detector", "Runs", "Time (ms)", "Wait (ms)", "SMBus", "HID", "Found");
+    table.push_back(line);
+
+    for(std::size_t entry_idx = 0; entry_idx < sorted.size(); entry_idx++)
+    {
+        const DetectionProfileEntry& entry = sorted[entry_idx].second;
+
+        snprintf(line, sizeof(line), "%-40.40s %6u %10.2f %10.2f %8llu %6u %6u",
+                 sorted[entry_idx].first.c_str(),
+                 entry.runs,
+                 entry.wall_ns / 1000000.0,
+                 entry.blocked_ns / 1000000.0,
+                 entry.smbus_transactions,
+                 entry.hid_interfaces,
+                 entry.found);
+        table.push_back(line);
+
+        total_ns += entry.wall_ns;
+    }
+
+    snprintf(line, sizeof(line), "%d detectors, %.2f ms total detector time", (int)sorted.size(), total_ns / 1000000.0);
+    table.push_back(line);
+
+    return(table);
+}
+
+void DetectionProfiler::Save(const filesystem::path& filename)
+{
+    std::vector<std::pair<std::string, DetectionProfileEntry>> sorted = GetSortedEntries();
+    json                                                       profile_data;
+
+    profile_data["detectors"] = json::array();
+
+    for(std::size_t entry_idx = 0; entry_idx < sorted.size(); entry_idx++)
+    {
+        const DetectionProfileEntry& entry = sorted[entry_idx].second;
+        json                         detector_data;
+
+        detector_data["name"]               = sorted[entry_idx].first;
+        detector_data["runs"]               = entry.runs;
+        detector_data["wall_us"]            = entry.wall_ns / 1000;
+        detector_data["blocked_us"]         = entry.blocked_ns / 1000;
+        detector_data["smbus_transactions"] = entry.smbus_transactions;
+        detector_data["hid_interfaces"]     = entry.hid_interfaces;
+        detector_data["found"]              = entry.found;
+
+        profile_data["detectors"].push_back(detector_data);
+    }
+
+    std::ofstream profile_file(filename, std::ios::out | std::ios::binary);
+
+    if(profile_file)
+    {
+        try
+        {
+            profile_file << profile_data.dump(4);
+        }
+        catch(const std::exception& e)
+        {
+            LOG_ERROR("[DetectionProfiler] Cannot write to file: %s", e.what());
+        }
+
+        profile_file.close();
+    }
+}
+
+void DetectionProfiler::CountFound()
+{
+    found_count++;
+}
+
+unsigned int DetectionProfiler::GetFoundCount()
+{
+    return(found_count);
+}
+
+DetectionProfileScope::DetectionProfileScope(DetectionProfiler* profiler, const std::string& detector, bool hid_interface)
+{
+    this->profiler  = (profiler != NULL && profiler->GetEnabled()) ? profiler : NULL;
+
+    if(this->profiler == NULL)
+    {
+        return;
+    }
+
+    this->detector      = detector;
+    this->hid_interface = hid_interface;
+    start_stats         = i2c_smbus_interface::get_thread_stats();
+    start_found         = DetectionProfiler::GetFoundCount();
+    start               = std::chrono::steady_clock::now();
+}
+
+DetectionProfileScope::~DetectionProfileScope()
+{
+    if(profiler == NULL)
+    {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point end       = std::chrono::steady_clock::now();
+    i2c_smbus_thread_stats                end_stats = i2c_smbus_interface::get_thread_stats();
+    DetectionProfileEntry                 run;
+
+    run.runs                = 1;
+    run.wall_ns             = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    run.blocked_ns          = end_stats.blocked_ns   - start_stats.blocked_ns;
+    run.smbus_transactions  = end_stats.transactions - start_stats.transactions;
+    run.hid_interfaces      = hid_interface ? 1 : 0;
+    run.found               = DetectionProfiler::GetFoundCount() - start_found;
+
+    profiler->AddRun(detector, run);
+}
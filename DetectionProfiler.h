@@ -0,0 +1,84 @@
+/*---------------------------------------------------------*\
+| DetectionProfiler.h                                       |
+|                                                           |
+|   Per-detector timing and bus activity of a device        |
+|   detection, used to find slow or unneeded detectors      |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "i2c_smbus.h"
+#include "filesystem.h"
+
+/*---------------------------------------------------------*\
+| Totals of all runs of one detector                        |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    unsigned int                    runs;
+    unsigned long long              wall_ns;
+    unsigned long long              blocked_ns;
+    unsigned long long              smbus_transactions;
+    unsigned int                    hid_interfaces;
+    unsigned int                    found;
+} DetectionProfileEntry;
+
+class DetectionProfiler
+{
+public:
+    DetectionProfiler();
+
+    void Clear();
+    void SetEnabled(bool new_enabled);
+    bool GetEnabled();
+
+    void AddRun(const std::string& detector, const DetectionProfileEntry& run);
+
+    /*-----------------------------------------------------*\
+    | Output                                                |
+    \*-----------------------------------------------------*/
+    std::vector<std::string> GetTable();
+    void Save(const filesystem::path& filename);
+
+    /*-----------------------------------------------------*\
+    | Counts a controller registered by the calling thread  |
+    \*-----------------------------------------------------*/
+    static void CountFound();
+    static unsigned int GetFoundCount();
+
+private:
+    std::vector<std::pair<std::string, DetectionProfileEntry>> GetSortedEntries();
+
+    std::atomic<bool>                               enabled;
+    std::mutex                                      mutex;
+    std::map<std::string, DetectionProfileEntry>    entries;
+};
+
+/*---------------------------------------------------------*\
+| Profiles one detector run from construction until the     |
+| end of the enclosing scope.  Does nothing when profiling  |
+| is disabled                                               |
+\*---------------------------------------------------------*/
+class DetectionProfileScope
+{
+public:
+    DetectionProfileScope(DetectionProfiler* profiler, const std::string& detector, bool hid_interface);
+    ~DetectionProfileScope();
+
+private:
+    DetectionProfiler*                              profiler;
+    std::string                                     detector;
+    bool                                            hid_interface;
+    std::chrono::steady_clock::time_point           start;
+    i2c_smbus_thread_stats                          start_stats;
+    unsigned int                                    start_found;
+};
@@ -10,11 +10,333 @@
 #pragma once
 
 #include <functional>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "ResourceManager.h"
 
+/*---------------------------------------------------------*\
+| Detector descriptors, created by the static REGISTER_*    |
+| macros in Detector.h.  A descriptor only holds the name   |
+| literal, a plain function pointer and the match values.   |
+| Constructing one links it into a list without allocating  |
+| and without creating the ResourceManager, so the ~1000    |
+| detector registrations cost almost nothing before main(). |
+| The list is handed to the ResourceManager when detection  |
+| first needs it                                            |
+\*---------------------------------------------------------*/
+typedef bool (*I2CBusDetectorPointer)();
+typedef void (*DeviceDetectorPointer)();
+typedef void (*I2CDeviceDetectorPointer)(std::vector<i2c_smbus_interface*>&);
+typedef void (*I2CDIMMDeviceDetectorPointer)(i2c_smbus_interface*, std::vector<SPDWrapper*>&);
+typedef void (*I2CPCIDeviceDetectorPointer)(i2c_smbus_interface*, uint8_t, const std::string&);
+typedef void (*HIDDeviceDetectorPointer)(hid_device_info*, const std::string&);
+typedef void (*HIDWrappedDeviceDetectorPointer)(hidapi_wrapper, hid_device_info*, const std::string&);
+typedef void (*DynamicDetectorPointer)();
+typedef void (*PreDetectionHookPointer)();
+
+class DetectorDescriptor
+{
+public:
+    DetectorDescriptor()
+    {
+        std::lock_guard<std::mutex> list_lock(ListMutex());
+
+        next = nullptr;
+
+        if(list_tail == nullptr)
+        {
+            list_head = this;
+        }
+        else
+        {
+            list_tail->next = this;
+        }
+
+        list_tail = this;
+    }
+
+    virtual ~DetectorDescriptor() = default;
+
+    /*-----------------------------------------------------*\
+    | Registers all descriptors that were not registered    |
+    | yet, in the order they were constructed.  Function    |
+    | local descriptors constructed after the first call    |
+    | are picked up by the next call                        |
+    \*-----------------------------------------------------*/
+    static void RegisterAll(ResourceManager* resource_manager)
+    {
+        std::lock_guard<std::mutex> list_lock(ListMutex());
+
+        DetectorDescriptor* descriptor = (list_registered == nullptr) ? list_head : list_registered->next;
+
+        while(descriptor != nullptr)
+        {
+            descriptor->Register(resource_manager);
+
+            list_registered = descriptor;
+            descriptor      = descriptor->next;
+        }
+    }
+
+protected:
+    virtual void Register(ResourceManager* resource_manager) = 0;
+
+private:
+    /*-----------------------------------------------------*\
+    | The list pointers are constant initialized and the    |
+    | mutex is created on first use, so descriptors in any  |
+    | translation unit can be constructed in any order      |
+    \*-----------------------------------------------------*/
+    static std::mutex& ListMutex()
+    {
+        static std::mutex list_mutex;
+        return(list_mutex);
+    }
+
+    DetectorDescriptor*                 next;
+
+    static inline DetectorDescriptor*   list_head       = nullptr;
+    static inline DetectorDescriptor*   list_tail       = nullptr;
+    static inline DetectorDescriptor*   list_registered = nullptr;
+};
+
+class DeviceDetectorDescriptor : public DetectorDescriptor
+{
+public:
+    DeviceDetectorDescriptor(const char* name, DeviceDetectorPointer detector)
+    {
+        this->name      = name;
+        this->detector  = detector;
+    }
+
+protected:
+    void Register(ResourceManager* resource_manager) override
+    {
+        resource_manager->RegisterDeviceDetector(name, detector);
+    }
+
+private:
+    const char*                         name;
+    DeviceDetectorPointer               detector;
+};
+
+class NetworkDeviceDetectorDescriptor : public DetectorDescriptor
+{
+public:
+    NetworkDeviceDetectorDescriptor(const char* name, DeviceDetectorPointer detector)
+    {
+        this->name      = name;
+        this->detector  = detector;
+    }
+
+protected:
+    void Register(ResourceManager* resource_manager) override
+    {
+        resource_manager->RegisterNetworkDeviceDetector(name, detector);
+    }
+
+private:
+    const char*                         name;
+    DeviceDetectorPointer               detector;
+};
+
+class I2CDeviceDetectorDescriptor : public DetectorDescriptor
+{
+public:
+    I2CDeviceDetectorDescriptor(const char* name, I2CDeviceDetectorPointer detector)
+    {
+        this->name      = name;
+        this->detector  = detector;
+    }
+
+protected:
+    void Register(ResourceManager* resource_manager) override
+    {
+        resource_manager->RegisterI2CDeviceDetector(name, detector);
+    }
+
+private:
+    const char*                         name;
+    I2CDeviceDetectorPointer            detector;
+};
+
+class I2CDIMMDeviceDetectorDescriptor : public DetectorDescriptor
+{
+public:
+    I2CDIMMDeviceDetectorDescriptor(const char* name, I2CDIMMDeviceDetectorPointer detector, uint16_t jedec_id, uint8_t dimm_type)
+    {
+        this->name      = name;
+        this->detector  = detector;
+        this->jedec_id  = jedec_id;
+        this->dimm_type = dimm_type;
+    }
+
+protected:
+    void Register(ResourceManager* resource_manager) override
+    {
+        resource_manager->RegisterI2CDIMMDeviceDetector(name, detector, jedec_id, dimm_type);
+    }
+
+private:
+    const char*                         name;
+    I2CDIMMDeviceDetectorPointer        detector;
+    uint16_t                            jedec_id;
+    uint8_t                             dimm_type;
+};
+
+class I2CPCIDeviceDetectorDescriptor : public DetectorDescriptor
+{
+public:
+    I2CPCIDeviceDetectorDescriptor(const char* name, I2CPCIDeviceDetectorPointer detector, uint16_t ven_id, uint16_t dev_id, uint16_t subven_id, uint16_t subdev_id, uint8_t i2c_addr)
+    {
+        this->name      = name;
+        this->detector  = detector;
+        this->ven_id    = ven_id;
+        this->dev_id    = dev_id;
+        this->subven_id = subven_id;
+        this->subdev_id = subdev_id;
+        this->i2c_addr  = i2c_addr;
+    }
+
+protected:
+    void Register(ResourceManager* resource_manager) override
+    {
+        resource_manager->RegisterI2CPCIDeviceDetector(name, detector, ven_id, dev_id, subven_id, subdev_id, i2c_addr);
+    }
+
+private:
+    const char*                         name;
+    I2CPCIDeviceDetectorPointer         detector;
+    uint16_t                            ven_id;
+    uint16_t                            dev_id;
+    uint16_t                            subven_id;
+    uint16_t                            subdev_id;
+    uint8_t                             i2c_addr;
+};
+
+class I2CBusDetectorDescriptor : public DetectorDescriptor
+{
+public:
+    I2CBusDetectorDescriptor(I2CBusDetectorPointer detector)
+    {
+        this->detector  = detector;
+    }
+
+protected:
+    void Register(ResourceManager* resource_manager) override
+    {
+        resource_manager->RegisterI2CBusDetector(detector);
+    }
+
+private:
+    I2CBusDetectorPointer               detector;
+};
+
+class HIDDeviceDetectorDescriptor : public DetectorDescriptor
+{
+public:
+    HIDDeviceDetectorDescriptor(const char* name, HIDDeviceDetectorPointer detector, uint16_t vid, uint16_t pid, int interface, int usage_page, int usage)
+    {
+        this->name          = name;
+        this->detector      = detector;
+        this->vid           = vid;
+        this->pid           = pid;
+        this->interface     = interface;
+        this->usage_page    = usage_page;
+        this->usage         = usage;
+    }
+
+protected:
+    void Register(ResourceManager* resource_manager) override
+    {
+        resource_manager->RegisterHIDDeviceDetector(name, detector, vid, pid, interface, usage_page, usage);
+    }
+
+private:
+    const char*                         name;
+    HIDDeviceDetectorPointer            detector;
+    uint16_t                            vid;
+    uint16_t                            pid;
+    int                                 interface;
+    int                                 usage_page;
+    int                                 usage;
+};
+
+class HIDWrappedDeviceDetectorDescriptor : public DetectorDescriptor
+{
+public:
+    HIDWrappedDeviceDetectorDescriptor(const char* name, HIDWrappedDeviceDetectorPointer detector, uint16_t vid, uint16_t pid, int interface, int usage_page, int usage)
+    {
+        this->name          = name;
+        this->detector      = detector;
+        this->vid           = vid;
+        this->pid           = pid;
+        this->interface     = interface;
+        this->usage_page    = usage_page;
+        this->usage         = usage;
+    }
+
+protected:
+    void Register(ResourceManager* resource_manager) override
+    {
+        resource_manager->RegisterHIDWrappedDeviceDetector(name, detector, vid, pid, interface, usage_page, usage);
+    }
+
+private:
+    const char*                         name;
+    HIDWrappedDeviceDetectorPointer     detector;
+    uint16_t                            vid;
+    uint16_t                            pid;
+    int                                 interface;
+    int                                 usage_page;
+    int                                 usage;
+};
+
+class DynamicDetectorDescriptor : public DetectorDescriptor
+{
+public:
+    DynamicDetectorDescriptor(const char* name, DynamicDetectorPointer detector)
+    {
+        this->name      = name;
+        this->detector  = detector;
+    }
+
+protected:
+    void Register(ResourceManager* resource_manager) override
+    {
+        resource_manager->RegisterDynamicDetector(name, detector);
+    }
+
+private:
+    const char*                         name;
+    DynamicDetectorPointer              detector;
+};
+
+class PreDetectionHookDescriptor : public DetectorDescriptor
+{
+public:
+    PreDetectionHookDescriptor(PreDetectionHookPointer hook)
+    {
+        this->hook      = hook;
+    }
+
+protected:
+    void Register(ResourceManager* resource_manager) override
+    {
+        resource_manager->RegisterPreDetectionHook(hook);
+    }
+
+private:
+    PreDetectionHookPointer             hook;
+};
+
+/*---------------------------------------------------------*\
+| Runtime registration, used by the REGISTER_DYNAMIC_*      |
+| macros from within dynamic detectors                      |
+\*---------------------------------------------------------*/
+
 class DeviceDetector
 {
 public:
@@ -24,6 +346,15 @@ public:
 	}
 };
 
+class NetworkDeviceDetector
+{
+public:
+    NetworkDeviceDetector(std::string name, DeviceDetectorFunction detector)
+    {
+        ResourceManager::get()->RegisterNetworkDeviceDetector(name, detector);
+    }
+};
+
 class I2CDeviceDetector
 {
 public:
@@ -0,0 +1,382 @@
+/*---------------------------------------------------------*\
+| HotplugListener_Linux.cpp                                 |
+|                                                           |
+|   Device hotplug listener for Linux, receives udev events |
+|   over a netlink socket                                   |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include "HotplugListener_Linux.h"
+#include "LogManager.h"
+
+/*---------------------------------------------------------*\
+| udev re-broadcasts kernel uevents on netlink group 2 once |
+| its rules have run, so device permissions are already set |
+| when the event arrives                                    |
+\*---------------------------------------------------------*/
+#define UDEV_MONITOR_GROUP      2
+#define UDEV_MONITOR_MAGIC      0xFEEDCAFE
+#define UDEV_EVENT_BUFFER_SIZE  8192
+#define HOTPLUG_POLL_TIMEOUT_MS 500
+
+/*---------------------------------------------------------*\
+| The interfaces of a USB device appear one after another.  |
+| A device is reported once no node was added under it for  |
+| this long, so the detectors see all of its interfaces     |
+\*---------------------------------------------------------*/
+#define HOTPLUG_SETTLE_TIME_MS  500
+
+/*---------------------------------------------------------*\
+| Header udev puts in front of the event properties         |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    char            prefix[8];
+    unsigned int    magic;
+    unsigned int    header_size;
+    unsigned int    properties_off;
+    unsigned int    properties_len;
+    unsigned int    filter_subsystem_hash;
+    unsigned int    filter_devtype_hash;
+    unsigned int    filter_tag_bloom_hi;
+    unsigned int    filter_tag_bloom_lo;
+} udev_monitor_header;
+
+HotplugListener::HotplugListener(std::string subsystem, HotplugAddedCallback added_callback, HotplugCallback removed_callback)
+{
+    this->subsystem         = subsystem;
+    this->added_callback    = added_callback;
+    this->removed_callback  = removed_callback;
+
+    sock                    = -1;
+    running                 = false;
+    ListenThread            = nullptr;
+}
+
+HotplugListener::~HotplugListener()
+{
+    Stop();
+}
+
+bool HotplugListener::Start()
+{
+    if(running)
+    {
+        return(true);
+    }
+
+    sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+
+    if(sock < 0)
+    {
+        LOG_WARNING("[HotplugListener] Failed to open uevent socket: %s", strerror(errno));
+        return(false);
+    }
+
+    struct sockaddr_nl addr;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family  = AF_NETLINK;
+    addr.nl_groups  = UDEV_MONITOR_GROUP;
+
+    int pass_cred   = 1;
+
+    if(bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0
+    || setsockopt(sock, SOL_SOCKET, SO_PASSCRED, &pass_cred, sizeof(pass_cred)) < 0)
+    {
+        LOG_WARNING("[HotplugListener] Failed to bind uevent socket: %s", strerror(errno));
+        close(sock);
+        sock = -1;
+        return(false);
+    }
+
+    LOG_INFO("[HotplugListener] Listening for %s hotplug events", subsystem.c_str());
+
+    running         = true;
+    ListenThread    = new std::thread(&HotplugListener::ListenThreadFunction, this);
+
+    return(true);
+}
+
+void HotplugListener::Stop()
+{
+    running = false;
+
+    if(ListenThread)
+    {
+        ListenThread->join();
+        delete ListenThread;
+        ListenThread = nullptr;
+    }
+
+    if(sock >= 0)
+    {
+        close(sock);
+        sock = -1;
+    }
+}
+
+void HotplugListener::ListenThreadFunction()
+{
+    char buf[UDEV_EVENT_BUFFER_SIZE];
+    char cred_buf[CMSG_SPACE(sizeof(struct ucred))];
+
+    while(running)
+    {
+        AddSettledDevices();
+
+        struct pollfd fds;
+
+        fds.fd      = sock;
+        fds.events  = POLLIN;
+        fds.revents = 0;
+
+        /*-------------------------------------------------*\
+        | Wake up periodically to check the running flag    |
+        | and when a pending device has settled             |
+        \*-------------------------------------------------*/
+        if(poll(&fds, 1, GetPollTimeout()) <= 0)
+        {
+            continue;
+        }
+
+        struct sockaddr_nl  sender;
+        struct iovec        iov;
+        struct msghdr       msg;
+
+        iov.iov_base        = buf;
+        iov.iov_len         = sizeof(buf);
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name        = &sender;
+        msg.msg_namelen     = sizeof(sender);
+        msg.msg_iov         = &iov;
+        msg.msg_iovlen      = 1;
+        msg.msg_control     = cred_buf;
+        msg.msg_controllen  = sizeof(cred_buf);
+
+        ssize_t len = recvmsg(sock, &msg, 0);
+
+        if(len <= 0 || (msg.msg_flags & MSG_TRUNC))
+        {
+            continue;
+        }
+
+        /*-------------------------------------------------*\
+        | Only accept events sent by root from user space,  |
+        | that is, from udev                                |
+        \*-------------------------------------------------*/
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+
+        if(sender.nl_pid == 0 || cmsg == NULL || cmsg->cmsg_type != SCM_CREDENTIALS)
+        {
+            continue;
+        }
+
+        struct ucred* cred = (struct ucred*)CMSG_DATA(cmsg);
+
+        if(cred->uid != 0)
+        {
+            continue;
+        }
+
+        ProcessEvent(buf, (std::size_t)len);
+    }
+}
+
+void HotplugListener::ProcessEvent(const char* buf, std::size_t len)
+{
+    udev_monitor_header header;
+
+    if(len < sizeof(header))
+    {
+        return;
+    }
+
+    memcpy(&header, buf, sizeof(header));
+
+    if(strncmp(header.prefix, "libudev", sizeof(header.prefix)) != 0
+    || ntohl(header.magic) != UDEV_MONITOR_MAGIC
+    || header.properties_off < sizeof(header)
+    || header.properties_off > len
+    || header.properties_len > len - header.properties_off)
+    {
+        return;
+    }
+
+    /*-----------------------------------------------------*\
+    | Properties are NUL separated KEY=VALUE strings        |
+    \*-----------------------------------------------------*/
+    std::string action;
+    std::string event_subsystem;
+    std::string devname;
+    std::string devpath;
+
+    const char* properties      = buf + header.properties_off;
+    std::size_t properties_len  = header.properties_len;
+
+    for(std::size_t pos = 0; pos < properties_len;)
+    {
+        std::string property(properties + pos, strnlen(properties + pos, properties_len - pos));
+
+        pos += property.size() + 1;
+
+        if(property.compare(0, 7, "ACTION=") == 0)
+        {
+            action          = property.substr(7);
+        }
+        else if(property.compare(0, 10, "SUBSYSTEM=") == 0)
+        {
+            event_subsystem = property.substr(10);
+        }
+        else if(property.compare(0, 8, "DEVNAME=") == 0)
+        {
+            devname         = property.substr(8);
+        }
+        else if(property.compare(0, 8, "DEVPATH=") == 0)
+        {
+            devpath         = property.substr(8);
+        }
+    }
+
+    if(event_subsystem != subsystem || devname.empty())
+    {
+        return;
+    }
+
+    if(devname[0] != '/')
+    {
+        devname = "/dev/" + devname;
+    }
+
+    if(action == "add")
+    {
+        LOG_DEBUG("[HotplugListener] %s added", devname.c_str());
+
+        /*-------------------------------------------------*\
+        | Hold the node until its parent device has settled |
+        \*-------------------------------------------------*/
+        HotplugPendingDevice& pending = pending_devices[devpath.empty() ? devname : GetParentDevice(devpath)];
+
+        if(std::find(pending.devnames.begin(), pending.devnames.end(), devname) == pending.devnames.end())
+        {
+            pending.devnames.push_back(devname);
+        }
+
+        pending.settle_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(HOTPLUG_SETTLE_TIME_MS);
+    }
+    else if(action == "remove")
+    {
+        LOG_DEBUG("[HotplugListener] %s removed", devname.c_str());
+
+        /*-------------------------------------------------*\
+        | A node removed before its device settled is not   |
+        | reported as added                                 |
+        \*-------------------------------------------------*/
+        for(std::map<std::string, HotplugPendingDevice>::iterator it = pending_devices.begin(); it != pending_devices.end();)
+        {
+            std::vector<std::string>& devnames = it->second.devnames;
+
+            devnames.erase(std::remove(devnames.begin(), devnames.end(), devname), devnames.end());
+
+            if(devnames.empty())
+            {
+                it = pending_devices.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+
+        removed_callback(devname);
+    }
+}
+
+void HotplugListener::AddSettledDevices()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    for(std::map<std::string, HotplugPendingDevice>::iterator it = pending_devices.begin(); it != pending_devices.end();)
+    {
+        if(it->second.settle_time > now)
+        {
+            it++;
+            continue;
+        }
+
+        std::vector<std::string> devnames = it->second.devnames;
+
+        LOG_DEBUG("[HotplugListener] %s settled with %d nodes", it->first.c_str(), (int)devnames.size());
+
+        it = pending_devices.erase(it);
+
+        added_callback(devnames);
+    }
+}
+
+int HotplugListener::GetPollTimeout()
+{
+    std::chrono::steady_clock::time_point now     = std::chrono::steady_clock::now();
+    int                                   timeout = HOTPLUG_POLL_TIMEOUT_MS;
+
+    for(std::map<std::string, HotplugPendingDevice>::const_iterator it = pending_devices.begin(); it != pending_devices.end(); it++)
+    {
+        long long remaining_ms = std::chrono::duration_cast<std::chrono::milliseconds>(it->second.settle_time - now).count() + 1;
+
+        if(remaining_ms < timeout)
+        {
+            timeout = (remaining_ms > 0) ? (int)remaining_ms : 0;
+        }
+    }
+
+    return(timeout);
+}
+
+/*---------------------------------------------------------*\
+| Returns the sysfs path of the device a node belongs to.   |
+| A hidraw node sits below its HID device and, for USB, the |
+| interface, e.g.                                           |
+|   .../usb1/1-2/1-2:1.0/0003:046D:C52B.0001/hidraw/hidraw3 |
+| Both have a colon in their name, so stripping them leaves |
+| the USB device (1-2) that all of its interfaces share     |
+\*---------------------------------------------------------*/
+std::string HotplugListener::GetParentDevice(const std::string & devpath)
+{
+    std::string parent = devpath;
+
+    /*-----------------------------------------------------*\
+    | Strip the node and its class directory                |
+    \*-----------------------------------------------------*/
+    for(unsigned int level = 0; level < 2; level++)
+    {
+        std::size_t slash = parent.rfind('/');
+
+        if(slash == std::string::npos)
+        {
+            return(devpath);
+        }
+
+        parent.erase(slash);
+    }
+
+    std::size_t slash = parent.rfind('/');
+
+    while(slash != std::string::npos && parent.find(':', slash) != std::string::npos)
+    {
+        parent.erase(slash);
+        slash = parent.rfind('/');
+    }
+
+    return(parent.empty() ? devpath : parent);
+}
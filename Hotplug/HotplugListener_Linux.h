@@ -0,0 +1,70 @@
+/*---------------------------------------------------------*\
+| HotplugListener_Linux.h                                   |
+|                                                           |
+|   Device hotplug listener for Linux, receives udev events |
+|   over a netlink socket                                   |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*---------------------------------------------------------*\
+| Called with the device node (e.g. /dev/hidraw3) of a      |
+| device that was removed                                   |
+\*---------------------------------------------------------*/
+typedef std::function<void(const std::string&)> HotplugCallback;
+
+/*---------------------------------------------------------*\
+| Called with the device nodes of one parent device, such   |
+| as all hidraw nodes of a USB device, once its interfaces  |
+| have stopped appearing                                    |
+\*---------------------------------------------------------*/
+typedef std::function<void(const std::vector<std::string>&)> HotplugAddedCallback;
+
+/*---------------------------------------------------------*\
+| Device nodes added under one parent device, reported when |
+| no node was added for the settle time                     |
+\*---------------------------------------------------------*/
+struct HotplugPendingDevice
+{
+    std::chrono::steady_clock::time_point   settle_time;
+    std::vector<std::string>                devnames;
+};
+
+class HotplugListener
+{
+public:
+    HotplugListener(std::string subsystem, HotplugAddedCallback added_callback, HotplugCallback removed_callback);
+    ~HotplugListener();
+
+    bool Start();
+    void Stop();
+
+private:
+    void ListenThreadFunction();
+    void ProcessEvent(const char* buf, std::size_t len);
+    void AddSettledDevices();
+    int  GetPollTimeout();
+
+    static std::string GetParentDevice(const std::string & devpath);
+
+    std::string                                 subsystem;
+    HotplugAddedCallback                        added_callback;
+    HotplugCallback                             removed_callback;
+
+    int                                         sock;
+    std::atomic<bool>                           running;
+    std::thread*                                ListenThread;
+
+    std::map<std::string, HotplugPendingDevice> pending_devices;
+};
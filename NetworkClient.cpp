@@ -29,6 +29,12 @@
 
 using namespace std::chrono_literals;
 
+/*---------------------------------------------------------*\
+| Clients started together usually share one controller     |
+| list, serialize their updates to it                       |
+\*---------------------------------------------------------*/
+std::mutex NetworkClient::SharedControllerListMutex;
+
 NetworkClient::NetworkClient(std::vector<RGBController *>& control) : controllers(control)
 {
     port_ip                 = "127.0.0.1";
@@ -37,9 +43,14 @@ NetworkClient::NetworkClient(std::vector<RGBController *>& control) : controller
     server_connected        = false;
     server_controller_count = 0;
     change_in_progress      = false;
+    string_table_reset      = false;
 
     ListenThread            = NULL;
     ConnectionThread        = NULL;
+
+    ControllersAddCallback      = NULL;
+    ControllersRemoveCallback   = NULL;
+    ControllersCallbackArg      = NULL;
 }
 
 NetworkClient::~NetworkClient()
@@ -112,6 +123,13 @@ void NetworkClient::RegisterClientInfoChangeCallback(NetClientCallback new_callb
     ClientInfoChangeCallbackArgs.push_back(new_callback_arg);
 }
 
+void NetworkClient::SetControllersCallbacks(NetClientControllersCallback add_callback, NetClientControllersCallback remove_callback, void * callback_arg)
+{
+    ControllersAddCallback      = add_callback;
+    ControllersRemoveCallback   = remove_callback;
+    ControllersCallbackArg      = callback_arg;
+}
+
 void NetworkClient::SetIP(std::string new_ip)
 {
     if(server_connected == false)
@@ -365,10 +383,7 @@ void NetworkClient::ConnectionThreadFunction()
             | All controllers received, add them to master list         |
             \*---------------------------------------------------------*/
             printf("Client: All controllers received, adding them to master list\r\n");
-            for(std::size_t controller_idx = 0; controller_idx < server_controllers.size(); controller_idx++)
-            {
-                controllers.push_back(server_controllers[controller_idx]);
-            }
+            AddServerControllers();
 
             ControllerListMutex.unlock();
 
@@ -517,6 +532,10 @@ void NetworkClient::ListenThreadFunction()
             case NET_PACKET_ID_DEVICE_LIST_UPDATED:
                 ProcessRequest_DeviceListChanged();
                 break;
+
+            case NET_PACKET_ID_HEARTBEAT:
+                SendData_Heartbeat();
+                break;
         }
 
         delete[] data;
@@ -528,18 +547,7 @@ listen_done:
     server_connected = false;
 
     ControllerListMutex.lock();
-
-    for(size_t server_controller_idx = 0; server_controller_idx < server_controllers.size(); server_controller_idx++)
-    {
-        for(size_t controller_idx = 0; controller_idx < controllers.size(); controller_idx++)
-        {
-            if(controllers[controller_idx] == server_controllers[server_controller_idx])
-            {
-                controllers.erase(controllers.begin() + controller_idx);
-                break;
-            }
-        }
-    }
+    RemoveServerControllers();
 
     std::vector<RGBController *> server_controllers_copy = server_controllers;
 
@@ -572,6 +580,53 @@ void NetworkClient::WaitOnControllerData()
     return;
 }
 
+/*---------------------------------------------------------*\
+| Called with ControllerListMutex held.  Clients that share |
+| a plain controller list serialize on a shared mutex       |
+\*---------------------------------------------------------*/
+void NetworkClient::AddServerControllers()
+{
+    if(ControllersAddCallback != NULL)
+    {
+        ControllersAddCallback(ControllersCallbackArg, server_controllers);
+        return;
+    }
+
+    SharedControllerListMutex.lock();
+
+    for(std::size_t controller_idx = 0; controller_idx < server_controllers.size(); controller_idx++)
+    {
+        controllers.push_back(server_controllers[controller_idx]);
+    }
+
+    SharedControllerListMutex.unlock();
+}
+
+void NetworkClient::RemoveServerControllers()
+{
+    if(ControllersRemoveCallback != NULL)
+    {
+        ControllersRemoveCallback(ControllersCallbackArg, server_controllers);
+        return;
+    }
+
+    SharedControllerListMutex.lock();
+
+    for(size_t server_controller_idx = 0; server_controller_idx < server_controllers.size(); server_controller_idx++)
+    {
+        for(size_t controller_idx = 0; controller_idx < controllers.size(); controller_idx++)
+        {
+            if(controllers[controller_idx] == server_controllers[server_controller_idx])
+            {
+                controllers.erase(controllers.begin() + controller_idx);
+                break;
+            }
+        }
+    }
+
+    SharedControllerListMutex.unlock();
+}
+
 void NetworkClient::ProcessReply_ControllerCount(unsigned int data_size, char * data)
 {
     if(data_size == sizeof(unsigned int))
@@ -591,7 +646,23 @@ void NetworkClient::ProcessReply_ControllerData(unsigned int data_size, char * d
     {
         RGBController_Network * new_controller   = new RGBController_Network(this, dev_idx);
 
-        new_controller->ReadDeviceDescription((unsigned char *)data, GetProtocolVersion());
+        /*---------------------------------------------------------*\
+        | The string table is kept for the whole connection.  If a  |
+        | description cannot be read against it, ask the server to  |
+        | start a new table with the next one                       |
+        \*---------------------------------------------------------*/
+        if(GetProtocolVersion() >= OPENRGB_SDK_PROTOCOL_VERSION_COMPACT)
+        {
+            if(!new_controller->ReadDeviceDescriptionCompact((unsigned char *)data, &string_table))
+            {
+                printf("Client: Controller %d data is malformed, resetting string table\r\n", dev_idx);
+                string_table_reset = true;
+            }
+        }
+        else
+        {
+            new_controller->ReadDeviceDescription((unsigned char *)data, GetProtocolVersion());
+        }
 
         ControllerListMutex.lock();
 
@@ -635,18 +706,7 @@ void NetworkClient::ProcessRequest_DeviceListChanged()
     change_in_progress = true;
 
     ControllerListMutex.lock();
-
-    for(size_t server_controller_idx = 0; server_controller_idx < server_controllers.size(); server_controller_idx++)
-    {
-        for(size_t controller_idx = 0; controller_idx < controllers.size(); controller_idx++)
-        {
-            if(controllers[controller_idx] == server_controllers[server_controller_idx])
-            {
-                controllers.erase(controllers.begin() + controller_idx);
-                break;
-            }
-        }
-    }
+    RemoveServerControllers();
 
     std::vector<RGBController *> server_controllers_copy = server_controllers;
 
@@ -684,6 +744,17 @@ void NetworkClient::SendData_ClientString()
     send_in_progress.unlock();
 }
 
+void NetworkClient::SendData_Heartbeat()
+{
+    NetPacketHeader reply_hdr;
+
+    InitNetPacketHeader(&reply_hdr, 0, NET_PACKET_ID_HEARTBEAT, 0);
+
+    send_in_progress.lock();
+    send(client_sock, (char *)&reply_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
+    send_in_progress.unlock();
+}
+
 void NetworkClient::SendRequest_ControllerCount()
 {
     NetPacketHeader request_hdr;
@@ -732,9 +803,27 @@ void NetworkClient::SendRequest_ControllerData(unsigned int dev_idx)
             protocol_version = server_protocol_version;
         }
 
+        /*-------------------------------------------------------------*\
+        | Ask for a new string table if the last compact description    |
+        | could not be read                                             |
+        \*-------------------------------------------------------------*/
+        unsigned int flags = 0;
+
+        if(protocol_version >= OPENRGB_SDK_PROTOCOL_VERSION_COMPACT && string_table_reset.exchange(false))
+        {
+            flags                   = NET_CONTROLLER_DATA_FLAG_RESET_STRING_TABLE;
+            request_hdr.pkt_size    = 2 * sizeof(unsigned int);
+        }
+
         send_in_progress.lock();
         send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
         send(client_sock, (char *)&protocol_version, sizeof(unsigned int), MSG_NOSIGNAL);
+
+        if(flags != 0)
+        {
+            send(client_sock, (char *)&flags, sizeof(unsigned int), MSG_NOSIGNAL);
+        }
+
         send_in_progress.unlock();
     }
 }
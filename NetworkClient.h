@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
@@ -19,6 +20,7 @@
 #include "net_port.h"
 
 typedef void (*NetClientCallback)(void *);
+typedef void (*NetClientControllersCallback)(void *, std::vector<RGBController *> &);
 
 class NetworkClient
 {
@@ -37,6 +39,11 @@ public:
     void            ClearCallbacks();
     void            RegisterClientInfoChangeCallback(NetClientCallback new_callback, void * new_callback_arg);
 
+    //Adds and removes the server's controllers to and from the shared controller list
+    //through the owner of that list, so it can hold its own lock.  Must be set before
+    //the client is started
+    void            SetControllersCallbacks(NetClientControllersCallback add_callback, NetClientControllersCallback remove_callback, void * callback_arg);
+
     void            SetIP(std::string new_ip);
     void            SetName(std::string new_name);
     void            SetPort(unsigned short new_port);
@@ -56,6 +63,7 @@ public:
     void        ProcessRequest_DeviceListChanged();
 
     void        SendData_ClientString();
+    void        SendData_Heartbeat();
 
     void        SendRequest_ControllerCount();
     void        SendRequest_ControllerData(unsigned int dev_idx);
@@ -86,6 +94,7 @@ public:
 
 protected:
     std::vector<RGBController *>& controllers;
+    static std::mutex             SharedControllerListMutex;
 
 
 private:
@@ -105,6 +114,9 @@ private:
     bool            change_in_progress;
     std::mutex      send_in_progress;
 
+    RGBControllerStringTable    string_table;
+    std::atomic<bool>           string_table_reset;
+
     std::mutex      connection_mutex;
     std::condition_variable connection_cv;
 
@@ -115,5 +127,12 @@ private:
     std::vector<NetClientCallback>      ClientInfoChangeCallbacks;
     std::vector<void *>                 ClientInfoChangeCallbackArgs;
 
+    NetClientControllersCallback        ControllersAddCallback;
+    NetClientControllersCallback        ControllersRemoveCallback;
+    void *                              ControllersCallbackArg;
+
+    void            AddServerControllers();
+    void            RemoveServerControllers();
+
     int recv_select(SOCKET s, char *buf, int len, int flags);
 };
@@ -19,8 +19,24 @@
 |   2:      Add profile controls (Release 0.6)                          |
 |   3:      Add brightness field to modes (Release 0.7)                 |
 |   4:      Add segments field to zones, network plugins (Release 0.9)  |
+|   5:      Add heartbeat packet for dead client detection              |
+|   6:      Compact controller data with string table                   |
 \*---------------------------------------------------------------------*/
-#define OPENRGB_SDK_PROTOCOL_VERSION    4
+#define OPENRGB_SDK_PROTOCOL_VERSION    6
+
+/*---------------------------------------------------------------------*\
+| First protocol version using the compact controller data format       |
+\*---------------------------------------------------------------------*/
+#define OPENRGB_SDK_PROTOCOL_VERSION_COMPACT    6
+
+/*---------------------------------------------------------------------*\
+| Compact controller data requests carry these flags after the protocol |
+| version                                                               |
+\*---------------------------------------------------------------------*/
+enum
+{
+    NET_CONTROLLER_DATA_FLAG_RESET_STRING_TABLE = (1 << 0), /* Start a new string table with this reply             */
+};
 
 /*-----------------------------------------------------*\
 | Default Interface to bind to.                         |
@@ -59,6 +75,8 @@ enum
 
     NET_PACKET_ID_SET_CLIENT_NAME               = 50,   /* Send client name string to server                    */
 
+    NET_PACKET_ID_HEARTBEAT                     = 60,   /* Heartbeat probe from server, echoed by client        */
+
     NET_PACKET_ID_DEVICE_LIST_UPDATED           = 100,  /* Indicate to clients that device list has updated     */
 
     NET_PACKET_ID_REQUEST_PROFILE_LIST          = 150,  /* Request profile list                                 */
@@ -11,6 +11,7 @@
 
 #include <cstring>
 #include "NetworkServer.h"
+#include "RGBController_Network.h"
 #include "LogManager.h"
 
 #ifndef WIN32
@@ -30,6 +31,7 @@ const char yes = 1;
 
 #ifdef WIN32
 #include <Windows.h>
+#define MSG_NOSIGNAL 0
 #else
 #include <unistd.h>
 #endif
@@ -38,11 +40,15 @@ using namespace std::chrono_literals;
 
 NetworkClientInfo::NetworkClientInfo()
 {
-    client_string           = "Client";
-    client_ip               = OPENRGB_SDK_HOST;
-    client_sock             = INVALID_SOCKET;
-    client_listen_thread    = nullptr;
-    client_protocol_version = 0;
+    client_string               = "Client";
+    client_ip                   = OPENRGB_SDK_HOST;
+    client_sock                 = INVALID_SOCKET;
+    client_listen_thread        = nullptr;
+    client_protocol_version     = 0;
+    client_last_activity        = std::chrono::steady_clock::now();
+    client_heartbeat_pending    = false;
+    client_dead                 = false;
+    client_string_table_reset   = false;
 }
 
 NetworkClientInfo::~NetworkClientInfo()
@@ -58,10 +64,13 @@ NetworkClientInfo::~NetworkClientInfo()
 
 NetworkServer::NetworkServer(std::vector<RGBController *>& control) : controllers(control)
 {
-    host             = OPENRGB_SDK_HOST;
-    port_num         = OPENRGB_SDK_PORT;
-    server_online    = false;
-    server_listening = false;
+    host              = OPENRGB_SDK_HOST;
+    port_num          = OPENRGB_SDK_PORT;
+    server_online     = false;
+    server_listening  = false;
+    heartbeat_timeout = HEARTBEAT_TIMEOUT_SECONDS;
+    keepalive_time    = KEEPALIVE_TIME_SECONDS;
+    clients_reaped    = 0;
     for(int i = 0; i < MAXSOCK; i++)
     {
         ConnectionThread[i] = nullptr;
@@ -95,10 +104,40 @@ void NetworkServer::DeviceListChanged()
     | Indicate to the clients that the controller list has      |
     | changed                                                   |
     \*---------------------------------------------------------*/
+    ServerClientsMutex.lock();
+
     for(unsigned int client_idx = 0; client_idx < ServerClients.size(); client_idx++)
     {
-        SendRequest_DeviceListChanged(ServerClients[client_idx]->client_sock);
+        NetworkClientInfo * client_info = ServerClients[client_idx];
+
+        if(client_info->client_dead)
+        {
+            continue;
+        }
+
+        /*-----------------------------------------------------*\
+        | The client fetches every controller again, start a    |
+        | new string table with the next description so the     |
+        | table does not keep strings of removed controllers    |
+        \*-----------------------------------------------------*/
+        client_info->client_string_table_reset = true;
+
+        /*-----------------------------------------------------*\
+        | If the notification could not be sent, the client is  |
+        | gone.  Shut the socket down so that its listen thread |
+        | wakes up and reclaims it instead of letting later     |
+        | notifications block on it as well                     |
+        \*-----------------------------------------------------*/
+        if(!SendRequest_DeviceListChanged(client_info->client_sock))
+        {
+            LOG_WARNING("NetworkServer: Failed to notify client %s, dropping connection", client_info->client_ip.c_str());
+
+            client_info->client_dead = true;
+            shutdown(client_info->client_sock, SD_RECEIVE);
+        }
     }
+
+    ServerClientsMutex.unlock();
 }
 
 void NetworkServer::ServerListeningChanged()
@@ -181,6 +220,11 @@ const char * NetworkServer::GetClientIP(unsigned int client_num)
     return result;
 }
 
+unsigned int NetworkServer::GetNumClientsReaped()
+{
+    return clients_reaped;
+}
+
 unsigned int NetworkServer::GetClientProtocolVersion(unsigned int client_num)
 {
     unsigned int result;
@@ -229,6 +273,19 @@ void NetworkServer::SetPort(unsigned short new_port)
     }
 }
 
+void NetworkServer::SetHeartbeatTimeout(unsigned int new_timeout)
+{
+    heartbeat_timeout = new_timeout;
+}
+
+void NetworkServer::SetKeepaliveTime(unsigned int new_time)
+{
+    if(server_online == false)
+    {
+        keepalive_time = new_time;
+    }
+}
+
 void NetworkServer::StartServer()
 {
     int err;
@@ -430,7 +487,7 @@ void NetworkServer::ConnectionThreadFunction(int socket_idx)
         \*---------------------------------------------------------*/
         u_long arg = 0;
         ioctlsocket(client_info->client_sock, FIONBIO, &arg);
-        setsockopt(client_info->client_sock, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        SetClientSocketOptions(client_info->client_sock);
 
         /*---------------------------------------------------------*\
         | Discover the remote hosts IP                              |
@@ -510,14 +567,72 @@ int NetworkServer::accept_select(int sockfd)
     }
 }
 
-int NetworkServer::recv_select(SOCKET s, char *buf, int len, int flags)
+void NetworkServer::SetClientSocketOptions(SOCKET client_sock)
 {
+    int opt_yes = 1;
+
+    /*---------------------------------------------------------*\
+    | Set socket options - no delay                             |
+    \*---------------------------------------------------------*/
+    setsockopt(client_sock, IPPROTO_TCP, TCP_NODELAY, (const char *)&opt_yes, sizeof(opt_yes));
+
+    /*---------------------------------------------------------*\
+    | Bound blocking sends so that a client which stopped       |
+    | reading cannot stall the thread sending to it forever     |
+    \*---------------------------------------------------------*/
+#ifdef WIN32
+    DWORD send_timeout = TCP_TIMEOUT_SECONDS * 1000;
+#else
+    struct timeval send_timeout;
+    send_timeout.tv_sec  = TCP_TIMEOUT_SECONDS;
+    send_timeout.tv_usec = 0;
+#endif
+    setsockopt(client_sock, SOL_SOCKET, SO_SNDTIMEO, (const char *)&send_timeout, sizeof(send_timeout));
+
+    /*---------------------------------------------------------*\
+    | Set socket options - keepalive.  This catches peers that  |
+    | vanished without a FIN even if they do not support the    |
+    | heartbeat packet                                          |
+    \*---------------------------------------------------------*/
+    if(keepalive_time == 0)
+    {
+        return;
+    }
+
+    int keepalive_idle  = (int)keepalive_time;
+    int keepalive_intvl = 2;
+    int keepalive_cnt   = 3;
+
+    setsockopt(client_sock, SOL_SOCKET, SO_KEEPALIVE, (const char *)&opt_yes, sizeof(opt_yes));
+#ifdef TCP_KEEPIDLE
+    setsockopt(client_sock, IPPROTO_TCP, TCP_KEEPIDLE, (const char *)&keepalive_idle, sizeof(keepalive_idle));
+#elif defined(TCP_KEEPALIVE)
+    setsockopt(client_sock, IPPROTO_TCP, TCP_KEEPALIVE, (const char *)&keepalive_idle, sizeof(keepalive_idle));
+#endif
+#ifdef TCP_KEEPINTVL
+    setsockopt(client_sock, IPPROTO_TCP, TCP_KEEPINTVL, (const char *)&keepalive_intvl, sizeof(keepalive_intvl));
+#endif
+#ifdef TCP_KEEPCNT
+    setsockopt(client_sock, IPPROTO_TCP, TCP_KEEPCNT, (const char *)&keepalive_cnt, sizeof(keepalive_cnt));
+#endif
+#ifdef TCP_USER_TIMEOUT
+    /*---------------------------------------------------------*\
+    | Also drop the connection if sent data stays unacknowledged|
+    \*---------------------------------------------------------*/
+    unsigned int user_timeout = (keepalive_idle + (keepalive_intvl * keepalive_cnt)) * 1000;
+    setsockopt(client_sock, IPPROTO_TCP, TCP_USER_TIMEOUT, (const char *)&user_timeout, sizeof(user_timeout));
+#endif
+}
+
+int NetworkServer::recv_select(NetworkClientInfo * client_info, char *buf, int len, int flags)
+{
+    SOCKET              s = client_info->client_sock;
     fd_set              set;
     struct timeval      timeout;
 
     while(1)
     {
-        timeout.tv_sec          = TCP_TIMEOUT_SECONDS;
+        timeout.tv_sec          = HEARTBEAT_POLL_SECONDS;
         timeout.tv_usec         = 0;
 
         FD_ZERO(&set);
@@ -525,17 +640,64 @@ int NetworkServer::recv_select(SOCKET s, char *buf, int len, int flags)
 
         int rv = select((int)s + 1, &set, NULL, NULL, &timeout);
 
-        if(rv == SOCKET_ERROR || server_online == false)
+        if(rv == SOCKET_ERROR || server_online == false || client_info->client_dead)
         {
             return 0;
         }
         else if(rv == 0)
         {
-            continue;
+            /*-------------------------------------------------*\
+            | Heartbeat is only understood by protocol 5+       |
+            | clients, older clients rely on TCP keepalive      |
+            \*-------------------------------------------------*/
+            if(heartbeat_timeout == 0 || client_info->client_protocol_version < 5)
+            {
+                continue;
+            }
+
+            std::chrono::steady_clock::duration idle_time = std::chrono::steady_clock::now() - client_info->client_last_activity;
+
+            if(idle_time >= std::chrono::seconds(heartbeat_timeout))
+            {
+                LOG_WARNING("NetworkServer: Client %s did not respond to heartbeat within %u seconds", client_info->client_ip.c_str(), heartbeat_timeout);
+                client_info->client_dead = true;
+                return 0;
+            }
+
+            /*-------------------------------------------------*\
+            | Probe the client once it has been idle for a      |
+            | third of the timeout                              |
+            \*-------------------------------------------------*/
+            if(!client_info->client_heartbeat_pending && (idle_time >= std::chrono::seconds(heartbeat_timeout) / 3))
+            {
+                client_info->client_heartbeat_pending = true;
+
+                if(!SendRequest_Heartbeat(s))
+                {
+                    client_info->client_dead = true;
+                    return 0;
+                }
+            }
         }
         else
         {
-            return(recv(s, buf, len, flags));
+            int bytes_read = recv(s, buf, len, flags);
+
+            if(bytes_read > 0)
+            {
+                client_info->client_last_activity       = std::chrono::steady_clock::now();
+                client_info->client_heartbeat_pending   = false;
+            }
+            else if(bytes_read < 0)
+            {
+                /*---------------------------------------------*\
+                | Errors such as a keepalive timeout mean the   |
+                | peer is gone rather than closed cleanly       |
+                \*---------------------------------------------*/
+                client_info->client_dead = true;
+            }
+
+            return(bytes_read);
         }
     }
 }
@@ -560,7 +722,7 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
             /*---------------------------------------------------------*\
             | Read byte of magic                                        |
             \*---------------------------------------------------------*/
-            bytes_read = recv_select(client_sock, &header.pkt_magic[i], 1, 0);
+            bytes_read = recv_select(client_info, &header.pkt_magic[i], 1, 0);
 
             if(bytes_read <= 0)
             {
@@ -587,7 +749,7 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
         {
             int tmp_bytes_read = 0;
 
-            tmp_bytes_read = recv_select(client_sock, (char *)&header.pkt_dev_idx + bytes_read, sizeof(header) - sizeof(header.pkt_magic) - bytes_read, 0);
+            tmp_bytes_read = recv_select(client_info, (char *)&header.pkt_dev_idx + bytes_read, sizeof(header) - sizeof(header.pkt_magic) - bytes_read, 0);
 
             bytes_read += tmp_bytes_read;
 
@@ -611,7 +773,7 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
             {
                 int tmp_bytes_read = 0;
 
-                tmp_bytes_read = recv_select(client_sock, &data[(unsigned int)bytes_read], header.pkt_size - bytes_read, 0);
+                tmp_bytes_read = recv_select(client_info, &data[(unsigned int)bytes_read], header.pkt_size - bytes_read, 0);
 
                 if(tmp_bytes_read <= 0)
                 {
@@ -636,13 +798,30 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
             case NET_PACKET_ID_REQUEST_CONTROLLER_DATA:
                 {
                     unsigned int protocol_version = 0;
+                    unsigned int flags            = 0;
 
                     if(header.pkt_size == sizeof(unsigned int))
                     {
                         memcpy(&protocol_version, data, sizeof(unsigned int));
                     }
+                    else if(header.pkt_size == (2 * sizeof(unsigned int)))
+                    {
+                        memcpy(&protocol_version, data, sizeof(unsigned int));
+                        memcpy(&flags, data + sizeof(unsigned int), sizeof(unsigned int));
+                    }
 
-                    SendReply_ControllerData(client_sock, header.pkt_dev_idx, protocol_version);
+                    /*---------------------------------------------------------*\
+                    | The string table is shared by all descriptions sent on    |
+                    | this connection.  Start a new one if the device list      |
+                    | changed or the client lost track of it                    |
+                    \*---------------------------------------------------------*/
+                    if(client_info->client_string_table_reset.exchange(false)
+                    || (flags & NET_CONTROLLER_DATA_FLAG_RESET_STRING_TABLE))
+                    {
+                        client_info->client_string_table.Clear();
+                    }
+
+                    SendReply_ControllerData(client_sock, header.pkt_dev_idx, protocol_version, &client_info->client_string_table);
                 }
                 break;
 
@@ -651,6 +830,12 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
                 ProcessRequest_ClientProtocolVersion(client_sock, header.pkt_size, data);
                 break;
 
+            case NET_PACKET_ID_HEARTBEAT:
+                /*-------------------------------------------------*\
+                | Heartbeat reply, activity was already recorded    |
+                \*-------------------------------------------------*/
+                break;
+
             case NET_PACKET_ID_SET_CLIENT_NAME:
                 if(data == NULL)
                 {
@@ -700,8 +885,28 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
                 {
                     if(header.pkt_dev_idx < controllers.size())
                     {
-                        controllers[header.pkt_dev_idx]->SetColorDescription((unsigned char *)data);
-                        controllers[header.pkt_dev_idx]->UpdateLEDs();
+                        RGBController_Network * relay_controller = dynamic_cast<RGBController_Network *>(controllers[header.pkt_dev_idx]);
+
+                        /*---------------------------------------------------------*\
+                        | Devices from a downstream server (relay mode) get the     |
+                        | encoded frame forwarded as is under their downstream      |
+                        | index.  The size field is patched as the zero-size        |
+                        | workaround only applies to this client's connection.      |
+                        | The local copy is updated afterwards, off the forwarding  |
+                        | path                                                      |
+                        \*---------------------------------------------------------*/
+                        if(relay_controller != NULL)
+                        {
+                            memcpy(data, &header.pkt_size, sizeof(header.pkt_size));
+
+                            relay_controller->ForwardUpdateLEDs((unsigned char *)data, header.pkt_size);
+                            relay_controller->SetColorDescription((unsigned char *)data);
+                        }
+                        else
+                        {
+                            controllers[header.pkt_dev_idx]->SetColorDescription((unsigned char *)data);
+                            controllers[header.pkt_dev_idx]->UpdateLEDs();
+                        }
                     }
                 }
                 else
@@ -732,12 +937,23 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
                 {
                     if(header.pkt_dev_idx < controllers.size())
                     {
+                        RGBController_Network * relay_controller = dynamic_cast<RGBController_Network *>(controllers[header.pkt_dev_idx]);
                         int zone;
 
                         memcpy(&zone, &data[sizeof(unsigned int)], sizeof(int));
 
-                        controllers[header.pkt_dev_idx]->SetZoneColorDescription((unsigned char *)data);
-                        controllers[header.pkt_dev_idx]->UpdateZoneLEDs(zone);
+                        if(relay_controller != NULL)
+                        {
+                            memcpy(data, &header.pkt_size, sizeof(header.pkt_size));
+
+                            relay_controller->ForwardUpdateZoneLEDs((unsigned char *)data, header.pkt_size);
+                            relay_controller->SetZoneColorDescription((unsigned char *)data);
+                        }
+                        else
+                        {
+                            controllers[header.pkt_dev_idx]->SetZoneColorDescription((unsigned char *)data);
+                            controllers[header.pkt_dev_idx]->UpdateZoneLEDs(zone);
+                        }
                     }
                 }
                 else
@@ -761,12 +977,21 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
                 {
                     if(header.pkt_dev_idx < controllers.size())
                     {
+                        RGBController_Network * relay_controller = dynamic_cast<RGBController_Network *>(controllers[header.pkt_dev_idx]);
                         int led;
 
                         memcpy(&led, data, sizeof(int));
 
-                        controllers[header.pkt_dev_idx]->SetSingleLEDColorDescription((unsigned char *)data);
-                        controllers[header.pkt_dev_idx]->UpdateSingleLED(led);
+                        if(relay_controller != NULL)
+                        {
+                            relay_controller->ForwardUpdateSingleLED((unsigned char *)data, header.pkt_size);
+                            relay_controller->SetSingleLEDColorDescription((unsigned char *)data);
+                        }
+                        else
+                        {
+                            controllers[header.pkt_dev_idx]->SetSingleLEDColorDescription((unsigned char *)data);
+                            controllers[header.pkt_dev_idx]->UpdateSingleLED(led);
+                        }
                     }
                 }
                 else
@@ -927,6 +1152,12 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
 
 listen_done:
 
+    if(client_info->client_dead)
+    {
+        clients_reaped++;
+        LOG_INFO("NetworkServer: Reaped dead client %s (%u reaped since start)", client_info->client_ip.c_str(), (unsigned int)clients_reaped);
+    }
+
     ServerClientsMutex.lock();
 
     for(unsigned int this_idx = 0; this_idx < ServerClients.size(); this_idx++)
@@ -1012,14 +1243,23 @@ void NetworkServer::SendReply_ControllerCount(SOCKET client_sock)
     send(client_sock, (const char *)&reply_data, sizeof(unsigned int), 0);
 }
 
-void NetworkServer::SendReply_ControllerData(SOCKET client_sock, unsigned int dev_idx, unsigned int protocol_version)
+void NetworkServer::SendReply_ControllerData(SOCKET client_sock, unsigned int dev_idx, unsigned int protocol_version, RGBControllerStringTable* string_table)
 {
     if(dev_idx < controllers.size())
     {
         NetPacketHeader reply_hdr;
-        unsigned char *reply_data = controllers[dev_idx]->GetDeviceDescription(protocol_version);
+        unsigned char *reply_data;
         unsigned int   reply_size;
 
+        if(protocol_version >= OPENRGB_SDK_PROTOCOL_VERSION_COMPACT)
+        {
+            reply_data = controllers[dev_idx]->GetDeviceDescriptionCompact(string_table);
+        }
+        else
+        {
+            reply_data = controllers[dev_idx]->GetDeviceDescription(protocol_version);
+        }
+
         memcpy(&reply_size, reply_data, sizeof(reply_size));
 
         InitNetPacketHeader(&reply_hdr, dev_idx, NET_PACKET_ID_REQUEST_CONTROLLER_DATA, reply_size);
@@ -1044,13 +1284,22 @@ void NetworkServer::SendReply_ProtocolVersion(SOCKET client_sock)
     send(client_sock, (const char *)&reply_data, sizeof(unsigned int), 0);
 }
 
-void NetworkServer::SendRequest_DeviceListChanged(SOCKET client_sock)
+bool NetworkServer::SendRequest_DeviceListChanged(SOCKET client_sock)
 {
     NetPacketHeader pkt_hdr;
 
     InitNetPacketHeader(&pkt_hdr, 0, NET_PACKET_ID_DEVICE_LIST_UPDATED, 0);
 
-    send(client_sock, (char *)&pkt_hdr, sizeof(NetPacketHeader), 0);
+    return(send(client_sock, (char *)&pkt_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL) == sizeof(NetPacketHeader));
+}
+
+bool NetworkServer::SendRequest_Heartbeat(SOCKET client_sock)
+{
+    NetPacketHeader pkt_hdr;
+
+    InitNetPacketHeader(&pkt_hdr, 0, NET_PACKET_ID_HEARTBEAT, 0);
+
+    return(send(client_sock, (char *)&pkt_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL) == sizeof(NetPacketHeader));
 }
 
 void NetworkServer::SendReply_ProfileList(SOCKET client_sock)
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <thread>
 #include <chrono>
@@ -22,6 +23,19 @@
 #define MAXSOCK 32
 #define TCP_TIMEOUT_SECONDS 5
 
+/*---------------------------------------------------------*\
+| Dead client detection defaults                            |
+|   HEARTBEAT_TIMEOUT_SECONDS - Reap a client that has not  |
+|                               sent anything for this long |
+|                               (protocol 5+ clients only)  |
+|   KEEPALIVE_TIME_SECONDS    - Idle time before TCP        |
+|                               keepalive probing starts    |
+|   HEARTBEAT_POLL_SECONDS    - Listen thread poll interval |
+\*---------------------------------------------------------*/
+#define HEARTBEAT_TIMEOUT_SECONDS   15
+#define KEEPALIVE_TIME_SECONDS      10
+#define HEARTBEAT_POLL_SECONDS      1
+
 typedef void (*NetServerCallback)(void *);
 typedef unsigned char* (*NetPluginCallback)(void *, unsigned int, unsigned char*, unsigned int*);
 
@@ -46,6 +60,13 @@ public:
     std::string     client_string;
     unsigned int    client_protocol_version;
     std::string     client_ip;
+
+    std::chrono::steady_clock::time_point   client_last_activity;
+    bool                                    client_heartbeat_pending;
+    std::atomic<bool>                       client_dead;
+
+    RGBControllerStringTable                client_string_table;
+    std::atomic<bool>                       client_string_table_reset;
 };
 
 class NetworkServer
@@ -62,6 +83,7 @@ public:
     const char *                        GetClientString(unsigned int client_num);
     const char *                        GetClientIP(unsigned int client_num);
     unsigned int                        GetClientProtocolVersion(unsigned int client_num);
+    unsigned int                        GetNumClientsReaped();
 
     void                                ClientInfoChanged();
     void                                DeviceListChanged();
@@ -72,6 +94,8 @@ public:
 
     void                                SetHost(std::string host);
     void                                SetPort(unsigned short new_port);
+    void                                SetHeartbeatTimeout(unsigned int new_timeout);
+    void                                SetKeepaliveTime(unsigned int new_time);
 
     void                                StartServer();
     void                                StopServer();
@@ -83,10 +107,11 @@ public:
     void                                ProcessRequest_ClientString(SOCKET client_sock, unsigned int data_size, char * data);
 
     void                                SendReply_ControllerCount(SOCKET client_sock);
-    void                                SendReply_ControllerData(SOCKET client_sock, unsigned int dev_idx, unsigned int protocol_version);
+    void                                SendReply_ControllerData(SOCKET client_sock, unsigned int dev_idx, unsigned int protocol_version, RGBControllerStringTable* string_table);
     void                                SendReply_ProtocolVersion(SOCKET client_sock);
 
-    void                                SendRequest_DeviceListChanged(SOCKET client_sock);
+    bool                                SendRequest_DeviceListChanged(SOCKET client_sock);
+    bool                                SendRequest_Heartbeat(SOCKET client_sock);
     void                                SendReply_ProfileList(SOCKET client_sock);
     void                                SendReply_PluginList(SOCKET client_sock);
     void                                SendReply_PluginSpecific(SOCKET client_sock, unsigned int pkt_type, unsigned char* data, unsigned int data_size);
@@ -101,6 +126,9 @@ protected:
     unsigned short                      port_num;
     std::atomic<bool>                   server_online;
     std::atomic<bool>                   server_listening;
+    unsigned int                        heartbeat_timeout;
+    unsigned int                        keepalive_time;
+    std::atomic<unsigned int>           clients_reaped;
 
     std::vector<RGBController *>&       controllers;
 
@@ -129,5 +157,6 @@ private:
     SOCKET          server_sock[MAXSOCK];
 
     int             accept_select(int sockfd);
-    int             recv_select(SOCKET s, char *buf, int len, int flags);
+    int             recv_select(NetworkClientInfo * client_info, char *buf, int len, int flags);
+    void            SetClientSocketOptions(SOCKET client_sock);
 };
@@ -131,6 +131,8 @@ HEADERS +=
     Colors.h                                                                                    \
     dependencies/ColorWheel/ColorWheel.h                                                        \
     dependencies/json/json.hpp                                                                  \
+    DetectionCache.h                                                                            \
+    DetectionProfiler.h                                                                         \
     LogManager.h                                                                                \
     NetworkClient.h                                                                             \
     NetworkProtocol.h                                                                           \
@@ -139,6 +141,7 @@ HEADERS +=
     PluginManager.h                                                                             \
     ProfileManager.h                                                                            \
     ResourceManager.h                                                                           \
+    SPDCache.h                                                                                  \
     SettingsManager.h                                                                           \
     Detector.h                                                                                  \
     DeviceDetector.h                                                                            \
@@ -146,6 +149,11 @@ HEADERS +=
     filesystem.h                                                                                \
     hidapi_wrapper/hidapi_wrapper.h                                                             \
     i2c_smbus/i2c_smbus.h                                                                       \
+    i2c_smbus/i2c_smbus_group_updater.h                                                         \
+    i2c_smbus/i2c_smbus_register_cache.h                                                        \
+    i2c_smbus/i2c_smbus_replay.h                                                                \
+    i2c_smbus/i2c_smbus_simulated.h                                                             \
+    i2c_smbus/i2c_smbus_trace.h                                                                 \
     i2c_tools/i2c_tools.h                                                                       \
     interop/DeviceGuard.h                                                                       \
     interop/DeviceGuardLock.h                                                                   \
@@ -201,6 +209,8 @@ SOURCES +=
     main.cpp                                                                                    \
     cli.cpp                                                                                     \
     dmiinfo/dmiinfo.cpp                                                                         \
+    DetectionCache.cpp                                                                          \
+    DetectionProfiler.cpp                                                                       \
     LogManager.cpp                                                                              \
     NetworkClient.cpp                                                                           \
     NetworkProtocol.cpp                                                                         \
@@ -209,8 +219,16 @@ SOURCES +=
     ProfileManager.cpp                                                                          \
     ResourceManager.cpp                                                                         \
     SPDAccessor.cpp                                                                             \
+    SPDCache.cpp                                                                                \
     SettingsManager.cpp                                                                         \
     i2c_smbus/i2c_smbus.cpp                                                                     \
+    i2c_smbus/i2c_smbus_group_updater.cpp                                                       \
+    i2c_smbus/i2c_smbus_register_cache.cpp                                                      \
+    i2c_smbus/i2c_smbus_replay.cpp                                                              \
+    i2c_smbus/i2c_smbus_replay_detect.cpp                                                       \
+    i2c_smbus/i2c_smbus_simulated.cpp                                                           \
+    i2c_smbus/i2c_smbus_simulated_detect.cpp                                                    \
+    i2c_smbus/i2c_smbus_trace.cpp                                                               \
     i2c_tools/i2c_tools.cpp                                                                     \
     interop/DeviceGuard.cpp                                                                     \
     interop/DeviceGuardLock.cpp                                                                 \
@@ -504,10 +522,12 @@ contains(QMAKE_PLATFORM, linux) {
     dependencies/NVFC/nvapi.h                                                                   \
     i2c_smbus/i2c_smbus_linux.h                                                                 \
     AutoStart/AutoStart-Linux.h                                                                 \
+    Hotplug/HotplugListener_Linux.h                                                             \
     SuspendResume/SuspendResume_Linux_FreeBSD.h                                                 \
 
     INCLUDEPATH +=                                                                              \
     dependencies/NVFC                                                                           \
+    Hotplug                                                                                     \
     /usr/include/mbedtls2/                                                                      \
 
     LIBS +=                                                                                     \
@@ -558,6 +578,7 @@ contains(QMAKE_PLATFORM, linux) {
     scsiapi/scsiapi_linux.c                                                                     \
     serial_port/find_usb_serial_port_linux.cpp                                                  \
     AutoStart/AutoStart-Linux.cpp                                                               \
+    Hotplug/HotplugListener_Linux.cpp                                                           \
     SuspendResume/SuspendResume_Linux_FreeBSD.cpp                                               \
 
     #-------------------------------------------------------------------------------------------#
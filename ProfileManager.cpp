@@ -19,7 +19,14 @@
 #include "StringUtils.h"
 
 #define OPENRGB_PROFILE_HEADER  "OPENRGB_PROFILE"
-#define OPENRGB_PROFILE_VERSION OPENRGB_SDK_PROTOCOL_VERSION
+
+/*---------------------------------------------------------*\
+| Profiles stay at version 4, the last controller data      |
+| format change that applies to them.  Later protocol       |
+| versions only change the network session, so profiles     |
+| remain readable by older releases                         |
+\*---------------------------------------------------------*/
+#define OPENRGB_PROFILE_VERSION 4
 
 ProfileManager::ProfileManager(const filesystem::path& config_dir)
 {
@@ -39,6 +39,7 @@ mode::~mode()
 
 RGBController::RGBController()
 {
+    initialized         = true;
     DeviceThreadRunning = true;
     DeviceCallThread = new std::thread(&RGBController::DeviceCallThreadFunction, this);
 }
@@ -57,6 +58,8 @@ RGBController::~RGBController()
 
 unsigned char * RGBController::GetDeviceDescription(unsigned int protocol_version)
 {
+    std::lock_guard<std::mutex> initialize_lock(InitializeMutex);
+
     unsigned int data_ptr = 0;
     unsigned int data_size = 0;
 
@@ -983,6 +986,558 @@ void RGBController::ReadDeviceDescription(unsigned char* data_buf, unsigned int
     SetupColors();
 }
 
+/*---------------------------------------------------------*\
+| Compact device description                                |
+|                                                           |
+|   Used from protocol version 6 on.  Integers are encoded  |
+|   as LEB128 varints (zigzag for signed fields), strings   |
+|   as indices into an RGBControllerStringTable and         |
+|   matrix maps optionally run-length encoded.  Colors are  |
+|   kept as raw 4-byte values.  The 4-byte data size at the |
+|   start is unchanged so framing matches the full format.  |
+\*---------------------------------------------------------*/
+#define COMPACT_MATRIX_NONE         0
+#define COMPACT_MATRIX_VARINT       1
+#define COMPACT_MATRIX_RLE          2
+#define COMPACT_MATRIX_MAX_CELLS    0x10000
+
+unsigned int RGBControllerStringTable::Add(const std::string& str)
+{
+    unsigned int idx;
+
+    if(!Find(str, &idx))
+    {
+        idx = (unsigned int)strings.size();
+        strings.push_back(str);
+        string_idx[str] = idx;
+    }
+
+    return(idx);
+}
+
+bool RGBControllerStringTable::Find(const std::string& str, unsigned int* idx)
+{
+    std::unordered_map<std::string, unsigned int>::iterator it = string_idx.find(str);
+
+    if(it == string_idx.end())
+    {
+        return(false);
+    }
+
+    *idx = it->second;
+
+    return(true);
+}
+
+const std::string& RGBControllerStringTable::Get(unsigned int idx)
+{
+    static const std::string empty_string;
+
+    if(idx >= strings.size())
+    {
+        return(empty_string);
+    }
+
+    return(strings[idx]);
+}
+
+unsigned int RGBControllerStringTable::Size()
+{
+    return((unsigned int)strings.size());
+}
+
+void RGBControllerStringTable::Clear()
+{
+    strings.clear();
+    string_idx.clear();
+}
+
+static void CompactWriteVarint(std::vector<unsigned char>& buf, unsigned int value)
+{
+    while(value >= 0x80)
+    {
+        buf.push_back((unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+
+    buf.push_back((unsigned char)value);
+}
+
+static void CompactWriteSignedVarint(std::vector<unsigned char>& buf, int value)
+{
+    CompactWriteVarint(buf, ((unsigned int)value << 1) ^ (unsigned int)(value >> 31));
+}
+
+static void CompactWriteColors(std::vector<unsigned char>& buf, const std::vector<RGBColor>& colors)
+{
+    CompactWriteVarint(buf, (unsigned int)colors.size());
+
+    std::size_t buf_ptr = buf.size();
+
+    buf.resize(buf_ptr + (colors.size() * sizeof(RGBColor)));
+
+    if(!colors.empty())
+    {
+        memcpy(&buf[buf_ptr], colors.data(), colors.size() * sizeof(RGBColor));
+    }
+}
+
+static void CompactWriteString(std::vector<unsigned char>& buf, std::vector<const std::string *>& new_strings, RGBControllerStringTable* string_table, const std::string& str)
+{
+    unsigned int idx;
+
+    if(!string_table->Find(str, &idx))
+    {
+        idx = string_table->Add(str);
+        new_strings.push_back(&str);
+    }
+
+    CompactWriteVarint(buf, idx);
+}
+
+static void CompactWriteMatrix(std::vector<unsigned char>& buf, matrix_map_type* matrix_map)
+{
+    if(matrix_map == NULL)
+    {
+        buf.push_back(COMPACT_MATRIX_NONE);
+        return;
+    }
+
+    unsigned int                num_cells = matrix_map->height * matrix_map->width;
+    std::vector<unsigned char>  varint_cells;
+    std::vector<unsigned char>  rle_cells;
+
+    /*---------------------------------------------------------*\
+    | Varint format stores each cell as value + 1 so that the   |
+    | 0xFFFFFFFF "no LED" marker becomes a single 0 byte        |
+    \*---------------------------------------------------------*/
+    for(unsigned int cell_idx = 0; cell_idx < num_cells; cell_idx++)
+    {
+        CompactWriteVarint(varint_cells, matrix_map->map[cell_idx] + 1);
+    }
+
+    /*---------------------------------------------------------*\
+    | RLE format stores runs of empty cells as 0 followed by    |
+    | the run length, which suits sparse keyboard maps          |
+    \*---------------------------------------------------------*/
+    for(unsigned int cell_idx = 0; cell_idx < num_cells;)
+    {
+        if(matrix_map->map[cell_idx] == 0xFFFFFFFF)
+        {
+            unsigned int run_length = 0;
+
+            while((cell_idx < num_cells) && (matrix_map->map[cell_idx] == 0xFFFFFFFF))
+            {
+                run_length++;
+                cell_idx++;
+            }
+
+            CompactWriteVarint(rle_cells, 0);
+            CompactWriteVarint(rle_cells, run_length);
+        }
+        else
+        {
+            CompactWriteVarint(rle_cells, matrix_map->map[cell_idx] + 1);
+            cell_idx++;
+        }
+    }
+
+    std::vector<unsigned char>& cells = (rle_cells.size() < varint_cells.size()) ? rle_cells : varint_cells;
+
+    buf.push_back((rle_cells.size() < varint_cells.size()) ? COMPACT_MATRIX_RLE : COMPACT_MATRIX_VARINT);
+    CompactWriteVarint(buf, matrix_map->height);
+    CompactWriteVarint(buf, matrix_map->width);
+    buf.insert(buf.end(), cells.begin(), cells.end());
+}
+
+typedef struct
+{
+    unsigned char *         buf;
+    unsigned int            size;
+    unsigned int            ptr;
+    bool                    error;
+} compact_reader;
+
+static unsigned int CompactReadVarint(compact_reader* reader)
+{
+    unsigned int value = 0;
+
+    for(unsigned int shift = 0; shift < 35; shift += 7)
+    {
+        if(reader->ptr >= reader->size)
+        {
+            reader->error = true;
+            return(0);
+        }
+
+        unsigned char byte = reader->buf[reader->ptr++];
+
+        value |= (unsigned int)(byte & 0x7F) << shift;
+
+        if((byte & 0x80) == 0)
+        {
+            return(value);
+        }
+    }
+
+    reader->error = true;
+    return(0);
+}
+
+static int CompactReadSignedVarint(compact_reader* reader)
+{
+    unsigned int value = CompactReadVarint(reader);
+
+    return((int)(value >> 1) ^ -(int)(value & 1));
+}
+
+static void CompactReadColors(compact_reader* reader, std::vector<RGBColor>& colors)
+{
+    unsigned int num_colors = CompactReadVarint(reader);
+
+    if(reader->error || (num_colors > ((reader->size - reader->ptr) / sizeof(RGBColor))))
+    {
+        reader->error = true;
+        return;
+    }
+
+    colors.resize(num_colors);
+
+    if(num_colors > 0)
+    {
+        memcpy(colors.data(), &reader->buf[reader->ptr], num_colors * sizeof(RGBColor));
+        reader->ptr += num_colors * sizeof(RGBColor);
+    }
+}
+
+static std::string CompactReadString(compact_reader* reader, RGBControllerStringTable* string_table)
+{
+    unsigned int idx = CompactReadVarint(reader);
+
+    if(reader->error || idx >= string_table->Size())
+    {
+        reader->error = true;
+        return("");
+    }
+
+    return(string_table->Get(idx));
+}
+
+static matrix_map_type* CompactReadMatrix(compact_reader* reader)
+{
+    if(reader->ptr >= reader->size)
+    {
+        reader->error = true;
+        return(NULL);
+    }
+
+    unsigned char format = reader->buf[reader->ptr++];
+
+    if(format == COMPACT_MATRIX_NONE)
+    {
+        return(NULL);
+    }
+
+    unsigned int height = CompactReadVarint(reader);
+    unsigned int width  = CompactReadVarint(reader);
+
+    if(reader->error || (format > COMPACT_MATRIX_RLE) || (height == 0) || (width == 0) || (((unsigned long long)height * width) > COMPACT_MATRIX_MAX_CELLS))
+    {
+        reader->error = true;
+        return(NULL);
+    }
+
+    unsigned int      num_cells = height * width;
+    matrix_map_type * new_map   = new matrix_map_type;
+
+    new_map->height = height;
+    new_map->width  = width;
+    new_map->map    = new unsigned int[num_cells];
+
+    for(unsigned int cell_idx = 0; cell_idx < num_cells && !reader->error;)
+    {
+        unsigned int cell = CompactReadVarint(reader);
+
+        if((format == COMPACT_MATRIX_RLE) && (cell == 0))
+        {
+            unsigned int run_length = CompactReadVarint(reader);
+
+            if(run_length == 0 || run_length > (num_cells - cell_idx))
+            {
+                reader->error = true;
+                break;
+            }
+
+            for(; run_length > 0; run_length--)
+            {
+                new_map->map[cell_idx++] = 0xFFFFFFFF;
+            }
+        }
+        else
+        {
+            new_map->map[cell_idx++] = cell - 1;
+        }
+    }
+
+    return(new_map);
+}
+
+unsigned char * RGBController::GetDeviceDescriptionCompact(RGBControllerStringTable* string_table)
+{
+    std::lock_guard<std::mutex> initialize_lock(InitializeMutex);
+
+    std::vector<unsigned char>          body;
+    std::vector<const std::string *>    new_strings;
+    unsigned int                        string_base = string_table->Size();
+
+    /*---------------------------------------------------------*\
+    | Device information                                        |
+    \*---------------------------------------------------------*/
+    CompactWriteSignedVarint(body, type);
+    CompactWriteString(body, new_strings, string_table, name);
+    CompactWriteString(body, new_strings, string_table, vendor);
+    CompactWriteString(body, new_strings, string_table, description);
+    CompactWriteString(body, new_strings, string_table, version);
+    CompactWriteString(body, new_strings, string_table, serial);
+    CompactWriteString(body, new_strings, string_table, location);
+
+    /*---------------------------------------------------------*\
+    | Modes                                                     |
+    \*---------------------------------------------------------*/
+    CompactWriteVarint(body, (unsigned int)modes.size());
+    CompactWriteSignedVarint(body, active_mode);
+
+    for(std::size_t mode_index = 0; mode_index < modes.size(); mode_index++)
+    {
+        CompactWriteString(body, new_strings, string_table, modes[mode_index].name);
+        CompactWriteSignedVarint(body, modes[mode_index].value);
+        CompactWriteVarint(body, modes[mode_index].flags);
+        CompactWriteVarint(body, modes[mode_index].speed_min);
+        CompactWriteVarint(body, modes[mode_index].speed_max);
+        CompactWriteVarint(body, modes[mode_index].brightness_min);
+        CompactWriteVarint(body, modes[mode_index].brightness_max);
+        CompactWriteVarint(body, modes[mode_index].colors_min);
+        CompactWriteVarint(body, modes[mode_index].colors_max);
+        CompactWriteVarint(body, modes[mode_index].speed);
+        CompactWriteVarint(body, modes[mode_index].brightness);
+        CompactWriteVarint(body, modes[mode_index].direction);
+        CompactWriteVarint(body, modes[mode_index].color_mode);
+        CompactWriteColors(body, modes[mode_index].colors);
+    }
+
+    /*---------------------------------------------------------*\
+    | Zones                                                     |
+    \*---------------------------------------------------------*/
+    CompactWriteVarint(body, (unsigned int)zones.size());
+
+    for(std::size_t zone_index = 0; zone_index < zones.size(); zone_index++)
+    {
+        CompactWriteString(body, new_strings, string_table, zones[zone_index].name);
+        CompactWriteSignedVarint(body, zones[zone_index].type);
+        CompactWriteVarint(body, zones[zone_index].leds_min);
+        CompactWriteVarint(body, zones[zone_index].leds_max);
+        CompactWriteVarint(body, zones[zone_index].leds_count);
+        CompactWriteMatrix(body, zones[zone_index].matrix_map);
+
+        CompactWriteVarint(body, (unsigned int)zones[zone_index].segments.size());
+
+        for(std::size_t segment_index = 0; segment_index < zones[zone_index].segments.size(); segment_index++)
+        {
+            CompactWriteString(body, new_strings, string_table, zones[zone_index].segments[segment_index].name);
+            CompactWriteSignedVarint(body, zones[zone_index].segments[segment_index].type);
+            CompactWriteVarint(body, zones[zone_index].segments[segment_index].start_idx);
+            CompactWriteVarint(body, zones[zone_index].segments[segment_index].leds_count);
+        }
+    }
+
+    /*---------------------------------------------------------*\
+    | LEDs                                                      |
+    \*---------------------------------------------------------*/
+    CompactWriteVarint(body, (unsigned int)leds.size());
+
+    for(std::size_t led_index = 0; led_index < leds.size(); led_index++)
+    {
+        CompactWriteString(body, new_strings, string_table, leds[led_index].name);
+        CompactWriteVarint(body, leds[led_index].value);
+    }
+
+    /*---------------------------------------------------------*\
+    | Colors                                                    |
+    \*---------------------------------------------------------*/
+    CompactWriteColors(body, colors);
+
+    /*---------------------------------------------------------*\
+    | Prefix the table size before this description and the     |
+    | strings it added.  A base of 0 tells the reader to start  |
+    | a new table                                               |
+    \*---------------------------------------------------------*/
+    std::vector<unsigned char> header;
+
+    CompactWriteVarint(header, string_base);
+    CompactWriteVarint(header, (unsigned int)new_strings.size());
+
+    for(std::size_t string_index = 0; string_index < new_strings.size(); string_index++)
+    {
+        CompactWriteVarint(header, (unsigned int)new_strings[string_index]->size());
+        header.insert(header.end(), new_strings[string_index]->begin(), new_strings[string_index]->end());
+    }
+
+    /*---------------------------------------------------------*\
+    | Create data buffer                                        |
+    \*---------------------------------------------------------*/
+    unsigned int    data_size = (unsigned int)(sizeof(data_size) + header.size() + body.size());
+    unsigned char * data_buf  = new unsigned char[data_size];
+
+    memcpy(&data_buf[0], &data_size, sizeof(data_size));
+    memcpy(&data_buf[sizeof(data_size)], header.data(), header.size());
+    memcpy(&data_buf[sizeof(data_size) + header.size()], body.data(), body.size());
+
+    return(data_buf);
+}
+
+bool RGBController::ReadDeviceDescriptionCompact(unsigned char* data_buf, RGBControllerStringTable* string_table)
+{
+    compact_reader reader;
+
+    reader.buf      = data_buf;
+    reader.ptr      = sizeof(unsigned int);
+    reader.error    = false;
+
+    memcpy(&reader.size, data_buf, sizeof(reader.size));
+
+    /*---------------------------------------------------------*\
+    | A base of 0 starts a new table.  Any other base has to    |
+    | match the size of this side's table, otherwise a          |
+    | description was missed and the indices are out of step    |
+    \*---------------------------------------------------------*/
+    unsigned int string_base = CompactReadVarint(&reader);
+
+    if(string_base == 0)
+    {
+        string_table->Clear();
+    }
+    else if(reader.error || string_base != string_table->Size())
+    {
+        return(false);
+    }
+
+    /*---------------------------------------------------------*\
+    | Append the strings introduced by this description         |
+    \*---------------------------------------------------------*/
+    unsigned int num_new_strings = CompactReadVarint(&reader);
+
+    for(unsigned int string_index = 0; string_index < num_new_strings && !reader.error; string_index++)
+    {
+        unsigned int string_len = CompactReadVarint(&reader);
+
+        if(reader.error || string_len > (reader.size - reader.ptr))
+        {
+            reader.error = true;
+            break;
+        }
+
+        string_table->Add(std::string((char *)&reader.buf[reader.ptr], string_len));
+        reader.ptr += string_len;
+    }
+
+    /*---------------------------------------------------------*\
+    | Device information                                        |
+    \*---------------------------------------------------------*/
+    type        = CompactReadSignedVarint(&reader);
+    name        = CompactReadString(&reader, string_table);
+    vendor      = CompactReadString(&reader, string_table);
+    description = CompactReadString(&reader, string_table);
+    version     = CompactReadString(&reader, string_table);
+    serial      = CompactReadString(&reader, string_table);
+    location    = CompactReadString(&reader, string_table);
+
+    /*---------------------------------------------------------*\
+    | Modes                                                     |
+    \*---------------------------------------------------------*/
+    unsigned int num_modes = CompactReadVarint(&reader);
+
+    active_mode = CompactReadSignedVarint(&reader);
+
+    for(unsigned int mode_index = 0; mode_index < num_modes && !reader.error; mode_index++)
+    {
+        mode new_mode;
+
+        new_mode.name           = CompactReadString(&reader, string_table);
+        new_mode.value          = CompactReadSignedVarint(&reader);
+        new_mode.flags          = CompactReadVarint(&reader);
+        new_mode.speed_min      = CompactReadVarint(&reader);
+        new_mode.speed_max      = CompactReadVarint(&reader);
+        new_mode.brightness_min = CompactReadVarint(&reader);
+        new_mode.brightness_max = CompactReadVarint(&reader);
+        new_mode.colors_min     = CompactReadVarint(&reader);
+        new_mode.colors_max     = CompactReadVarint(&reader);
+        new_mode.speed          = CompactReadVarint(&reader);
+        new_mode.brightness     = CompactReadVarint(&reader);
+        new_mode.direction      = CompactReadVarint(&reader);
+        new_mode.color_mode     = CompactReadVarint(&reader);
+        CompactReadColors(&reader, new_mode.colors);
+
+        modes.push_back(new_mode);
+    }
+
+    /*---------------------------------------------------------*\
+    | Zones                                                     |
+    \*---------------------------------------------------------*/
+    unsigned int num_zones = CompactReadVarint(&reader);
+
+    for(unsigned int zone_index = 0; zone_index < num_zones && !reader.error; zone_index++)
+    {
+        zone new_zone;
+
+        new_zone.name           = CompactReadString(&reader, string_table);
+        new_zone.type           = CompactReadSignedVarint(&reader);
+        new_zone.leds_min       = CompactReadVarint(&reader);
+        new_zone.leds_max       = CompactReadVarint(&reader);
+        new_zone.leds_count     = CompactReadVarint(&reader);
+        new_zone.matrix_map     = CompactReadMatrix(&reader);
+
+        unsigned int num_segments = CompactReadVarint(&reader);
+
+        for(unsigned int segment_index = 0; segment_index < num_segments && !reader.error; segment_index++)
+        {
+            segment new_segment;
+
+            new_segment.name        = CompactReadString(&reader, string_table);
+            new_segment.type        = CompactReadSignedVarint(&reader);
+            new_segment.start_idx   = CompactReadVarint(&reader);
+            new_segment.leds_count  = CompactReadVarint(&reader);
+
+            new_zone.segments.push_back(new_segment);
+        }
+
+        zones.push_back(new_zone);
+    }
+
+    /*---------------------------------------------------------*\
+    | LEDs                                                      |
+    \*---------------------------------------------------------*/
+    unsigned int num_leds = CompactReadVarint(&reader);
+
+    for(unsigned int led_index = 0; led_index < num_leds && !reader.error; led_index++)
+    {
+        led new_led;
+
+        new_led.name    = CompactReadString(&reader, string_table);
+        new_led.value   = CompactReadVarint(&reader);
+
+        leds.push_back(new_led);
+    }
+
+    /*---------------------------------------------------------*\
+    | Colors                                                    |
+    \*---------------------------------------------------------*/
+    CompactReadColors(&reader, colors);
+
+    SetupColors();
+
+    return(!reader.error);
+}
+
 unsigned char * RGBController::GetModeDescription(int mode, unsigned int protocol_version)
 {
     unsigned int data_ptr = 0;
@@ -1711,6 +2266,41 @@ void RGBController::DeviceUpdateMode()
 
 }
 
+bool RGBController::GetInitialized()
+{
+    return(initialized.load());
+}
+
+bool RGBController::Initialize()
+{
+    /*---------------------------------------------------------*\
+    | Returns true only for the call that ran the deferred      |
+    | initialization                                            |
+    \*---------------------------------------------------------*/
+    std::lock_guard<std::mutex> initialize_lock(InitializeMutex);
+
+    if(initialized.load())
+    {
+        return(false);
+    }
+
+    DeviceInitialize();
+
+    initialized = true;
+
+    return(true);
+}
+
+void RGBController::DeferInitialization()
+{
+    initialized = false;
+}
+
+void RGBController::DeviceInitialize()
+{
+
+}
+
 void RGBController::DeviceCallThreadFunction()
 {
     CallFlag_UpdateLEDs = false;
@@ -1718,6 +2308,15 @@ void RGBController::DeviceCallThreadFunction()
 
     while(DeviceThreadRunning.load() == true)
     {
+        /*-----------------------------------------------------*\
+        | Finish a deferred initialization before the first     |
+        | update is sent to the device                          |
+        \*-----------------------------------------------------*/
+        if(!initialized.load() && (CallFlag_UpdateMode.load() || CallFlag_UpdateLEDs.load()))
+        {
+            Initialize();
+        }
+
         if(CallFlag_UpdateMode.load() == true)
         {
             DeviceUpdateMode();
@@ -18,6 +18,7 @@
 #include <thread>
 #include <chrono>
 #include <mutex>
+#include <unordered_map>
 
 /*------------------------------------------------------------------*\
 | RGB Color Type and Conversion Macros                               |
@@ -203,6 +204,31 @@ enum
 \*------------------------------------------------------------------*/
 typedef void (*RGBControllerCallback)(void *);
 
+/*------------------------------------------------------------------*\
+| String table for compact device descriptions                       |
+|   Strings are sent once and referenced by index afterwards, so     |
+|   repeated LED, zone and mode names are only sent once per SDK     |
+|   connection.  Both sides grow their table in the same order, new  |
+|   strings are carried inline in the description that first uses    |
+|   them along with the table size before them.  A size of 0 starts  |
+|   a new table, the server does so on a new connection, after the   |
+|   device list changes and when the client asks for it because its  |
+|   table is out of step.                                            |
+\*------------------------------------------------------------------*/
+class RGBControllerStringTable
+{
+public:
+    unsigned int            Add(const std::string& str);
+    bool                    Find(const std::string& str, unsigned int* idx);
+    const std::string&      Get(unsigned int idx);
+    unsigned int            Size();
+    void                    Clear();
+
+private:
+    std::vector<std::string>                        strings;
+    std::unordered_map<std::string, unsigned int>   string_idx;
+};
+
 std::string device_type_to_str(device_type type);
 
 class RGBControllerInterface
@@ -302,6 +328,9 @@ public:
     unsigned char *         GetDeviceDescription(unsigned int protocol_version);
     void                    ReadDeviceDescription(unsigned char* data_buf, unsigned int protocol_version);
 
+    unsigned char *         GetDeviceDescriptionCompact(RGBControllerStringTable* string_table);
+    bool                    ReadDeviceDescriptionCompact(unsigned char* data_buf, RGBControllerStringTable* string_table);
+
     unsigned char *         GetModeDescription(int mode, unsigned int protocol_version);
     void                    SetModeDescription(unsigned char* data_buf, unsigned int protocol_version);
 
@@ -328,6 +357,15 @@ public:
 
     void                    DeviceCallThreadFunction();
 
+    /*---------------------------------------------------------*\
+    | Deferred initialization.  Controllers that read a lot of  |
+    | information from the device may register with identity    |
+    | only and do the rest in DeviceInitialize, which runs once |
+    | in the background or before the first device update       |
+    \*---------------------------------------------------------*/
+    bool                    GetInitialized();
+    bool                    Initialize();
+
     /*---------------------------------------------------------*\
     | Functions to be implemented in device implementation      |
     \*---------------------------------------------------------*/
@@ -344,11 +382,17 @@ public:
 
     void                    SetCustomMode();
 
+protected:
+    void                    DeferInitialization();
+    virtual void            DeviceInitialize();
+
 private:
     std::thread*            DeviceCallThread;
     std::atomic<bool>       CallFlag_UpdateLEDs;
     std::atomic<bool>       CallFlag_UpdateMode;
     std::atomic<bool>       DeviceThreadRunning;
+    std::atomic<bool>       initialized;
+    std::mutex              InitializeMutex;
     //bool                    CallFlag_UpdateZoneLEDs                     = false;
     //bool                    CallFlag_UpdateSingleLED                    = false;
     //bool                    CallFlag_UpdateMode                         = false;
@@ -111,3 +111,18 @@ void RGBController_Network::UpdateLEDs()
 {
     DeviceUpdateLEDs();
 }
+
+void RGBController_Network::ForwardUpdateLEDs(unsigned char * data, unsigned int size)
+{
+    client->SendRequest_RGBController_UpdateLEDs(dev_idx, data, size);
+}
+
+void RGBController_Network::ForwardUpdateZoneLEDs(unsigned char * data, unsigned int size)
+{
+    client->SendRequest_RGBController_UpdateZoneLEDs(dev_idx, data, size);
+}
+
+void RGBController_Network::ForwardUpdateSingleLED(unsigned char * data, unsigned int size)
+{
+    client->SendRequest_RGBController_UpdateSingleLED(dev_idx, data, size);
+}
@@ -34,6 +34,14 @@ public:
 
     void        UpdateLEDs();
 
+    /*---------------------------------------------------------*\
+    | Relay pass-through.  Forward an already encoded color     |
+    | description to the downstream server unchanged            |
+    \*---------------------------------------------------------*/
+    void        ForwardUpdateLEDs(unsigned char * data, unsigned int size);
+    void        ForwardUpdateZoneLEDs(unsigned char * data, unsigned int size);
+    void        ForwardUpdateSingleLED(unsigned char * data, unsigned int size);
+
 private:
     NetworkClient *     client;
     unsigned int        dev_idx;
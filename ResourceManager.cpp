@@ -12,16 +12,28 @@
 \*---------------------------------------------------------*/
 
 #ifdef _WIN32
+#include <algorithm>
 #include <codecvt>
 #include <locale>
 #endif
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <map>
+#include <set>
 #include <string>
 #include <hidapi.h>
 #include "cli.h"
 #include "pci_ids/pci_ids.h"
 #include "ResourceManager.h"
+#include "DetectionCache.h"
+#include "DetectionProfiler.h"
+#include "SPDCache.h"
+#include "i2c_smbus_trace.h"
+#include "DeviceDetector.h"
+#ifdef __linux__
+#include "HotplugListener_Linux.h"
+#endif
 #include "ProfileManager.h"
 #include "LogManager.h"
 #include "SettingsManager.h"
@@ -30,6 +42,12 @@
 #include "filesystem.h"
 #include "StringUtils.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
 const hidapi_wrapper default_wrapper =
 {
     NULL,
@@ -61,6 +79,109 @@ bool BasicHIDBlock::compare(hid_device_info* info)
             );
 }
 
+/*---------------------------------------------------------*\
+| Set while the current thread runs a detection task.  The  |
+| order is the position of the running detector in the      |
+| serial detection order                                    |
+\*---------------------------------------------------------*/
+static thread_local bool            detection_task_active   = false;
+static thread_local unsigned int    detection_task_order[3] = { 0, 0, 0 };
+static thread_local std::string     detection_task_claim;
+static thread_local std::string     detection_task_hid_path;
+
+static void SetDetectionOrder(unsigned int group, unsigned int major, unsigned int minor, const std::string & claim, const char * hid_path = NULL)
+{
+    detection_task_order[0] = group;
+    detection_task_order[1] = major;
+    detection_task_order[2] = minor;
+    detection_task_claim    = claim;
+    detection_task_hid_path = (hid_path != NULL) ? hid_path : "";
+}
+
+static bool IsDetectorEnabled(const json & detector_settings, const char * name)
+{
+    bool this_device_enabled = true;
+
+    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(name))
+    {
+        this_device_enabled = detector_settings["detectors"][name];
+    }
+
+    LOG_DEBUG("[%s] is %s", name, ((this_device_enabled == true) ? "enabled" : "disabled"));
+
+    return(this_device_enabled);
+}
+
+static bool IsDetectionProfileEnabled(const json & detector_settings, bool requested)
+{
+    if(detector_settings.contains("detection_profile") && detector_settings["detection_profile"])
+    {
+        return(true);
+    }
+
+    return(requested);
+}
+
+/*---------------------------------------------------------*\
+| Identity of a controller, the same device detected again  |
+| by a rescan has the same identity                         |
+\*---------------------------------------------------------*/
+static std::string ControllerIdentity(RGBController* rgb_controller)
+{
+    return(std::to_string(rgb_controller->type) + "|" + rgb_controller->name + "|" + rgb_controller->vendor + "|" + rgb_controller->location + "|" + rgb_controller->serial);
+}
+
+static bool CompareDetectedControllers(const DetectedRGBController & a, const DetectedRGBController & b)
+{
+    return(std::lexicographical_compare(a.order, a.order + 3, b.order, b.order + 3));
+}
+
+/*---------------------------------------------------------*\
+| A kept HID controller is only still present if its path   |
+| names the same device.  Linux reuses hidraw nodes, so the |
+| IDs and serial number of its claim are compared as well   |
+\*---------------------------------------------------------*/
+static bool HIDControllerPresent(const HIDControllerPath & hid_controller, hid_device_info* hid_devices)
+{
+    for(hid_device_info* current_hid_device = hid_devices; current_hid_device; current_hid_device = current_hid_device->next)
+    {
+        if(current_hid_device->path != NULL && hid_controller.path == current_hid_device->path)
+        {
+            return(DetectionCache::HIDClaimMatches(hid_controller.claim, current_hid_device));
+        }
+    }
+
+    return(false);
+}
+
+/*---------------------------------------------------------*\
+| Time the system spent suspended since it booted, the      |
+| difference between a clock that runs during suspend and   |
+| one that does not.  0 where there is no such pair         |
+\*---------------------------------------------------------*/
+static long long SuspendedMilliseconds()
+{
+#if defined(_WIN32)
+    ULONGLONG unbiased_time;
+
+    QueryUnbiasedInterruptTime(&unbiased_time);
+
+    return((long long)GetTickCount64() - (long long)(unbiased_time / 10000));
+#elif defined(__linux__)
+    struct timespec boot_time;
+    struct timespec awake_time;
+
+    clock_gettime(CLOCK_BOOTTIME, &boot_time);
+    clock_gettime(CLOCK_MONOTONIC, &awake_time);
+
+    return(((long long)boot_time.tv_sec - awake_time.tv_sec) * 1000 + (boot_time.tv_nsec - awake_time.tv_nsec) / 1000000);
+#elif defined(__APPLE__)
+    return((long long)((clock_gettime_nsec_np(CLOCK_MONOTONIC) - clock_gettime_nsec_np(CLOCK_UPTIME_RAW)) / 1000000));
+#else
+    return(0);
+#endif
+}
+
 ResourceManager* ResourceManager::instance;
 
 using namespace std::chrono_literals;
@@ -89,6 +210,24 @@ ResourceManager::ResourceManager()
     dynamic_detectors_processed = false;
     init_finished               = false;
 
+    hid_detectors_indexed           = 0;
+    hid_wrapped_detectors_indexed   = 0;
+    detection_units_done            = 0;
+    detection_units_total           = 0;
+    detection_cache                 = new DetectionCache();
+    detection_warm                  = false;
+    spd_cache                       = new SPDCache();
+    detection_profiler              = new DetectionProfiler();
+    detection_profile               = false;
+    smbus_tracer                    = new i2c_smbus_tracer();
+    suspended_ms                    = SuspendedMilliseconds();
+    deferred_initialization         = true;
+    InitializeControllersThread     = nullptr;
+    initialize_controllers_running  = false;
+#ifdef __linux__
+    hotplug_listener                = nullptr;
+#endif
+
     SetupConfigurationDirectory();
 
     /*-------------------------------------------------------------------------*\
@@ -109,7 +248,7 @@ ResourceManager::ResourceManager()
     |   Otherwise, pass only local hardware controllers                         |
     \*-------------------------------------------------------------------------*/
     json server_settings    = settings_manager->GetSettings("Server");
-    bool all_controllers    = false;
+    all_controllers         = false;
 
     if(server_settings.contains("all_controllers"))
     {
@@ -122,14 +261,41 @@ ResourceManager::ResourceManager()
     }
     else
     {
-        server              = new NetworkServer(rgb_controllers_hw);
+        server              = new NetworkServer(rgb_controllers_hw_ready);
+    }
+
+    /*-------------------------------------------------------------------------*\
+    | Configure dead client detection.  A heartbeat timeout or keepalive time   |
+    | of 0 disables the corresponding mechanism                                 |
+    \*-------------------------------------------------------------------------*/
+    if(server_settings.contains("heartbeat_timeout"))
+    {
+        server->SetHeartbeatTimeout(server_settings["heartbeat_timeout"]);
+    }
+
+    if(server_settings.contains("keepalive_time"))
+    {
+        server->SetKeepaliveTime(server_settings["keepalive_time"]);
     }
 
     /*-------------------------------------------------------------------------*\
     | Initialize Saved Client Connections                                       |
+    |   Each client connects in its own connection thread, so all saved         |
+    |   servers are contacted concurrently.  Their devices are added as soon    |
+    |   as each server answers and InitThreadFunction waits for all of them     |
+    |   against one shared deadline                                             |
     \*-------------------------------------------------------------------------*/
     json client_settings    = settings_manager->GetSettings("Client");
 
+    unsigned int client_connect_timeout = NETWORK_CLIENT_CONNECT_TIMEOUT_MS;
+
+    if(client_settings.contains("connect_timeout"))
+    {
+        client_connect_timeout = client_settings["connect_timeout"];
+    }
+
+    clients_connect_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(client_connect_timeout);
+
     if(client_settings.contains("clients"))
     {
         for(unsigned int client_idx = 0; client_idx < client_settings["clients"].size(); client_idx++)
@@ -146,18 +312,9 @@ ResourceManager::ResourceManager()
             client->SetName(titleString.c_str());
             client->SetPort(client_port);
 
-            client->StartClient();
-
-            for(int timeout = 0; timeout < 100; timeout++)
-            {
-                if(client->GetConnected())
-                {
-                    break;
-                }
-                std::this_thread::sleep_for(10ms);
-            }
+            RegisterNetworkClient(client);
 
-            clients.push_back(client);
+            client->StartClient();
         }
     }
 
@@ -171,19 +328,52 @@ ResourceManager::ResourceManager()
 
 ResourceManager::~ResourceManager()
 {
+#ifdef __linux__
+    delete hotplug_listener;
+    hotplug_listener = nullptr;
+#endif
+
     Cleanup();
 
+    if(InitializeControllersThread)
+    {
+        initialize_controllers_running = false;
+        InitializeControllersCV.notify_all();
+        InitializeControllersThread->join();
+        delete InitializeControllersThread;
+        InitializeControllersThread = nullptr;
+    }
+
     if(InitThread)
     {
         DetectDevicesThread->join();
         delete DetectDevicesThread;
         DetectDevicesThread = nullptr;
     }
+
+    delete detection_cache;
+    delete detection_profiler;
+    delete spd_cache;
+    delete smbus_tracer;
 }
 
 void ResourceManager::RegisterI2CBus(i2c_smbus_interface *bus)
 {
     LOG_INFO("Registering I2C interface: %s Device %04X:%04X Subsystem: %04X:%04X", bus->device_name, bus->pci_vendor, bus->pci_device,bus->pci_subsystem_vendor,bus->pci_subsystem_device);
+
+    /*-------------------------------------------------*\
+    | Probe the block write size of the adapter before  |
+    | the controllers on the bus are detected           |
+    \*-------------------------------------------------*/
+    LOG_DEBUG("I2C interface %s takes block writes of up to %d bytes", bus->device_name, bus->get_max_block_size());
+
+    if(smbus_tracer->is_open())
+    {
+        bus->set_tracer(smbus_tracer);
+    }
+
+    bus->bus_id = (int)busses.size();
+
     busses.push_back(bus);
 }
 
@@ -192,10 +382,84 @@ std::vector<i2c_smbus_interface*> & ResourceManager::GetI2CBusses()
     return busses;
 }
 
+/*---------------------------------------------------------*\
+| Devices may have lost their register contents, e.g. over  |
+| a suspend, so controllers must not skip writes of values  |
+| they wrote before                                         |
+\*---------------------------------------------------------*/
+void ResourceManager::InvalidateI2CRegisterCaches()
+{
+    for(i2c_smbus_interface* bus : busses)
+    {
+        bus->invalidate_register_caches();
+    }
+}
+
+/*---------------------------------------------------------*\
+| Without the GUI there is no suspend/resume listener, the  |
+| server polls this instead.  A resume shows up as time the |
+| system spent suspended since the last call                |
+\*---------------------------------------------------------*/
+void ResourceManager::CheckForResume()
+{
+    long long now_suspended_ms = SuspendedMilliseconds();
+
+    if(now_suspended_ms - suspended_ms > 1000)
+    {
+        LOG_INFO("[ResourceManager] Resumed from suspend, invalidating I2C register caches");
+
+        InvalidateI2CRegisterCaches();
+    }
+
+    suspended_ms = now_suspended_ms;
+}
+
 void ResourceManager::RegisterRGBController(RGBController *rgb_controller)
 {
+    DetectionProfiler::CountFound();
+
+    /*-------------------------------------------------*\
+    | Start the deferred initialization as soon as the  |
+    | controller is found, so it overlaps the remaining |
+    | detection                                         |
+    \*-------------------------------------------------*/
+    if(!rgb_controller->GetInitialized())
+    {
+        if(deferred_initialization)
+        {
+            QueueControllerInitialization(rgb_controller);
+        }
+        else
+        {
+            rgb_controller->Initialize();
+        }
+    }
+
+    /*-------------------------------------------------*\
+    | Controllers found by a detection task are held    |
+    | back and registered in detection order once all   |
+    | tasks have finished                               |
+    \*-------------------------------------------------*/
+    if(detection_task_active)
+    {
+        DetectedRGBController detected;
+
+        std::copy(detection_task_order, detection_task_order + 3, detected.order);
+        detected.controller = rgb_controller;
+        detected.claim      = detection_task_claim;
+        detected.hid_path   = detection_task_hid_path;
+
+        DetectedControllersMutex.lock();
+        detected_controllers.push_back(detected);
+        DetectedControllersMutex.unlock();
+        return;
+    }
+
     LOG_INFO("[%s] Registering RGB controller", rgb_controller->name.c_str());
+
+    DeviceListChangeMutex.lock();
     rgb_controllers_hw.push_back(rgb_controller);
+    DeviceListChangeMutex.unlock();
 
     /*-------------------------------------------------*\
     | If the device list size has changed, call the     |
@@ -209,13 +473,22 @@ void ResourceManager::RegisterRGBController(RGBController *rgb_controller)
     if(rgb_controllers_hw.size() != detection_prev_size)
     {
         /*-------------------------------------------------*\
-        | First, load sizes for the new controllers         |
+        | First, load sizes for the new controllers.  The   |
+        | initialize thread loads them for controllers with |
+        | deferred initialization                           |
         \*-------------------------------------------------*/
+        DetectionSizesMutex.lock();
+
         for(unsigned int controller_size_idx = detection_prev_size; controller_size_idx < rgb_controllers_hw.size(); controller_size_idx++)
         {
-            profile_manager->LoadDeviceFromListWithOptions(rgb_controllers_sizes, detection_size_entry_used, rgb_controllers_hw[controller_size_idx], true, false);
+            if(deferred_controllers.count(rgb_controllers_hw[controller_size_idx]) == 0)
+            {
+                profile_manager->LoadDeviceFromListWithOptions(rgb_controllers_sizes, detection_size_entry_used, rgb_controllers_hw[controller_size_idx], true, false);
+            }
         }
 
+        DetectionSizesMutex.unlock();
+
         UpdateDeviceList();
     }
 
@@ -228,6 +501,8 @@ void ResourceManager::UnregisterRGBController(RGBController* rgb_controller)
 {
     LOG_INFO("[%s] Unregistering RGB controller", rgb_controller->name.c_str());
 
+    CancelControllerInitialization(rgb_controller);
+
     /*-------------------------------------------------------------------------*\
     | Clear callbacks from the controller before removal                        |
     \*-------------------------------------------------------------------------*/
@@ -236,6 +511,8 @@ void ResourceManager::UnregisterRGBController(RGBController* rgb_controller)
     /*-------------------------------------------------------------------------*\
     | Find the controller to remove and remove it from the hardware list        |
     \*-------------------------------------------------------------------------*/
+    DeviceListChangeMutex.lock();
+
     std::vector<RGBController*>::iterator hw_it = std::find(rgb_controllers_hw.begin(), rgb_controllers_hw.end(), rgb_controller);
 
     if (hw_it != rgb_controllers_hw.end())
@@ -243,6 +520,13 @@ void ResourceManager::UnregisterRGBController(RGBController* rgb_controller)
         rgb_controllers_hw.erase(hw_it);
     }
 
+    std::vector<RGBController*>::iterator ready_it = std::find(rgb_controllers_hw_ready.begin(), rgb_controllers_hw_ready.end(), rgb_controller);
+
+    if (ready_it != rgb_controllers_hw_ready.end())
+    {
+        rgb_controllers_hw_ready.erase(ready_it);
+    }
+
     /*-------------------------------------------------------------------------*\
     | Find the controller to remove and remove it from the master list          |
     \*-------------------------------------------------------------------------*/
@@ -253,9 +537,37 @@ void ResourceManager::UnregisterRGBController(RGBController* rgb_controller)
         rgb_controllers.erase(rgb_it);
     }
 
+    DeviceListChangeMutex.unlock();
+
     UpdateDeviceList();
 }
 
+/*---------------------------------------------------------*\
+| Network clients add and remove the controllers of their   |
+| server here, under the same lock as the rest of the list  |
+\*---------------------------------------------------------*/
+void ResourceManager::RegisterClientControllers(std::vector<RGBController *> & client_controllers)
+{
+    std::lock_guard<std::mutex> lock(DeviceListChangeMutex);
+
+    rgb_controllers.insert(rgb_controllers.end(), client_controllers.begin(), client_controllers.end());
+}
+
+void ResourceManager::UnregisterClientControllers(std::vector<RGBController *> & client_controllers)
+{
+    std::lock_guard<std::mutex> lock(DeviceListChangeMutex);
+
+    for(std::size_t client_controller_idx = 0; client_controller_idx < client_controllers.size(); client_controller_idx++)
+    {
+        std::vector<RGBController*>::iterator rgb_it = std::find(rgb_controllers.begin(), rgb_controllers.end(), client_controllers[client_controller_idx]);
+
+        if(rgb_it != rgb_controllers.end())
+        {
+            rgb_controllers.erase(rgb_it);
+        }
+    }
+}
+
 std::vector<RGBController*> & ResourceManager::GetRGBControllers()
 {
     return rgb_controllers;
@@ -303,6 +615,19 @@ void ResourceManager::RegisterDeviceDetector(std::string name, DeviceDetectorFun
 {
     device_detector_strings.push_back(name);
     device_detectors.push_back(detector);
+    device_detector_network.push_back(false);
+}
+
+void ResourceManager::RegisterNetworkDeviceDetector(std::string name, DeviceDetectorFunction detector)
+{
+    /*-------------------------------------------------*\
+    | Network detectors only talk to their configured   |
+    | or discovered hosts, so each one gets its own     |
+    | detection task                                    |
+    \*-------------------------------------------------*/
+    device_detector_strings.push_back(name);
+    device_detectors.push_back(detector);
+    device_detector_network.push_back(true);
 }
 
 void ResourceManager::RegisterHIDDeviceDetector(std::string name,
@@ -460,10 +785,29 @@ void ResourceManager::UpdateDeviceList()
 {
     DeviceListChangeMutex.lock();
 
+    /*-------------------------------------------------*\
+    | Build the list of initialized hardware            |
+    | controllers.  Controllers waiting for their       |
+    | deferred initialization are held back until it    |
+    | has run, as it sets up their zones and LEDs.  The |
+    | SDK server exports this list when it does not     |
+    | relay client controllers, so the GUI and the SDK  |
+    | list the same devices                             |
+    \*-------------------------------------------------*/
+    rgb_controllers_hw_ready.clear();
+
+    for(RGBController* rgb_controller : rgb_controllers_hw)
+    {
+        if(rgb_controller->GetInitialized())
+        {
+            rgb_controllers_hw_ready.push_back(rgb_controller);
+        }
+    }
+
     /*-------------------------------------------------*\
     | Insert hardware controllers into controller list  |
     \*-------------------------------------------------*/
-    for(unsigned int hw_controller_idx = 0; hw_controller_idx < rgb_controllers_hw.size(); hw_controller_idx++)
+    for(unsigned int hw_controller_idx = 0; hw_controller_idx < rgb_controllers_hw_ready.size(); hw_controller_idx++)
     {
         /*-------------------------------------------------*\
         | Check if the controller is already in the list    |
@@ -471,7 +815,7 @@ void ResourceManager::UpdateDeviceList()
         \*-------------------------------------------------*/
         if(hw_controller_idx < rgb_controllers.size())
         {
-            if(rgb_controllers[hw_controller_idx] == rgb_controllers_hw[hw_controller_idx])
+            if(rgb_controllers[hw_controller_idx] == rgb_controllers_hw_ready[hw_controller_idx])
             {
                 continue;
             }
@@ -481,12 +825,15 @@ void ResourceManager::UpdateDeviceList()
         | If not, check if the controller is already in the |
         | list at a different index                         |
         \*-------------------------------------------------*/
+        bool moved = false;
+
         for(unsigned int controller_idx = 0; controller_idx < rgb_controllers.size(); controller_idx++)
         {
-            if(rgb_controllers[controller_idx] == rgb_controllers_hw[hw_controller_idx])
+            if(rgb_controllers[controller_idx] == rgb_controllers_hw_ready[hw_controller_idx])
             {
                 rgb_controllers.erase(rgb_controllers.begin() + controller_idx);
-                rgb_controllers.insert(rgb_controllers.begin() + hw_controller_idx, rgb_controllers_hw[hw_controller_idx]);
+                rgb_controllers.insert(rgb_controllers.begin() + hw_controller_idx, rgb_controllers_hw_ready[hw_controller_idx]);
+                moved = true;
                 break;
             }
         }
@@ -494,7 +841,10 @@ void ResourceManager::UpdateDeviceList()
         /*-------------------------------------------------*\
         | If it still hasn't been found, add it to the list |
         \*-------------------------------------------------*/
-        rgb_controllers.insert(rgb_controllers.begin() + hw_controller_idx, rgb_controllers_hw[hw_controller_idx]);
+        if(!moved)
+        {
+            rgb_controllers.insert(rgb_controllers.begin() + hw_controller_idx, rgb_controllers_hw_ready[hw_controller_idx]);
+        }
     }
 
     /*-------------------------------------------------*\
@@ -622,16 +972,46 @@ NetworkServer* ResourceManager::GetServer()
     return(server);
 }
 
+bool ResourceManager::GetRelayMode()
+{
+    return(all_controllers);
+}
+
 static void NetworkClientInfoChangeCallback(void* this_ptr)
 {
     ResourceManager* this_obj = (ResourceManager*)this_ptr;
 
     this_obj->DeviceListChanged();
+
+    /*-------------------------------------------------*\
+    | In relay mode the server exports the client       |
+    | devices, so its own clients must be told when a   |
+    | downstream server's device list changes           |
+    \*-------------------------------------------------*/
+    if(this_obj->GetRelayMode())
+    {
+        this_obj->GetServer()->DeviceListChanged();
+    }
+}
+
+static void NetworkClientControllersAddCallback(void* this_ptr, std::vector<RGBController *> & client_controllers)
+{
+    ResourceManager* this_obj = (ResourceManager*)this_ptr;
+
+    this_obj->RegisterClientControllers(client_controllers);
+}
+
+static void NetworkClientControllersRemoveCallback(void* this_ptr, std::vector<RGBController *> & client_controllers)
+{
+    ResourceManager* this_obj = (ResourceManager*)this_ptr;
+
+    this_obj->UnregisterClientControllers(client_controllers);
 }
 
 void ResourceManager::RegisterNetworkClient(NetworkClient* new_client)
 {
     new_client->RegisterClientInfoChangeCallback(NetworkClientInfoChangeCallback, this);
+    new_client->SetControllersCallbacks(NetworkClientControllersAddCallback, NetworkClientControllersRemoveCallback, this);
 
     clients.push_back(new_client);
 }
@@ -675,6 +1055,41 @@ void ResourceManager::UnregisterNetworkClient(NetworkClient* network_client)
 *                                                                                          *
 \******************************************************************************************/
 
+/******************************************************************************************\
+*                                                                                          *
+*   WaitForNetworkClients                                                                  *
+*                                                                                          *
+*       Waits until every network client has received its device list or the shared       *
+*       connect deadline set when the saved clients were started has passed                *
+*                                                                                          *
+\******************************************************************************************/
+
+void ResourceManager::WaitForNetworkClients()
+{
+    while(std::chrono::steady_clock::now() < clients_connect_deadline)
+    {
+        bool all_online = true;
+
+        for(std::size_t client_idx = 0; client_idx < clients.size(); client_idx++)
+        {
+            if(!clients[client_idx]->GetOnline())
+            {
+                all_online = false;
+                break;
+            }
+        }
+
+        if(all_online)
+        {
+            return;
+        }
+
+        std::this_thread::sleep_for(5ms);
+    }
+
+    LOG_DEBUG("[ResourceManager] Network client connect deadline reached, continuing without offline servers");
+}
+
 bool ResourceManager::AttemptLocalConnection()
 {
     detection_percent = 0;
@@ -691,6 +1106,13 @@ bool ResourceManager::AttemptLocalConnection()
     titleString.append(VERSION_STRING);
 
     client->SetName(titleString.c_str());
+
+    /*-----------------------------------------------------*\
+    | The client is only registered once it connected, but  |
+    | its controllers must already go through the device    |
+    | list lock                                             |
+    \*-----------------------------------------------------*/
+    client->SetControllersCallbacks(NetworkClientControllersAddCallback, NetworkClientControllersRemoveCallback, this);
     client->StartClient();
 
     for(int timeout = 0; timeout < 10; timeout++)
@@ -766,51 +1188,200 @@ const char *ResourceManager::GetDetectionString()
     return (detection_string);
 }
 
-void ResourceManager::Cleanup()
+/*---------------------------------------------------------*\
+| Logs the bus utilization and the bus and wait time of     |
+| each controller address on a bus                          |
+\*---------------------------------------------------------*/
+void ResourceManager::LogI2CBusStats(i2c_smbus_interface* bus)
 {
-    ResourceManager::get()->WaitForDeviceDetection();
+    std::vector<i2c_smbus_client_stats> client_stats = bus->get_client_stats();
 
-    std::vector<RGBController *> rgb_controllers_hw_copy = rgb_controllers_hw;
+    if(client_stats.empty())
+    {
+        return;
+    }
 
-    for(std::size_t hw_controller_idx = 0; hw_controller_idx < rgb_controllers_hw.size(); hw_controller_idx++)
+    LOG_DEBUG("[ResourceManager] %s: %.1f%% bus utilization", bus->device_name, bus->get_utilization() * 100.0);
+
+    for(std::size_t client_idx = 0; client_idx < client_stats.size(); client_idx++)
     {
-        for(std::size_t controller_idx = 0; controller_idx < rgb_controllers.size(); controller_idx++)
+        const i2c_smbus_client_stats& client = client_stats[client_idx];
+
+        LOG_DEBUG("[ResourceManager]   0x%02X: %llu transactions, %.2f ms on the bus, %.2f ms waiting, %.2f ms longest wait",
+                  client.addr,
+                  client.transactions,
+                  client.busy_ns / 1000000.0,
+                  client.wait_ns / 1000000.0,
+                  client.max_wait_ns / 1000000.0);
+
+        if(client.errors > 0 || client.skipped > 0)
         {
-            if(rgb_controllers[controller_idx] == rgb_controllers_hw[hw_controller_idx])
-            {
-                rgb_controllers.erase(rgb_controllers.begin() + controller_idx);
-                break;
-            }
+            LOG_WARNING("[ResourceManager]   0x%02X: %llu errors, %llu retries, %llu transfers skipped%s",
+                        client.addr,
+                        client.errors,
+                        client.retries,
+                        client.skipped,
+                        client.degraded ? ", degraded" : "");
         }
     }
+}
+
+void ResourceManager::Cleanup(bool retain_hid_controllers)
+{
+    ResourceManager::get()->WaitForDeviceDetection();
 
     /*-------------------------------------------------*\
-    | Clear the hardware controllers list and set the   |
-    | previous hardware controllers list size to zero   |
+    | Keep hotplug detection out while the controllers  |
+    | are torn down                                     |
     \*-------------------------------------------------*/
-    rgb_controllers_hw.clear();
-    detection_prev_size = 0;
-
-    for(RGBController* rgb_controller : rgb_controllers_hw_copy)
-    {
-        delete rgb_controller;
-    }
+    DetectDeviceMutex.lock();
 
-    std::vector<i2c_smbus_interface *> busses_copy = busses;
+    CancelControllerInitialization(NULL);
 
-    busses.clear();
+    /*-------------------------------------------------*\
+    | Remember the current controllers, so a rescan can |
+    | keep the order of the devices that are still here |
+    \*-------------------------------------------------*/
+    previous_controller_identities.clear();
 
-    for(i2c_smbus_interface* bus : busses_copy)
+    for(std::size_t hw_controller_idx = 0; hw_controller_idx < rgb_controllers_hw.size(); hw_controller_idx++)
     {
-        delete bus;
+        previous_controller_identities.push_back(ControllerIdentity(rgb_controllers_hw[hw_controller_idx]));
     }
 
     /*-------------------------------------------------*\
-    | Cleanup HID interface                             |
+    | Controllers found on a HID interface can be kept. |
+    | The rescan skips their interfaces, so their       |
+    | handles stay open and their readback is not done  |
+    | again                                             |
     \*-------------------------------------------------*/
-    int hid_status = hid_exit();
+    std::set<RGBController*> retained_controllers;
 
-    LOG_DEBUG("Closing HID interfaces: %s", ((hid_status == 0) ? "Success" : "Failed"));
+    retained_hid_paths.clear();
+
+    if(retain_hid_controllers)
+    {
+        /*---------------------------------------------*\
+        | A controller whose interface is gone or now   |
+        | belongs to another device is not kept         |
+        \*---------------------------------------------*/
+        hid_device_info* present_devices = hid_enumerate(0, 0);
+
+        for(std::size_t hid_controller_idx = 0; hid_controller_idx < hid_controller_paths.size();)
+        {
+            if(HIDControllerPresent(hid_controller_paths[hid_controller_idx], present_devices))
+            {
+                retained_controllers.insert(hid_controller_paths[hid_controller_idx].controller);
+                retained_hid_paths.insert(hid_controller_paths[hid_controller_idx].path);
+
+                hid_controller_idx++;
+            }
+            else
+            {
+                hid_controller_paths.erase(hid_controller_paths.begin() + hid_controller_idx);
+            }
+        }
+
+        hid_free_enumeration(present_devices);
+    }
+    else
+    {
+        hid_controller_paths.clear();
+    }
+
+    DeviceListChangeMutex.lock();
+
+    std::vector<RGBController *> rgb_controllers_hw_copy = rgb_controllers_hw;
+    std::vector<RGBController *> deleted_controllers;
+
+    for(std::size_t hw_controller_idx = 0; hw_controller_idx < rgb_controllers_hw.size(); hw_controller_idx++)
+    {
+        if(retained_controllers.count(rgb_controllers_hw[hw_controller_idx]) > 0)
+        {
+            continue;
+        }
+
+        for(std::size_t controller_idx = 0; controller_idx < rgb_controllers.size(); controller_idx++)
+        {
+            if(rgb_controllers[controller_idx] == rgb_controllers_hw[hw_controller_idx])
+            {
+                rgb_controllers.erase(rgb_controllers.begin() + controller_idx);
+                break;
+            }
+        }
+
+        deleted_controllers.push_back(rgb_controllers_hw[hw_controller_idx]);
+    }
+
+    /*-------------------------------------------------*\
+    | Clear the hardware controllers list except for    |
+    | the kept controllers and set the previous size to |
+    | the number of kept controllers                    |
+    \*-------------------------------------------------*/
+    rgb_controllers_hw.clear();
+    rgb_controllers_hw_ready.clear();
+
+    for(RGBController* rgb_controller : rgb_controllers_hw_copy)
+    {
+        if(retained_controllers.count(rgb_controller) > 0)
+        {
+            rgb_controllers_hw.push_back(rgb_controller);
+
+            if(rgb_controller->GetInitialized())
+            {
+                rgb_controllers_hw_ready.push_back(rgb_controller);
+            }
+        }
+    }
+
+    detection_prev_size = (unsigned int)rgb_controllers_hw.size();
+
+    DeviceListChangeMutex.unlock();
+
+    for(RGBController* rgb_controller : deleted_controllers)
+    {
+        delete rgb_controller;
+    }
+
+    /*-------------------------------------------------*\
+    | Kept controllers that were still waiting for      |
+    | their deferred initialization go back in line     |
+    \*-------------------------------------------------*/
+    for(RGBController* rgb_controller : rgb_controllers_hw)
+    {
+        if(!rgb_controller->GetInitialized())
+        {
+            QueueControllerInitialization(rgb_controller);
+        }
+    }
+
+    if(!rgb_controllers_hw.empty())
+    {
+        LOG_INFO("[ResourceManager] Keeping %d HID controllers for the rescan", (int)rgb_controllers_hw.size());
+    }
+
+    DetectDeviceMutex.unlock();
+
+    std::vector<i2c_smbus_interface *> busses_copy = busses;
+
+    busses.clear();
+
+    for(i2c_smbus_interface* bus : busses_copy)
+    {
+        LogI2CBusStats(bus);
+        delete bus;
+    }
+
+    /*-------------------------------------------------*\
+    | Cleanup HID interface.  Kept controllers still    |
+    | use it                                            |
+    \*-------------------------------------------------*/
+    if(retained_hid_paths.empty())
+    {
+        int hid_status = hid_exit();
+
+        LOG_DEBUG("Closing HID interfaces: %s", ((hid_status == 0) ? "Success" : "Failed"));
+    }
 
     if(DetectDevicesThread)
     {
@@ -845,6 +1416,12 @@ void ResourceManager::ProcessDynamicDetectors()
 \*-----------------------------------------------------*/
 bool ResourceManager::ProcessPreDetection()
 {
+    /*-----------------------------------------------------*\
+    | Register the statically declared detectors.  Only     |
+    | the first detection registers the full list           |
+    \*-----------------------------------------------------*/
+    DetectorDescriptor::RegisterAll(this);
+
     /*-----------------------------------------------------*\
     | Process pre-detection hooks                           |
     \*-----------------------------------------------------*/
@@ -891,7 +1468,20 @@ bool ResourceManager::ProcessPreDetection()
 
         DetectionProgressChanged();
 
-        Cleanup();
+        /*-------------------------------------------------*\
+        | Keep the HID controllers of a previous detection  |
+        | unless disabled.  Profiling needs every detector  |
+        | to run                                            |
+        \*-------------------------------------------------*/
+        json detector_settings  = settings_manager->GetSettings("Detectors");
+        bool reuse_controllers  = true;
+
+        if(detector_settings.contains("reuse_controllers"))
+        {
+            reuse_controllers = detector_settings["reuse_controllers"];
+        }
+
+        Cleanup(reuse_controllers && !IsDetectionProfileEnabled(detector_settings, detection_profile));
 
         UpdateDeviceList();
 
@@ -960,444 +1550,1315 @@ void ResourceManager::DisableDetection()
     detection_enabled = false;
 }
 
-void ResourceManager::DetectDevicesThreadFunction()
+void ResourceManager::BuildHIDDetectorIndex()
 {
-    DetectDeviceMutex.lock();
+    /*-------------------------------------------------*\
+    | Group the registered HID detectors by vendor and  |
+    | product ID so that each enumerated interface only |
+    | has to be compared against its own candidates.    |
+    | Candidates keep their registration order.  The    |
+    | detector lists only grow, so the index is only    |
+    | rebuilt when something was registered since the   |
+    | last detection                                    |
+    \*-------------------------------------------------*/
+    if(hid_detectors_indexed         == hid_device_detectors.size()
+    && hid_wrapped_detectors_indexed == hid_wrapped_device_detectors.size())
+    {
+        return;
+    }
 
-    hid_device_info*    current_hid_device;
-    float               percent             = 0.0f;
-    float               percent_denominator = 0.0f;
-    json                detector_settings;
-    unsigned int        hid_device_count    = 0;
-    hid_device_info*    hid_devices         = NULL;
-    bool                hid_safe_mode       = false;
+    hid_device_detector_index.clear();
+    hid_wrapped_device_detector_index.clear();
 
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|               Start device detection               |");
-    LOG_INFO("------------------------------------------------------");
+    hid_device_detector_index.reserve(hid_device_detectors.size());
+    hid_wrapped_device_detector_index.reserve(hid_wrapped_device_detectors.size());
 
-    /*-------------------------------------------------*\
-    | Reset the size entry used flags vector            |
-    \*-------------------------------------------------*/
-    detection_size_entry_used.resize(rgb_controllers_sizes.size());
+    for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_device_detectors.size(); hid_detector_idx++)
+    {
+        HIDDeviceDetectorBlock & detector = hid_device_detectors[hid_detector_idx];
 
-    for(std::size_t size_idx = 0; size_idx < (unsigned int)detection_size_entry_used.size(); size_idx++)
+        hid_device_detector_index[HID_DETECTOR_INDEX_KEY(detector.vid, detector.pid)].push_back(hid_detector_idx);
+    }
+
+    for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_wrapped_device_detectors.size(); hid_detector_idx++)
     {
-        detection_size_entry_used[size_idx] = false;
+        HIDWrappedDeviceDetectorBlock & detector = hid_wrapped_device_detectors[hid_detector_idx];
+
+        hid_wrapped_device_detector_index[HID_DETECTOR_INDEX_KEY(detector.vid, detector.pid)].push_back(hid_detector_idx);
     }
 
-    /*-------------------------------------------------*\
-    | Open device disable list and read in disabled     |
-    | device strings                                    |
-    \*-------------------------------------------------*/
-    detector_settings = settings_manager->GetSettings("Detectors");
+    hid_detectors_indexed         = hid_device_detectors.size();
+    hid_wrapped_detectors_indexed = hid_wrapped_device_detectors.size();
 
-    /*-------------------------------------------------*\
-    | Check HID safe mode setting                       |
-    \*-------------------------------------------------*/
-    if(detector_settings.contains("hid_safe_mode"))
+    LOG_DEBUG("[ResourceManager] Indexed %d HID and %d wrapped HID detectors under %d and %d device IDs", (int)hid_device_detectors.size(), (int)hid_wrapped_device_detectors.size(), (int)hid_device_detector_index.size(), (int)hid_wrapped_device_detector_index.size());
+}
+
+void ResourceManager::RunDetectionTasks(std::vector<DetectionTask> & tasks, bool parallel)
+{
+    std::atomic<std::size_t> next_task(0);
+
+    detection_units_done  = 0;
+    detection_units_total = 0;
+
+    for(std::size_t task_idx = 0; task_idx < tasks.size(); task_idx++)
     {
-        hid_safe_mode = detector_settings["hid_safe_mode"];
+        detection_units_total += tasks[task_idx].units;
     }
 
     /*-------------------------------------------------*\
-    | Calculate the percentage denominator by adding    |
-    | the number of I2C and miscellaneous detectors and |
-    | the number of enumerated HID devices              |
-    |                                                   |
-    | Start by iterating through all HID devices in     |
-    | list to get a total count                         |
+    | Each worker takes the next task off the list, so  |
+    | a task never runs on more than one thread         |
     \*-------------------------------------------------*/
-    if(!hid_safe_mode)
+    std::function<void()> worker = [&tasks, &next_task]()
     {
-        hid_devices = hid_enumerate(0, 0);
+        detection_task_active = true;
+
+        for(std::size_t task_idx = next_task++; task_idx < tasks.size(); task_idx = next_task++)
+        {
+            tasks[task_idx].function();
+        }
+
+        detection_task_active = false;
+    };
+
+    std::size_t thread_count = std::min(tasks.size(), (std::size_t)DETECTION_MAX_THREADS);
+
+    if(!parallel || thread_count <= 1)
+    {
+        worker();
+        return;
     }
 
-    current_hid_device = hid_devices;
+    LOG_DEBUG("[ResourceManager] Running %d detection tasks on %d threads", (int)tasks.size(), (int)thread_count);
+
+    std::vector<std::thread> threads;
 
-    while(current_hid_device)
+    for(std::size_t thread_idx = 0; thread_idx < thread_count; thread_idx++)
     {
-        hid_device_count++;
+        threads.emplace_back(worker);
+    }
 
-        current_hid_device = current_hid_device->next;
+    for(std::size_t thread_idx = 0; thread_idx < threads.size(); thread_idx++)
+    {
+        threads[thread_idx].join();
     }
+}
 
-    percent_denominator = (float)(i2c_device_detectors.size() + i2c_dimm_device_detectors.size() + i2c_pci_device_detectors.size() + device_detectors.size()) + (float)hid_device_count;
+void ResourceManager::DetectionUnitsDone(unsigned int units)
+{
+    unsigned int done = (detection_units_done += units);
 
-    /*-------------------------------------------------*\
-    | Start at 0% detection progress                    |
-    \*-------------------------------------------------*/
-    detection_percent = 0;
+    if(detection_units_total > 0)
+    {
+        detection_percent = (unsigned int)(((unsigned long long)std::min(done, detection_units_total) * 100) / detection_units_total);
+    }
+}
 
-#ifdef __linux__
-    /*-------------------------------------------------*\
-    | Check if the udev rules exist                     |
-    \*-------------------------------------------------*/
-    bool udev_not_exist     = false;
-    bool udev_multiple      = false;
+void ResourceManager::RegisterDetectedControllers(unsigned int last_order)
+{
+    std::vector<DetectedRGBController> ready;
 
-    if(access("/etc/udev/rules.d/60-openrgb.rules", F_OK) != 0)
+    DetectedControllersMutex.lock();
+
+    for(std::size_t detected_idx = 0; detected_idx < detected_controllers.size();)
     {
-        if(access("/usr/lib/udev/rules.d/60-openrgb.rules", F_OK) != 0)
+        if(detected_controllers[detected_idx].order[0] <= last_order)
         {
-            udev_not_exist  = true;
+            ready.push_back(detected_controllers[detected_idx]);
+            detected_controllers.erase(detected_controllers.begin() + detected_idx);
+        }
+        else
+        {
+            detected_idx++;
         }
     }
-    else
+
+    DetectedControllersMutex.unlock();
+
+    /*-------------------------------------------------*\
+    | Only one task runs each detector position, so a   |
+    | stable sort keeps the order within a detector     |
+    \*-------------------------------------------------*/
+    std::stable_sort(ready.begin(), ready.end(), CompareDetectedControllers);
+
+    for(std::size_t ready_idx = 0; ready_idx < ready.size(); ready_idx++)
     {
-        if(access("/usr/lib/udev/rules.d/60-openrgb.rules", F_OK) == 0)
+        detection_cache->AddClaim(ready[ready_idx].claim);
+
+        RegisterRGBController(ready[ready_idx].controller);
+
+        if(!ready[ready_idx].hid_path.empty())
         {
-            udev_multiple   = true;
+            HIDControllerPath hid_controller;
+
+            hid_controller.path         = ready[ready_idx].hid_path;
+            hid_controller.claim        = ready[ready_idx].claim;
+            hid_controller.controller   = ready[ready_idx].controller;
+
+            hid_controller_paths.push_back(hid_controller);
         }
     }
-#endif
+}
+
+static std::string HIDInterfaceKey(hid_device_info* info)
+{
+    char ids[32];
+
+    snprintf(ids, sizeof(ids), "%04X:%04X:%d ", info->vendor_id, info->product_id, info->interface_number);
+
+    return(std::string(ids) + ((info->serial_number != NULL) ? StringUtils::wstring_to_string(info->serial_number) : std::string()));
+}
+
+void ResourceManager::BuildHIDDeviceTable(hid_device_info* hid_devices, hid_device_info* libusb_devices, std::vector<HIDDeviceTableEntry> & table)
+{
+    std::map<std::string, std::vector<std::size_t>> twins;
+    std::set<std::string>                           paths;
+    unsigned int                                    position = 0;
+
+    BuildHIDDetectorIndex();
+
+    table.clear();
 
     /*-------------------------------------------------*\
-    | Detect i2c interfaces                             |
+    | One entry per hidapi interface, in enumeration    |
+    | order.  The position is the index in the list     |
     \*-------------------------------------------------*/
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|             Detecting I2C interfaces               |");
-    LOG_INFO("------------------------------------------------------");
+    for(hid_device_info* current_hid_device = hid_devices; current_hid_device; current_hid_device = current_hid_device->next, position++)
+    {
+        HIDDeviceTableEntry entry;
 
-    bool i2c_interface_fail = false;
+        entry.info          = current_hid_device;
+        entry.libusb_info   = NULL;
+        entry.backends      = HID_BACKEND_HIDAPI;
+        entry.position      = position;
 
-    for(unsigned int i2c_bus_detector_idx = 0; i2c_bus_detector_idx < (unsigned int)i2c_bus_detectors.size() && detection_is_required.load(); i2c_bus_detector_idx++)
-    {
-        if(i2c_bus_detectors[i2c_bus_detector_idx]() == false)
+        HIDDetectorIndex::const_iterator hid_candidates = hid_device_detector_index.find(HID_DETECTOR_INDEX_KEY(current_hid_device->vendor_id, current_hid_device->product_id));
+
+        for(unsigned int candidate_idx = 0; hid_candidates != hid_device_detector_index.end() && candidate_idx < (unsigned int)hid_candidates->second.size(); candidate_idx++)
         {
-            i2c_interface_fail = true;
+            if(hid_device_detectors[hid_candidates->second[candidate_idx]].compare(current_hid_device))
+            {
+                entry.hid_detectors.push_back(hid_candidates->second[candidate_idx]);
+            }
         }
 
-        I2CBusListChanged();
+        HIDDetectorIndex::const_iterator wrapped_candidates = hid_wrapped_device_detector_index.find(HID_DETECTOR_INDEX_KEY(current_hid_device->vendor_id, current_hid_device->product_id));
+
+        for(unsigned int candidate_idx = 0; wrapped_candidates != hid_wrapped_device_detector_index.end() && candidate_idx < (unsigned int)wrapped_candidates->second.size(); candidate_idx++)
+        {
+            if(hid_wrapped_device_detectors[wrapped_candidates->second[candidate_idx]].compare(current_hid_device))
+            {
+                entry.wrapped_detectors.push_back(wrapped_candidates->second[candidate_idx]);
+            }
+        }
+
+        /*---------------------------------------------*\
+        | hidapi lists an interface once per top level  |
+        | usage, only the first entry of a path can get |
+        | the libusb twin                               |
+        \*---------------------------------------------*/
+        if(current_hid_device->path != NULL && paths.insert(current_hid_device->path).second)
+        {
+            twins[HIDInterfaceKey(current_hid_device)].push_back(table.size());
+        }
+
+        table.push_back(entry);
     }
 
     /*-------------------------------------------------*\
-    | Detect i2c devices                                |
+    | libusb interfaces are only kept when a wrapped    |
+    | detector matches them.  An interface already in   |
+    | the table gets the libusb info added to its entry |
     \*-------------------------------------------------*/
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|               Detecting I2C devices                |");
-    LOG_INFO("------------------------------------------------------");
-    for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < (unsigned int)i2c_device_detectors.size() && detection_is_required.load(); i2c_detector_idx++)
+    for(hid_device_info* current_hid_device = libusb_devices; current_hid_device; current_hid_device = current_hid_device->next)
     {
-        unsigned int controller_size = rgb_controllers_hw.size();
-        detection_string = i2c_device_detector_strings[i2c_detector_idx].c_str();
+        std::vector<unsigned int>        libusb_detectors;
+        HIDDetectorIndex::const_iterator wrapped_candidates = hid_wrapped_device_detector_index.find(HID_DETECTOR_INDEX_KEY(current_hid_device->vendor_id, current_hid_device->product_id));
 
-        /*-------------------------------------------------*\
-        | Check if this detector is enabled                 |
-        \*-------------------------------------------------*/
-        bool this_device_enabled = true;
-        if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
+        for(unsigned int candidate_idx = 0; wrapped_candidates != hid_wrapped_device_detector_index.end() && candidate_idx < (unsigned int)wrapped_candidates->second.size(); candidate_idx++)
         {
-            this_device_enabled = detector_settings["detectors"][detection_string];
+            if(hid_wrapped_device_detectors[wrapped_candidates->second[candidate_idx]].compare(current_hid_device))
+            {
+                libusb_detectors.push_back(wrapped_candidates->second[candidate_idx]);
+            }
         }
 
-        LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
-        if(this_device_enabled)
+        if(libusb_detectors.empty())
         {
-            DetectionProgressChanged();
+            continue;
+        }
+
+        std::map<std::string, std::vector<std::size_t>>::iterator twin = twins.find(HIDInterfaceKey(current_hid_device));
+
+        if(twin != twins.end() && !twin->second.empty())
+        {
+            HIDDeviceTableEntry & entry = table[twin->second.front()];
+
+            entry.libusb_info       = current_hid_device;
+            entry.backends         |= HID_BACKEND_LIBUSB;
+            entry.libusb_detectors  = libusb_detectors;
 
-            i2c_device_detectors[i2c_detector_idx](busses);
+            twin->second.erase(twin->second.begin());
         }
+        else
+        {
+            HIDDeviceTableEntry entry;
 
-        /*-------------------------------------------------*\
-        | If the device list size has changed, call the     |
-        | device list changed callbacks                     |
-        \*-------------------------------------------------*/
-        if(rgb_controllers_hw.size() == controller_size)
+            entry.info              = NULL;
+            entry.libusb_info       = current_hid_device;
+            entry.backends          = HID_BACKEND_LIBUSB;
+            entry.position          = position++;
+            entry.libusb_detectors  = libusb_detectors;
+
+            table.push_back(entry);
+        }
+    }
+
+    if(LogManager::get()->getLoglevel() >= LL_DEBUG)
+    {
+        for(std::size_t entry_idx = 0; entry_idx < table.size(); entry_idx++)
         {
-            LOG_DEBUG("[%s] no devices found", detection_string);
+            hid_device_info* info      = (table[entry_idx].info != NULL) ? table[entry_idx].info : table[entry_idx].libusb_info;
+            std::string      manu_name = (info->manufacturer_string != NULL) ? StringUtils::wstring_to_string(info->manufacturer_string) : std::string();
+            std::string      prod_name = (info->product_string      != NULL) ? StringUtils::wstring_to_string(info->product_string)      : std::string();
+            const char*      backends  = "";
+
+            if(table[entry_idx].backends == (HID_BACKEND_HIDAPI | HID_BACKEND_LIBUSB))
+            {
+                backends = " (hidapi, libusb)";
+            }
+            else if(table[entry_idx].backends == HID_BACKEND_LIBUSB)
+            {
+                backends = " (libusb)";
+            }
+
+            LOG_DEBUG("[%04X:%04X U=%04X P=0x%04X I=%d] %-25s - %s%s", info->vendor_id, info->product_id, info->usage, info->usage_page, info->interface_number, manu_name.c_str(), prod_name.c_str(), backends);
         }
+    }
+}
 
-        LOG_TRACE("[%s] detection end", detection_string);
+void ResourceManager::RunHIDDeviceDetectors(HIDDeviceTableEntry & entry, std::function<bool(const std::string &, const std::string &)> detector_wanted)
+{
+    /*-------------------------------------------------*\
+    | HID detectors run before wrapped HID detectors    |
+    | for the same interface                            |
+    \*-------------------------------------------------*/
+    for(std::size_t match_idx = 0; match_idx < entry.hid_detectors.size(); match_idx++)
+    {
+        unsigned int             hid_detector_idx = entry.hid_detectors[match_idx];
+        HIDDeviceDetectorBlock & detector         = hid_device_detectors[hid_detector_idx];
+        std::string              claim            = DetectionCache::HIDClaim(detector.name, entry.info);
 
-        /*-------------------------------------------------*\
-        | Update detection percent                          |
-        \*-------------------------------------------------*/
-        percent = ((float)i2c_detector_idx + 1.0f) / percent_denominator;
+        if(detector_wanted(detector.name, claim))
+        {
+            detection_string = detector.name.c_str();
+            DetectionProgressChanged();
+
+            SetDetectionOrder(DETECTION_ORDER_HID, entry.position, hid_detector_idx, claim, entry.info->path);
+            DetectionProfileScope profile(detection_profiler, detector.name, true);
+            detector.function(entry.info, detector.name);
+        }
+    }
+
+    for(std::size_t match_idx = 0; match_idx < entry.wrapped_detectors.size(); match_idx++)
+    {
+        unsigned int                    hid_detector_idx = entry.wrapped_detectors[match_idx];
+        HIDWrappedDeviceDetectorBlock & detector         = hid_wrapped_device_detectors[hid_detector_idx];
+        std::string                     claim            = DetectionCache::HIDClaim(detector.name, entry.info);
+
+        if(detector_wanted(detector.name, claim))
+        {
+            detection_string = detector.name.c_str();
+            DetectionProgressChanged();
+
+            unsigned int found = DetectionProfiler::GetFoundCount();
+
+            SetDetectionOrder(DETECTION_ORDER_HID, entry.position, (unsigned int)hid_device_detectors.size() + hid_detector_idx, claim, entry.info->path);
+            DetectionProfileScope profile(detection_profiler, detector.name, true);
+            detector.function(default_wrapper, entry.info, detector.name);
+
+            /*-----------------------------------------*\
+            | The libusb pass skips this detector for   |
+            | the same interface                        |
+            \*-----------------------------------------*/
+            if(DetectionProfiler::GetFoundCount() != found)
+            {
+                entry.wrapped_found.push_back(hid_detector_idx);
+            }
+        }
+    }
+}
+
+#ifdef __linux__
+void ResourceManager::StartHotplugListener()
+{
+    json detector_settings = settings_manager->GetSettings("Detectors");
+    bool hotplug_detection = true;
+
+    if(detector_settings.contains("hotplug_detection"))
+    {
+        hotplug_detection = detector_settings["hotplug_detection"];
+    }
+
+    /*-------------------------------------------------*\
+    | Hotplug detection enumerates all HID devices, so  |
+    | it is not available in HID safe mode              |
+    \*-------------------------------------------------*/
+    if(detector_settings.contains("hid_safe_mode") && detector_settings["hid_safe_mode"])
+    {
+        hotplug_detection = false;
+    }
+
+    if(!hotplug_detection || hotplug_listener != nullptr)
+    {
+        return;
+    }
+
+    hotplug_listener = new HotplugListener("hidraw",
+                                           [this](const std::vector<std::string> & paths) { HotplugDeviceAdded(paths); },
+                                           [this](const std::string & path) { HotplugDeviceRemoved(path); });
+
+    if(!hotplug_listener->Start())
+    {
+        delete hotplug_listener;
+        hotplug_listener = nullptr;
+    }
+}
+#endif
+
+void ResourceManager::HotplugDeviceAdded(const std::vector<std::string> & paths)
+{
+    std::lock_guard<std::mutex> lock(DetectDeviceMutex);
+
+    /*-------------------------------------------------*\
+    | A full detection that is about to start will find |
+    | the device itself                                 |
+    \*-------------------------------------------------*/
+    if(!detection_enabled || detection_is_required.load())
+    {
+        return;
+    }
+
+    /*-------------------------------------------------*\
+    | The listener reports all nodes of a device at     |
+    | once, after its interfaces have settled.  Nodes   |
+    | that already have a controller are skipped        |
+    \*-------------------------------------------------*/
+    std::set<std::string> new_paths(paths.begin(), paths.end());
+
+    for(std::size_t hid_controller_idx = 0; hid_controller_idx < hid_controller_paths.size(); hid_controller_idx++)
+    {
+        new_paths.erase(hid_controller_paths[hid_controller_idx].path);
+    }
+
+    if(new_paths.empty())
+    {
+        return;
+    }
+
+    for(const std::string & path : new_paths)
+    {
+        LOG_INFO("[ResourceManager] Running HID detectors for hotplugged device %s", path.c_str());
+    }
+
+    json                             detector_settings   = settings_manager->GetSettings("Detectors");
+    hid_device_info*                 hid_devices         = hid_enumerate(0, 0);
+    std::vector<HIDDeviceTableEntry> hid_table;
+
+    BuildHIDDeviceTable(hid_devices, NULL, hid_table);
+
+    /*-------------------------------------------------*\
+    | Only the interfaces of the new device nodes are   |
+    | passed to the detectors matching their IDs.  The  |
+    | found controllers go through the detected list so |
+    | their HID path is recorded for removal            |
+    \*-------------------------------------------------*/
+    detection_task_active = true;
+
+    for(std::size_t entry_idx = 0; entry_idx < hid_table.size(); entry_idx++)
+    {
+        if(hid_table[entry_idx].info->path == NULL || new_paths.count(hid_table[entry_idx].info->path) == 0)
+        {
+            continue;
+        }
+
+        RunHIDDeviceDetectors(hid_table[entry_idx], [&detector_settings](const std::string & name, const std::string & /*claim*/)
+        {
+            return(IsDetectorEnabled(detector_settings, name.c_str()));
+        });
+    }
+
+    detection_task_active = false;
+
+    hid_free_enumeration(hid_devices);
+
+    RegisterDetectedControllers(DETECTION_ORDER_HID);
+
+    detection_string = "";
+}
+
+void ResourceManager::HotplugDeviceRemoved(const std::string & path)
+{
+    std::lock_guard<std::mutex> lock(DetectDeviceMutex);
+
+    std::vector<RGBController*> removed_controllers;
+
+    for(std::size_t hid_controller_idx = 0; hid_controller_idx < hid_controller_paths.size();)
+    {
+        if(hid_controller_paths[hid_controller_idx].path == path)
+        {
+            removed_controllers.push_back(hid_controller_paths[hid_controller_idx].controller);
+            hid_controller_paths.erase(hid_controller_paths.begin() + hid_controller_idx);
+        }
+        else
+        {
+            hid_controller_idx++;
+        }
+    }
+
+    for(RGBController* rgb_controller : removed_controllers)
+    {
+        UnregisterRGBController(rgb_controller);
+
+        delete rgb_controller;
+    }
+
+    detection_prev_size = (unsigned int)rgb_controllers_hw.size();
+}
+
+void ResourceManager::RemoveMissingRetainedControllers(hid_device_info* hid_devices)
+{
+    /*-------------------------------------------------*\
+    | Safe mode does not enumerate all devices up front |
+    \*-------------------------------------------------*/
+    hid_device_info*            present_devices = (hid_devices != NULL) ? hid_devices : hid_enumerate(0, 0);
+    std::vector<RGBController*> removed_controllers;
+
+    for(std::size_t hid_controller_idx = 0; hid_controller_idx < hid_controller_paths.size();)
+    {
+        if(!HIDControllerPresent(hid_controller_paths[hid_controller_idx], present_devices))
+        {
+            retained_hid_paths.erase(hid_controller_paths[hid_controller_idx].path);
+            removed_controllers.push_back(hid_controller_paths[hid_controller_idx].controller);
+            hid_controller_paths.erase(hid_controller_paths.begin() + hid_controller_idx);
+        }
+        else
+        {
+            hid_controller_idx++;
+        }
+    }
+
+    if(hid_devices == NULL)
+    {
+        hid_free_enumeration(present_devices);
+    }
+
+    for(RGBController* rgb_controller : removed_controllers)
+    {
+        UnregisterRGBController(rgb_controller);
+
+        delete rgb_controller;
+    }
+
+    detection_prev_size = (unsigned int)rgb_controllers_hw.size();
+}
+
+void ResourceManager::RestoreControllerOrder()
+{
+    retained_hid_paths.clear();
+
+    if(previous_controller_identities.empty())
+    {
+        return;
+    }
+
+    /*-------------------------------------------------*\
+    | Each previous position is used once, in order, so |
+    | identical devices keep their relative order.  New |
+    | devices go to the end in detection order          |
+    \*-------------------------------------------------*/
+    std::map<std::string, std::vector<std::size_t>>     previous_positions;
+    std::vector<std::pair<std::size_t, RGBController*>> ranked_controllers;
+
+    for(std::size_t previous_idx = previous_controller_identities.size(); previous_idx > 0; previous_idx--)
+    {
+        previous_positions[previous_controller_identities[previous_idx - 1]].push_back(previous_idx - 1);
+    }
+
+    for(std::size_t hw_controller_idx = 0; hw_controller_idx < rgb_controllers_hw.size(); hw_controller_idx++)
+    {
+        std::vector<std::size_t> & positions = previous_positions[ControllerIdentity(rgb_controllers_hw[hw_controller_idx])];
+        std::size_t                rank      = previous_controller_identities.size() + hw_controller_idx;
+
+        if(!positions.empty())
+        {
+            rank = positions.back();
+            positions.pop_back();
+        }
+
+        ranked_controllers.push_back(std::make_pair(rank, rgb_controllers_hw[hw_controller_idx]));
+    }
+
+    previous_controller_identities.clear();
+
+    std::stable_sort(ranked_controllers.begin(), ranked_controllers.end(), [](const std::pair<std::size_t, RGBController*> & a, const std::pair<std::size_t, RGBController*> & b)
+    {
+        return(a.first < b.first);
+    });
+
+    bool order_changed = false;
+
+    for(std::size_t hw_controller_idx = 0; hw_controller_idx < rgb_controllers_hw.size(); hw_controller_idx++)
+    {
+        if(rgb_controllers_hw[hw_controller_idx] != ranked_controllers[hw_controller_idx].second)
+        {
+            rgb_controllers_hw[hw_controller_idx] = ranked_controllers[hw_controller_idx].second;
+            order_changed = true;
+        }
+    }
+
+    if(order_changed)
+    {
+        UpdateDeviceList();
+    }
+}
+
+void ResourceManager::QueueControllerInitialization(RGBController* rgb_controller)
+{
+    DetectionSizesMutex.lock();
+    deferred_controllers.insert(rgb_controller);
+    DetectionSizesMutex.unlock();
+
+    InitializeControllersMutex.lock();
+
+    uninitialized_controllers.push_back(rgb_controller);
+
+    if(InitializeControllersThread == nullptr)
+    {
+        initialize_controllers_running  = true;
+        InitializeControllersThread     = new std::thread(&ResourceManager::InitializeControllersThreadFunction, this);
+    }
+
+    InitializeControllersMutex.unlock();
+
+    InitializeControllersCV.notify_all();
+}
+
+void ResourceManager::CancelControllerInitialization(RGBController* rgb_controller)
+{
+    /*-------------------------------------------------*\
+    | Taking the run mutex waits for a controller that  |
+    | is being initialized.  A null controller cancels  |
+    | all pending initializations                       |
+    \*-------------------------------------------------*/
+    InitializeControllersRunMutex.lock();
+    InitializeControllersMutex.lock();
+
+    for(std::size_t controller_idx = 0; controller_idx < uninitialized_controllers.size();)
+    {
+        if(rgb_controller == NULL || uninitialized_controllers[controller_idx] == rgb_controller)
+        {
+            uninitialized_controllers.erase(uninitialized_controllers.begin() + controller_idx);
+        }
+        else
+        {
+            controller_idx++;
+        }
+    }
+
+    InitializeControllersMutex.unlock();
+    InitializeControllersRunMutex.unlock();
+
+    DetectionSizesMutex.lock();
+
+    if(rgb_controller == NULL)
+    {
+        deferred_controllers.clear();
+    }
+    else
+    {
+        deferred_controllers.erase(rgb_controller);
+    }
+
+    DetectionSizesMutex.unlock();
+
+    InitializeControllersCV.notify_all();
+}
+
+void ResourceManager::WaitForControllerInitialization()
+{
+    std::unique_lock<std::mutex> queue_lock(InitializeControllersMutex);
+
+    InitializeControllersCV.wait(queue_lock, [this]{ return(uninitialized_controllers.empty()); });
+
+    queue_lock.unlock();
+
+    /*-------------------------------------------------*\
+    | Wait for the last controller taken off the queue  |
+    \*-------------------------------------------------*/
+    InitializeControllersRunMutex.lock();
+    InitializeControllersRunMutex.unlock();
+}
+
+void ResourceManager::InitializeControllersThreadFunction()
+{
+    while(initialize_controllers_running.load())
+    {
+        std::unique_lock<std::mutex> queue_lock(InitializeControllersMutex);
+
+        InitializeControllersCV.wait(queue_lock, [this]{ return(!initialize_controllers_running.load() || !uninitialized_controllers.empty()); });
+
+        if(!initialize_controllers_running.load())
+        {
+            break;
+        }
+
+        /*-------------------------------------------------*\
+        | The run mutex is taken before the queue mutex, as |
+        | in CancelControllerInitialization                 |
+        \*-------------------------------------------------*/
+        queue_lock.unlock();
+
+        std::lock_guard<std::mutex> run_lock(InitializeControllersRunMutex);
+
+        queue_lock.lock();
+
+        if(uninitialized_controllers.empty())
+        {
+            continue;
+        }
+
+        RGBController* rgb_controller = uninitialized_controllers.front();
+        uninitialized_controllers.erase(uninitialized_controllers.begin());
+
+        queue_lock.unlock();
+
+        LOG_DEBUG("[%s] Running deferred initialization", rgb_controller->name.c_str());
+
+        rgb_controller->Initialize();
+
+        DetectionSizesMutex.lock();
+        profile_manager->LoadDeviceFromListWithOptions(rgb_controllers_sizes, detection_size_entry_used, rgb_controller, true, false);
+        DetectionSizesMutex.unlock();
+
+        LOG_INFO("[%s] Initialized %d zones and %d LEDs", rgb_controller->name.c_str(), (int)rgb_controller->zones.size(), (int)rgb_controller->leds.size());
+
+        /*-------------------------------------------------*\
+        | The controller is fully populated now, add it to  |
+        | the device list and have the GUI and SDK clients  |
+        | read it again                                     |
+        \*-------------------------------------------------*/
+        UpdateDeviceList();
+
+        InitializeControllersCV.notify_all();
+    }
+}
+
+void ResourceManager::DetectDevicesThreadFunction()
+{
+    DetectDeviceMutex.lock();
+
+    json                detector_settings;
+    hid_device_info*    hid_devices         = NULL;
+    hid_device_info*    libusb_devices      = NULL;
+    bool                hid_safe_mode       = false;
+    bool                parallel_detection  = true;
+    bool                warm                = detection_warm;
+
+    detection_warm = false;
+
+    LOG_INFO("------------------------------------------------------");
+    LOG_INFO("|               Start device detection               |");
+    if (warm)
+    LOG_INFO("|        using the previous detection results        |");
+    LOG_INFO("------------------------------------------------------");
+
+    /*-------------------------------------------------*\
+    | Reset the size entry used flags vector            |
+    \*-------------------------------------------------*/
+    detection_size_entry_used.resize(rgb_controllers_sizes.size());
+
+    for(std::size_t size_idx = 0; size_idx < (unsigned int)detection_size_entry_used.size(); size_idx++)
+    {
+        detection_size_entry_used[size_idx] = false;
+    }
+
+    /*-------------------------------------------------*\
+    | Open device disable list and read in disabled     |
+    | device strings                                    |
+    \*-------------------------------------------------*/
+    detector_settings = settings_manager->GetSettings("Detectors");
+
+    /*-------------------------------------------------*\
+    | Check HID safe mode setting                       |
+    \*-------------------------------------------------*/
+    if(detector_settings.contains("hid_safe_mode"))
+    {
+        hid_safe_mode = detector_settings["hid_safe_mode"];
+    }
+
+    /*-------------------------------------------------*\
+    | Check parallel detection setting.  When disabled  |
+    | all detection tasks run one after another on this |
+    | thread                                            |
+    \*-------------------------------------------------*/
+    if(detector_settings.contains("parallel_detection"))
+    {
+        parallel_detection = detector_settings["parallel_detection"];
+    }
+
+    /*-------------------------------------------------*\
+    | Check deferred initialization setting.  When      |
+    | disabled controllers are fully initialized before |
+    | they are registered                               |
+    \*-------------------------------------------------*/
+    deferred_initialization = true;
+
+    if(detector_settings.contains("deferred_initialization"))
+    {
+        deferred_initialization = detector_settings["deferred_initialization"];
+    }
+
+    /*-------------------------------------------------*\
+    | Check detection profile setting                   |
+    \*-------------------------------------------------*/
+    detection_profiler->Clear();
+    detection_profiler->SetEnabled(IsDetectionProfileEnabled(detector_settings, detection_profile));
+
+    /*-------------------------------------------------*\
+    | Check SMBus trace setting.  The busses are not    |
+    | registered yet, so the trace can be opened or     |
+    | closed here.  An open trace stays open across     |
+    | rescans                                           |
+    \*-------------------------------------------------*/
+    json smbus_trace_settings = settings_manager->GetSettings("SMBusTrace");
+
+    if(smbus_trace_settings.value("enabled", false))
+    {
+        if(!smbus_tracer->is_open())
+        {
+            filesystem::path trace_path = GetConfigurationDirectory() / "SMBusTrace.bin";
+
+            if(smbus_tracer->open(trace_path.generic_u8string(), smbus_trace_settings.value("records", 65536u)))
+            {
+                LOG_INFO("[ResourceManager] Recording SMBus transactions to %s", trace_path.generic_u8string().c_str());
+            }
+            else
+            {
+                LOG_WARNING("[ResourceManager] Cannot open SMBus trace %s", trace_path.generic_u8string().c_str());
+            }
+        }
+    }
+    else
+    {
+        smbus_tracer->close();
+    }
+
+#ifdef __linux__
+#ifdef __GLIBC__
+    /*-------------------------------------------------*\
+    | Load the libhidapi-libusb library and enumerate   |
+    | its devices.  libusb may detach and reattach the  |
+    | kernel driver while reading report descriptors,   |
+    | which renumbers hidraw nodes, so this is done     |
+    | before the hidapi enumeration.  Skipped in warm   |
+    | mode, the confirming full detection covers libusb |
+    | devices                                           |
+    \*-------------------------------------------------*/
+    void *         dyn_handle = NULL;
+    hidapi_wrapper libusb_wrapper;
+
+    if(!warm && (dyn_handle = dlopen("libhidapi-libusb.so", RTLD_NOW | RTLD_NODELETE | RTLD_DEEPBIND)))
+    {
+        /*---------------------------------------------*\
+        | Create a wrapper with the libusb functions    |
+        \*---------------------------------------------*/
+        libusb_wrapper =
+        {
+            .dyn_handle                     = dyn_handle,
+            .hid_send_feature_report        = (hidapi_wrapper_send_feature_report)          dlsym(dyn_handle,"hid_send_feature_report"),
+            .hid_get_feature_report         = (hidapi_wrapper_get_feature_report)           dlsym(dyn_handle,"hid_get_feature_report"),
+            .hid_get_serial_number_string   = (hidapi_wrapper_get_serial_number_string)     dlsym(dyn_handle,"hid_get_serial_number_string"),
+            .hid_open_path                  = (hidapi_wrapper_open_path)                    dlsym(dyn_handle,"hid_open_path"),
+            .hid_enumerate                  = (hidapi_wrapper_enumerate)                    dlsym(dyn_handle,"hid_enumerate"),
+            .hid_free_enumeration           = (hidapi_wrapper_free_enumeration)             dlsym(dyn_handle,"hid_free_enumeration"),
+            .hid_close                      = (hidapi_wrapper_close)                        dlsym(dyn_handle,"hid_close"),
+            .hid_error                      = (hidapi_wrapper_error)                        dlsym(dyn_handle,"hid_free_enumeration")
+        };
+
+        libusb_devices = libusb_wrapper.hid_enumerate(0, 0);
+    }
+#endif
+#endif
+
+    /*-------------------------------------------------*\
+    | Enumerate HID devices                             |
+    \*-------------------------------------------------*/
+    if(!hid_safe_mode)
+    {
+        hid_devices = hid_enumerate(0, 0);
+    }
+
+    /*-------------------------------------------------*\
+    | Remove kept controllers whose device is gone      |
+    \*-------------------------------------------------*/
+    if(!retained_hid_paths.empty())
+    {
+        RemoveMissingRetainedControllers(hid_devices);
+    }
+
+    /*-------------------------------------------------*\
+    | Start at 0% detection progress                    |
+    \*-------------------------------------------------*/
+    detection_percent = 0;
+
+#ifdef __linux__
+    /*-------------------------------------------------*\
+    | Check if the udev rules exist                     |
+    \*-------------------------------------------------*/
+    bool udev_not_exist     = false;
+    bool udev_multiple      = false;
+
+    if(access("/etc/udev/rules.d/60-openrgb.rules", F_OK) != 0)
+    {
+        if(access("/usr/lib/udev/rules.d/60-openrgb.rules", F_OK) != 0)
+        {
+            udev_not_exist  = true;
+        }
+    }
+    else
+    {
+        if(access("/usr/lib/udev/rules.d/60-openrgb.rules", F_OK) == 0)
+        {
+            udev_multiple   = true;
+        }
+    }
+#endif
+
+    /*-------------------------------------------------*\
+    | Detect i2c interfaces                             |
+    \*-------------------------------------------------*/
+    LOG_INFO("------------------------------------------------------");
+    LOG_INFO("|             Detecting I2C interfaces               |");
+    LOG_INFO("------------------------------------------------------");
+
+    bool i2c_interface_fail = false;
+
+    for(unsigned int i2c_bus_detector_idx = 0; i2c_bus_detector_idx < (unsigned int)i2c_bus_detectors.size() && detection_is_required.load(); i2c_bus_detector_idx++)
+    {
+        if(i2c_bus_detectors[i2c_bus_detector_idx]() == false)
+        {
+            i2c_interface_fail = true;
+        }
+
+        I2CBusListChanged();
+    }
+
+    /*-------------------------------------------------*\
+    | Detect I2C, HID and other devices                 |
+    |                                                   |
+    | Detection is split into independent tasks that    |
+    | run on a pool of worker threads:                  |
+    |   - One task per I2C bus, running the I2C device, |
+    |     DIMM and PCI detectors for that bus in order  |
+    |     so each bus is only used by one thread        |
+    |   - One task per HID vendor ID                    |
+    |   - One task per network detector                 |
+    |   - One task for all other detectors              |
+    |                                                   |
+    | Controllers registered by the tasks are held back |
+    | and registered in the serial detection order once |
+    | all tasks are done                                |
+    \*-------------------------------------------------*/
+    LOG_INFO("------------------------------------------------------");
+    LOG_INFO("|        Detecting I2C, HID and other devices        |");
+    if (hid_safe_mode)
+    LOG_INFO("|                with HID safe mode                  |");
+    LOG_INFO("------------------------------------------------------");
+
+    std::vector<DetectionTask> detection_tasks;
+
+    /*-------------------------------------------------*\
+    | In warm mode only the detectors that found a      |
+    | device in the cached detection run, as long as    |
+    | the part of the fingerprint they depend on is     |
+    | unchanged.  A full detection starts a new cache   |
+    \*-------------------------------------------------*/
+    bool warm_i2c = warm && detection_cache->MatchBusses(busses);
+
+    if(warm && !warm_i2c)
+    {
+        LOG_INFO("[ResourceManager] I2C busses changed since the cached detection, running all I2C detectors");
+    }
+
+    /*-------------------------------------------------*\
+    | Check SPD cache setting.  The DIMM phase of the   |
+    | bus tasks takes the JEDEC IDs from the SPD cache  |
+    | when the SPD checksum is unchanged                |
+    \*-------------------------------------------------*/
+    bool use_spd_cache = true;
+
+    if(detector_settings.contains("spd_cache"))
+    {
+        use_spd_cache = detector_settings["spd_cache"];
+    }
+
+    if(use_spd_cache)
+    {
+        spd_cache->Load(GetConfigurationDirectory() / "SPDCache.json");
+    }
+
+    if(!warm)
+    {
+        detection_cache->Clear();
+        detection_cache->SetBusses(busses);
 
-        detection_percent = (unsigned int)(percent * 100.0f);
+        /*---------------------------------------------*\
+        | Kept controllers are not detected again, keep |
+        | their claims                                  |
+        \*---------------------------------------------*/
+        for(std::size_t hid_controller_idx = 0; hid_controller_idx < hid_controller_paths.size(); hid_controller_idx++)
+        {
+            detection_cache->AddClaim(hid_controller_paths[hid_controller_idx].claim);
+        }
     }
 
+    std::function<bool(bool, const std::string &)> detector_wanted = [this](bool use_cache, const std::string & claim)
+    {
+        return(!use_cache || detection_cache->HasClaim(claim));
+    };
+
     /*-------------------------------------------------*\
-    | Detect i2c DIMM modules                           |
+    | I2C bus tasks                                     |
     \*-------------------------------------------------*/
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|            Detecting I2C DIMM modules              |");
-    LOG_INFO("------------------------------------------------------");
     for(unsigned int bus = 0; bus < busses.size(); bus++)
     {
-        IF_DRAM_SMBUS(busses[bus]->pci_vendor, busses[bus]->pci_device)
+        DetectionTask task;
+
+        task.units      = (unsigned int)(i2c_device_detectors.size() + i2c_dimm_device_detectors.size() + i2c_pci_device_detectors.size());
+        task.function   = [this, bus, &detector_settings, warm, warm_i2c, use_spd_cache, detector_wanted]()
         {
-            std::vector<SPDWrapper> slots;
-            SPDMemoryType dimm_type = SPD_RESERVED;
+            std::vector<i2c_smbus_interface*> bus_list(1, busses[bus]);
 
-            for(uint8_t spd_addr = 0x50; spd_addr < 0x58; spd_addr++)
+            /*---------------------------------------------*\
+            | I2C device detectors                          |
+            \*---------------------------------------------*/
+            for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < (unsigned int)i2c_device_detectors.size() && detection_is_required.load(); i2c_detector_idx++)
             {
-                SPDDetector spd(busses[bus], spd_addr, dimm_type);
-                if(spd.is_valid())
+                const char* detector_name = i2c_device_detector_strings[i2c_detector_idx].c_str();
+                std::string claim         = DetectionCache::BusClaim(DETECTION_CLAIM_I2C, detector_name, bus);
+
+                if(detector_wanted(warm_i2c, claim) && IsDetectorEnabled(detector_settings, detector_name))
                 {
-                    SPDWrapper accessor(spd);
-                    dimm_type = spd.memory_type();
-                    LOG_INFO("Detected occupied slot %d, bus %d, type %s", spd_addr - 0x50 + 1, bus, spd_memory_type_name[dimm_type]);
-                    LOG_DEBUG("Jedec ID: 0x%04x", accessor.jedec_id());
-                    slots.push_back(accessor);
+                    LOG_DEBUG("[%s] detecting on bus %d", detector_name, bus);
+
+                    detection_string = detector_name;
+                    DetectionProgressChanged();
+
+                    SetDetectionOrder(DETECTION_ORDER_I2C, i2c_detector_idx, bus, claim);
+                    DetectionProfileScope profile(detection_profiler, i2c_device_detector_strings[i2c_detector_idx], false);
+                    i2c_device_detectors[i2c_detector_idx](bus_list);
                 }
+
+                DetectionUnitsDone(1);
             }
 
-            for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < i2c_dimm_device_detectors.size() && detection_is_required.load(); i2c_detector_idx++)
+            /*---------------------------------------------*\
+            | I2C DIMM detectors                            |
+            \*---------------------------------------------*/
+            IF_DRAM_SMBUS(busses[bus]->pci_vendor, busses[bus]->pci_device)
             {
-                if(i2c_dimm_device_detectors[i2c_detector_idx].dimm_type == dimm_type &&
-                   is_jedec_in_slots(slots, i2c_dimm_device_detectors[i2c_detector_idx].jedec_id))
-                {
-                    detection_string = i2c_dimm_device_detectors[i2c_detector_idx].name.c_str();
+                std::vector<SPDWrapper> slots;
+                std::vector<uint16_t>   jedec_ids;
+                SPDMemoryType dimm_type = SPD_RESERVED;
 
-                    /*-------------------------------------------------*\
-                    | Check if this detector is enabled                 |
-                    \*-------------------------------------------------*/
-                    bool this_device_enabled = true;
-                    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
+                for(uint8_t spd_addr = 0x50; spd_addr < 0x58; spd_addr++)
+                {
+                    SPDDetector spd(busses[bus], spd_addr, dimm_type);
+                    if(spd.is_valid())
                     {
-                        this_device_enabled = detector_settings["detectors"][detection_string];
+                        SPDWrapper accessor(spd);
+                        dimm_type = spd.memory_type();
+                        uint16_t jedec_id = use_spd_cache ? spd_cache->GetJedecID(busses[bus], accessor) : accessor.jedec_id();
+                        LOG_INFO("Detected occupied slot %d, bus %d, type %s", spd_addr - 0x50 + 1, bus, spd_memory_type_name[dimm_type]);
+                        LOG_DEBUG("Jedec ID: 0x%04x", jedec_id);
+                        slots.push_back(accessor);
+                        jedec_ids.push_back(jedec_id);
                     }
+                }
 
-                    LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
-                    if(this_device_enabled)
-                    {
-                        DetectionProgressChanged();
-
-                        std::vector<SPDWrapper*> matching_slots = slots_with_jedec(slots, i2c_dimm_device_detectors[i2c_detector_idx].jedec_id);
-                        i2c_dimm_device_detectors[i2c_detector_idx].function(busses[bus], matching_slots);
-                    }
+                /*-----------------------------------------*\
+                | Changed modules invalidate the cached     |
+                | DIMM results for this bus                 |
+                \*-----------------------------------------*/
+                bool warm_dimm = warm_i2c && detection_cache->MatchSPDJedecIDs(bus, jedec_ids);
 
-                    LOG_TRACE("[%s] detection end", detection_string);
+                if(!warm)
+                {
+                    detection_cache->SetSPDJedecIDs(bus, jedec_ids);
                 }
 
-                /*-------------------------------------------------*\
-                | Update detection percent                          |
-                \*-------------------------------------------------*/
-                percent = ((float)i2c_detector_idx + 1.0f) / percent_denominator;
+                for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < i2c_dimm_device_detectors.size() && detection_is_required.load(); i2c_detector_idx++)
+                {
+                    if(i2c_dimm_device_detectors[i2c_detector_idx].dimm_type == dimm_type &&
+                       is_jedec_in_slots(slots, i2c_dimm_device_detectors[i2c_detector_idx].jedec_id))
+                    {
+                        const char* detector_name = i2c_dimm_device_detectors[i2c_detector_idx].name.c_str();
+                        std::string claim         = DetectionCache::BusClaim(DETECTION_CLAIM_I2C_DIMM, detector_name, bus);
 
-                detection_percent = (unsigned int)(percent * 100.0f);
-            }
-        }
-    }
+                        if(detector_wanted(warm_dimm, claim) && IsDetectorEnabled(detector_settings, detector_name))
+                        {
+                            detection_string = detector_name;
+                            DetectionProgressChanged();
 
-    /*-------------------------------------------------*\
-    | Detect i2c PCI devices                            |
-    \*-------------------------------------------------*/
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|               Detecting I2C PCI devices            |");
-    LOG_INFO("------------------------------------------------------");
-    for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < (unsigned int)i2c_pci_device_detectors.size() && detection_is_required.load(); i2c_detector_idx++)
-    {
-        detection_string = i2c_pci_device_detectors[i2c_detector_idx].name.c_str();
+                            std::vector<SPDWrapper*> matching_slots = slots_with_jedec(slots, i2c_dimm_device_detectors[i2c_detector_idx].jedec_id);
 
-        /*-------------------------------------------------*\
-        | Check if this detector is enabled                 |
-        \*-------------------------------------------------*/
-        bool this_device_enabled = true;
-        if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
-        {
-            this_device_enabled = detector_settings["detectors"][detection_string];
-        }
+                            SetDetectionOrder(DETECTION_ORDER_I2C_DIMM, bus, i2c_detector_idx, claim);
+                            DetectionProfileScope profile(detection_profiler, i2c_dimm_device_detectors[i2c_detector_idx].name, false);
+                            i2c_dimm_device_detectors[i2c_detector_idx].function(busses[bus], matching_slots);
+                        }
 
-        LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
-        if(this_device_enabled)
-        {
-            DetectionProgressChanged();
+                        LOG_TRACE("[%s] detection end", detector_name);
+                    }
+                }
+            }
 
-            for(unsigned int bus = 0; bus < busses.size(); bus++)
+            DetectionUnitsDone((unsigned int)i2c_dimm_device_detectors.size());
+
+            /*---------------------------------------------*\
+            | I2C PCI detectors                             |
+            \*---------------------------------------------*/
+            for(unsigned int i2c_detector_idx = 0; i2c_detector_idx < (unsigned int)i2c_pci_device_detectors.size() && detection_is_required.load(); i2c_detector_idx++)
             {
-                if(busses[bus]->pci_vendor           == i2c_pci_device_detectors[i2c_detector_idx].ven_id    &&
-                   busses[bus]->pci_device           == i2c_pci_device_detectors[i2c_detector_idx].dev_id    &&
-                   busses[bus]->pci_subsystem_vendor == i2c_pci_device_detectors[i2c_detector_idx].subven_id &&
-                   busses[bus]->pci_subsystem_device == i2c_pci_device_detectors[i2c_detector_idx].subdev_id)
+                I2CPCIDeviceDetectorBlock & detector = i2c_pci_device_detectors[i2c_detector_idx];
+                std::string                 claim    = DetectionCache::BusClaim(DETECTION_CLAIM_I2C_PCI, detector.name, bus);
+
+                if(busses[bus]->pci_vendor           == detector.ven_id    &&
+                   busses[bus]->pci_device           == detector.dev_id    &&
+                   busses[bus]->pci_subsystem_vendor == detector.subven_id &&
+                   busses[bus]->pci_subsystem_device == detector.subdev_id &&
+                   detector_wanted(warm_i2c, claim)                        &&
+                   IsDetectorEnabled(detector_settings, detector.name.c_str()))
                 {
-                    i2c_pci_device_detectors[i2c_detector_idx].function(busses[bus], i2c_pci_device_detectors[i2c_detector_idx].i2c_addr, i2c_pci_device_detectors[i2c_detector_idx].name);
-                }
-            }
-        }
+                    detection_string = detector.name.c_str();
+                    DetectionProgressChanged();
 
-        LOG_TRACE("[%s] detection end", detection_string);
+                    SetDetectionOrder(DETECTION_ORDER_I2C_PCI, i2c_detector_idx, bus, claim);
+                    DetectionProfileScope profile(detection_profiler, detector.name, false);
+                    detector.function(busses[bus], detector.i2c_addr, detector.name);
 
-        /*-------------------------------------------------*\
-        | Update detection percent                          |
-        \*-------------------------------------------------*/
-        percent = (i2c_device_detectors.size() + i2c_detector_idx + 1.0f) / percent_denominator;
+                    LOG_TRACE("[%s] detection end", detector.name.c_str());
+                }
+
+                DetectionUnitsDone(1);
+            }
+        };
 
-        detection_percent = (unsigned int)(percent * 100.0f);
+        detection_tasks.push_back(task);
     }
 
     /*-------------------------------------------------*\
-    | Detect HID devices                                |
+    | HID tasks                                         |
     |                                                   |
-    | Reset current device pointer to first device      |
+    | Both backends are merged into one device table,   |
+    | which also matches the detectors of every entry   |
     \*-------------------------------------------------*/
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|               Detecting HID devices                |");
-    if (hid_safe_mode)
-    LOG_INFO("|                  with safe mode                    |");
-    LOG_INFO("------------------------------------------------------");
-    current_hid_device = hid_devices;
+    std::vector<HIDDeviceTableEntry> hid_table;
+
+    BuildHIDDeviceTable(hid_devices, libusb_devices, hid_table);
 
     if(hid_safe_mode)
     {
-        /*-----------------------------------------------------------------------------*\
-        | Loop through all available detectors.  If all required information matches,   |
-        | run the detector                                                              |
-        \*-----------------------------------------------------------------------------*/
-        for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
-        {
-            HIDDeviceDetectorBlock & detector = hid_device_detectors[hid_detector_idx];
-            hid_devices = hid_enumerate(detector.vid, detector.pid);
-
-            LOG_VERBOSE("Trying to run detector for [%s] (for %04x:%04x)", detector.name.c_str(), detector.vid, detector.pid);
-
-            current_hid_device = hid_devices;
+        /*---------------------------------------------*\
+        | Safe mode enumerates per detector, run it as  |
+        | a single task in detector order               |
+        \*---------------------------------------------*/
+        DetectionTask task;
 
-            while(current_hid_device)
+        task.units      = 1;
+        task.function   = [this, &detector_settings, warm, detector_wanted]()
+        {
+            for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
             {
+                HIDDeviceDetectorBlock & detector       = hid_device_detectors[hid_detector_idx];
+                hid_device_info*         safe_devices   = hid_enumerate(detector.vid, detector.pid);
+                unsigned int             device_idx     = 0;
 
-                if(detector.compare(current_hid_device))
-                {
-                    detection_string = detector.name.c_str();
+                LOG_VERBOSE("Trying to run detector for [%s] (for %04x:%04x)", detector.name.c_str(), detector.vid, detector.pid);
 
-                    /*-------------------------------------------------*\
-                    | Check if this detector is enabled or needs to be  |
-                    | added to the settings list                        |
-                    \*-------------------------------------------------*/
-                    bool this_device_enabled = true;
-                    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
+                for(hid_device_info* current = safe_devices; current; current = current->next, device_idx++)
+                {
+                    if(current->path != NULL && retained_hid_paths.count(current->path) > 0)
                     {
-                        this_device_enabled = detector_settings["detectors"][detection_string];
+                        continue;
                     }
 
-                    LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
+                    std::string claim = DetectionCache::HIDClaim(detector.name, current);
 
-                    if(this_device_enabled)
+                    if(detector.compare(current) && detector_wanted(warm, claim) && IsDetectorEnabled(detector_settings, detector.name.c_str()))
                     {
+                        detection_string = detector.name.c_str();
                         DetectionProgressChanged();
 
-                        detector.function(current_hid_device, hid_device_detectors[hid_detector_idx].name);
+                        SetDetectionOrder(DETECTION_ORDER_HID, hid_detector_idx, device_idx, claim, current->path);
+                        DetectionProfileScope profile(detection_profiler, detector.name, true);
+                        detector.function(current, detector.name);
 
-                        LOG_TRACE("[%s] detection end", detection_string);
+                        LOG_TRACE("[%s] detection end", detector.name.c_str());
                     }
                 }
 
-                current_hid_device = current_hid_device->next;
+                hid_free_enumeration(safe_devices);
             }
 
-            hid_free_enumeration(hid_devices);
-        }
+            DetectionUnitsDone(1);
+        };
+
+        detection_tasks.push_back(task);
     }
     else
     {
-        /*-------------------------------------------------*\
-        | Iterate through all devices in list and run       |
-        | detectors                                         |
-        \*-------------------------------------------------*/
-        hid_device_count = 0;
+        /*---------------------------------------------*\
+        | Group the enumerated interfaces by vendor ID. |
+        | Detectors of one vendor may share state or    |
+        | open sibling interfaces, so each vendor group |
+        | runs on a single thread in enumeration order  |
+        \*---------------------------------------------*/
+        std::vector<std::vector<std::size_t>>       hid_groups;
+        std::unordered_map<uint16_t, std::size_t>   hid_group_index;
 
-        while(current_hid_device)
+        for(std::size_t entry_idx = 0; entry_idx < hid_table.size(); entry_idx++)
         {
-            if(LogManager::get()->getLoglevel() >= LL_DEBUG)
+            HIDDeviceTableEntry & entry = hid_table[entry_idx];
+
+            /*-----------------------------------------*\
+            | Only hidapi interfaces with a matching    |
+            | detector need a task.  Interfaces of kept |
+            | controllers are skipped                   |
+            \*-----------------------------------------*/
+            if(entry.info == NULL || (entry.hid_detectors.empty() && entry.wrapped_detectors.empty()))
             {
-                const char* manu_name = StringUtils::wchar_to_char(current_hid_device->manufacturer_string);
-                const char* prod_name = StringUtils::wchar_to_char(current_hid_device->product_string);
-                LOG_DEBUG("[%04X:%04X U=%04X P=0x%04X I=%d] %-25s - %s", current_hid_device->vendor_id, current_hid_device->product_id, current_hid_device->usage, current_hid_device->usage_page, current_hid_device->interface_number, manu_name, prod_name);
+                continue;
             }
-            detection_string = "";
-            DetectionProgressChanged();
 
-            /*-----------------------------------------------------------------------------*\
-            | Loop through all available detectors.  If all required information matches,   |
-            | run the detector                                                              |
-            \*-----------------------------------------------------------------------------*/
-            for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
+            if(entry.info->path != NULL && retained_hid_paths.count(entry.info->path) > 0)
             {
-                HIDDeviceDetectorBlock & detector = hid_device_detectors[hid_detector_idx];
-                if(detector.compare(current_hid_device))
-                {
-                    detection_string = detector.name.c_str();
-
-                    /*-------------------------------------------------*\
-                    | Check if this detector is enabled or needs to be  |
-                    | added to the settings list                        |
-                    \*-------------------------------------------------*/
-                    bool this_device_enabled = true;
-                    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
-                    {
-                        this_device_enabled = detector_settings["detectors"][detection_string];
-                    }
+                continue;
+            }
 
-                    LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
+            std::unordered_map<uint16_t, std::size_t>::iterator group = hid_group_index.find(entry.info->vendor_id);
 
-                    if(this_device_enabled)
-                    {
-                        DetectionProgressChanged();
+            if(group == hid_group_index.end())
+            {
+                group = hid_group_index.emplace(entry.info->vendor_id, hid_groups.size()).first;
 
-                        detector.function(current_hid_device, hid_device_detectors[hid_detector_idx].name);
-                    }
-                }
+                hid_groups.emplace_back();
             }
 
-            /*-----------------------------------------------------------------------------*\
-            | Loop through all available wrapped HID detectors.  If all required            |
-            | information matches, run the detector                                         |
-            \*-----------------------------------------------------------------------------*/
-            for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_wrapped_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
-            {
-                HIDWrappedDeviceDetectorBlock & detector = hid_wrapped_device_detectors[hid_detector_idx];
-                if(detector.compare(current_hid_device))
-                {
-                    detection_string = detector.name.c_str();
+            hid_groups[group->second].push_back(entry_idx);
+        }
 
-                    /*-------------------------------------------------*\
-                    | Check if this detector is enabled or needs to be  |
-                    | added to the settings list                        |
-                    \*-------------------------------------------------*/
-                    bool this_device_enabled = true;
-                    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
-                    {
-                        this_device_enabled = detector_settings["detectors"][detection_string];
-                    }
+        for(std::size_t group_idx = 0; group_idx < hid_groups.size(); group_idx++)
+        {
+            DetectionTask task;
 
-                    LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
+            std::vector<std::size_t>        group_entries   = hid_groups[group_idx];
 
-                    if(this_device_enabled)
+            task.units      = (unsigned int)group_entries.size();
+            task.function   = [this, group_entries, &hid_table, &detector_settings, warm, detector_wanted]()
+            {
+                for(std::size_t group_entry_idx = 0; group_entry_idx < group_entries.size() && detection_is_required.load(); group_entry_idx++)
+                {
+                    RunHIDDeviceDetectors(hid_table[group_entries[group_entry_idx]], [&detector_settings, warm, detector_wanted](const std::string & name, const std::string & claim)
                     {
-                        DetectionProgressChanged();
+                        return(detector_wanted(warm, claim) && IsDetectorEnabled(detector_settings, name.c_str()));
+                    });
 
-                        detector.function(default_wrapper, current_hid_device, hid_wrapped_device_detectors[hid_detector_idx].name);
-                    }
+                    DetectionUnitsDone(1);
                 }
-            }
+            };
 
-            /*-------------------------------------------------*\
-            | Update detection percent                          |
-            \*-------------------------------------------------*/
-            hid_device_count++;
+            detection_tasks.push_back(task);
+        }
+    }
 
-            percent = (i2c_device_detectors.size() + i2c_pci_device_detectors.size() + hid_device_count) / percent_denominator;
+    /*-------------------------------------------------*\
+    | Network and other detector tasks                  |
+    \*-------------------------------------------------*/
+    std::function<void(unsigned int)> run_device_detector = [this, &detector_settings, warm, detector_wanted](unsigned int detector_idx)
+    {
+        const char* detector_name = device_detector_strings[detector_idx].c_str();
+        std::string claim         = DetectionCache::OtherClaim(detector_name);
 
-            detection_percent = (unsigned int)(percent * 100.0f);
+        if(detector_wanted(warm, claim) && IsDetectorEnabled(detector_settings, detector_name))
+        {
+            detection_string = detector_name;
+            DetectionProgressChanged();
 
-            /*-------------------------------------------------*\
-            | Move on to the next HID device                    |
-            \*-------------------------------------------------*/
-            current_hid_device = current_hid_device->next;
+            SetDetectionOrder(DETECTION_ORDER_OTHER, detector_idx, 0, claim);
+            DetectionProfileScope profile(detection_profiler, device_detector_strings[detector_idx], false);
+            device_detectors[detector_idx]();
         }
 
-        /*-------------------------------------------------*\
-        | Done using the device list, free it               |
-        \*-------------------------------------------------*/
-        hid_free_enumeration(hid_devices);
+        LOG_TRACE("[%s] detection end", detector_name);
+
+        DetectionUnitsDone(1);
+    };
+
+    std::vector<unsigned int> other_detectors;
+
+    for(unsigned int detector_idx = 0; detector_idx < (unsigned int)device_detectors.size(); detector_idx++)
+    {
+        if(device_detector_network[detector_idx])
+        {
+            DetectionTask task;
+
+            task.units      = 1;
+            task.function   = [run_device_detector, detector_idx]()
+            {
+                run_device_detector(detector_idx);
+            };
+
+            detection_tasks.push_back(task);
+        }
+        else
+        {
+            other_detectors.push_back(detector_idx);
+        }
+    }
+
+    if(!other_detectors.empty())
+    {
+        DetectionTask task;
+
+        task.units      = (unsigned int)other_detectors.size();
+        task.function   = [this, run_device_detector, other_detectors]()
+        {
+            for(std::size_t other_idx = 0; other_idx < other_detectors.size() && detection_is_required.load(); other_idx++)
+            {
+                run_device_detector(other_detectors[other_idx]);
+            }
+        };
+
+        detection_tasks.push_back(task);
     }
 
     /*-------------------------------------------------*\
-    | Detect HID devices                                |
+    | Run the tasks and register what they found up to  |
+    | and including HID devices.  Other devices are     |
+    | registered after the libusb HID pass below to     |
+    | keep the serial detection order                   |
+    \*-------------------------------------------------*/
+    RunDetectionTasks(detection_tasks, parallel_detection);
+
+    RegisterDetectedControllers(DETECTION_ORDER_HID);
+
+    /*-------------------------------------------------*\
+    | Detect libusb HID devices                         |
     |                                                   |
-    | Reset current device pointer to first device      |
+    | Runs after the parallel tasks as libusb may       |
+    | detach kernel drivers from devices that the HID   |
+    | tasks are using                                   |
     \*-------------------------------------------------*/
 #ifdef __linux__
 #ifdef __GLIBC__
@@ -1405,147 +2866,151 @@ void ResourceManager::DetectDevicesThreadFunction()
     LOG_INFO("|            Detecting libusb HID devices            |");
     LOG_INFO("------------------------------------------------------");
 
-    void *         dyn_handle = NULL;
-    hidapi_wrapper wrapper;
-
-    /*-------------------------------------------------*\
-    | Load the libhidapi-libusb library                 |
-    \*-------------------------------------------------*/
-#ifdef __GLIBC__
-    if((dyn_handle = dlopen("libhidapi-libusb.so", RTLD_NOW | RTLD_NODELETE | RTLD_DEEPBIND)))
-#else
-    if(dyn_handle = dlopen("libhidapi-libusb.so", RTLD_NOW | RTLD_NODELETE ))
-#endif
+    if(libusb_devices != NULL)
     {
         /*-------------------------------------------------*\
-        | Create a wrapper with the libusb functions        |
+        | A wrapped detector that found a controller on the |
+        | hidapi interface is not run on its libusb twin    |
         \*-------------------------------------------------*/
-        wrapper =
-        {
-            .dyn_handle                     = dyn_handle,
-            .hid_send_feature_report        = (hidapi_wrapper_send_feature_report)          dlsym(dyn_handle,"hid_send_feature_report"),
-            .hid_get_feature_report         = (hidapi_wrapper_get_feature_report)           dlsym(dyn_handle,"hid_get_feature_report"),
-            .hid_get_serial_number_string   = (hidapi_wrapper_get_serial_number_string)     dlsym(dyn_handle,"hid_get_serial_number_string"),
-            .hid_open_path                  = (hidapi_wrapper_open_path)                    dlsym(dyn_handle,"hid_open_path"),
-            .hid_enumerate                  = (hidapi_wrapper_enumerate)                    dlsym(dyn_handle,"hid_enumerate"),
-            .hid_free_enumeration           = (hidapi_wrapper_free_enumeration)             dlsym(dyn_handle,"hid_free_enumeration"),
-            .hid_close                      = (hidapi_wrapper_close)                        dlsym(dyn_handle,"hid_close"),
-            .hid_error                      = (hidapi_wrapper_error)                        dlsym(dyn_handle,"hid_free_enumeration")
-        };
+        std::set<std::pair<std::string, unsigned int>> hidapi_found;
 
-        hid_devices = wrapper.hid_enumerate(0, 0);
+        for(std::size_t entry_idx = 0; entry_idx < hid_table.size(); entry_idx++)
+        {
+            for(std::size_t found_idx = 0; hid_table[entry_idx].info != NULL && hid_table[entry_idx].info->path != NULL && found_idx < hid_table[entry_idx].wrapped_found.size(); found_idx++)
+            {
+                hidapi_found.insert(std::make_pair(std::string(hid_table[entry_idx].info->path), hid_table[entry_idx].wrapped_found[found_idx]));
+            }
+        }
 
-        current_hid_device = hid_devices;
+        for(std::size_t entry_idx = 0; entry_idx < hid_table.size() && detection_is_required.load(); entry_idx++)
+        {
+            HIDDeviceTableEntry & entry = hid_table[entry_idx];
 
-        /*-------------------------------------------------*\
-        | Iterate through all devices in list and run       |
-        | detectors                                         |
-        \*-------------------------------------------------*/
-        hid_device_count = 0;
+            if(entry.libusb_info == NULL)
+            {
+                continue;
+            }
 
-        while(current_hid_device)
-        {
-            if(LogManager::get()->getLoglevel() >= LL_DEBUG)
+            /*---------------------------------------------*\
+            | The twin of a kept controller's interface is  |
+            | not detected again                            |
+            \*---------------------------------------------*/
+            if(entry.info != NULL && entry.info->path != NULL && retained_hid_paths.count(entry.info->path) > 0)
             {
-                const char* manu_name = StringUtils::wchar_to_char(current_hid_device->manufacturer_string);
-                const char* prod_name = StringUtils::wchar_to_char(current_hid_device->product_string);
-                LOG_DEBUG("[%04X:%04X U=%04X P=0x%04X I=%d] %-25s - %s", current_hid_device->vendor_id, current_hid_device->product_id, current_hid_device->usage, current_hid_device->usage_page, current_hid_device->interface_number, manu_name, prod_name);
+                continue;
             }
+
             detection_string = "";
             DetectionProgressChanged();
 
-            /*-----------------------------------------------------------------------------*\
-            | Loop through all available wrapped HID detectors.  If all required            |
-            | information matches, run the detector                                         |
-            \*-----------------------------------------------------------------------------*/
-            for(unsigned int hid_detector_idx = 0; hid_detector_idx < (unsigned int)hid_wrapped_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
+            for(std::size_t match_idx = 0; match_idx < entry.libusb_detectors.size() && detection_is_required.load(); match_idx++)
             {
-                HIDWrappedDeviceDetectorBlock & detector = hid_wrapped_device_detectors[hid_detector_idx];
-                if(detector.compare(current_hid_device))
-                {
-                    detection_string = detector.name.c_str();
+                unsigned int                    hid_detector_idx = entry.libusb_detectors[match_idx];
+                HIDWrappedDeviceDetectorBlock & detector         = hid_wrapped_device_detectors[hid_detector_idx];
 
-                    /*-------------------------------------------------*\
-                    | Check if this detector is enabled or needs to be  |
-                    | added to the settings list                        |
-                    \*-------------------------------------------------*/
-                    bool this_device_enabled = true;
-                    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
-                    {
-                        this_device_enabled = detector_settings["detectors"][detection_string];
-                    }
-
-                    LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
+                if(entry.info != NULL && entry.info->path != NULL && hidapi_found.count(std::make_pair(std::string(entry.info->path), hid_detector_idx)) > 0)
+                {
+                    LOG_DEBUG("[%s] already found through hidapi, skipping libusb interface", detector.name.c_str());
+                    continue;
+                }
 
-                    if(this_device_enabled)
-                    {
-                        DetectionProgressChanged();
+                detection_string = detector.name.c_str();
 
-                        detector.function(wrapper, current_hid_device, detector.name);
-                    }
+                /*-------------------------------------------------*\
+                | Check if this detector is enabled or needs to be  |
+                | added to the settings list                        |
+                \*-------------------------------------------------*/
+                bool this_device_enabled = true;
+                if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detector.name))
+                {
+                    this_device_enabled = detector_settings["detectors"][detector.name];
                 }
-            }
 
-            /*-------------------------------------------------*\
-            | Update detection percent                          |
-            \*-------------------------------------------------*/
-            hid_device_count++;
+                LOG_DEBUG("[%s] is %s", detector.name.c_str(), ((this_device_enabled == true) ? "enabled" : "disabled"));
 
-            percent = (i2c_device_detectors.size() + i2c_pci_device_detectors.size() + hid_device_count) / percent_denominator;
-
-            detection_percent = percent * 100.0f;
+                if(this_device_enabled)
+                {
+                    DetectionProgressChanged();
 
-            /*-------------------------------------------------*\
-            | Move on to the next HID device                    |
-            \*-------------------------------------------------*/
-            current_hid_device = current_hid_device->next;
+                    DetectionProfileScope profile(detection_profiler, detector.name, true);
+                    detector.function(libusb_wrapper, entry.libusb_info, detector.name);
+                }
+            }
         }
 
         /*-------------------------------------------------*\
-        | Done using the device list, free it               |
+        | Done using the libusb device list, free it        |
         \*-------------------------------------------------*/
-        wrapper.hid_free_enumeration(hid_devices);
+        libusb_wrapper.hid_free_enumeration(libusb_devices);
     }
 #endif
 #endif
 
     /*-------------------------------------------------*\
-    | Detect other devices                              |
+    | Done using the device list, free it               |
     \*-------------------------------------------------*/
-    LOG_INFO("------------------------------------------------------");
-    LOG_INFO("|              Detecting other devices               |");
-    LOG_INFO("------------------------------------------------------");
+    hid_table.clear();
+    hid_free_enumeration(hid_devices);
+
+
+    /*-------------------------------------------------*\
+    | Register the controllers found by the network and |
+    | other detector tasks                              |
+    \*-------------------------------------------------*/
+    RegisterDetectedControllers(DETECTION_ORDER_OTHER);
+
+    /*-------------------------------------------------*\
+    | Put the devices found again by a rescan back in   |
+    | their previous order                              |
+    \*-------------------------------------------------*/
+    RestoreControllerOrder();
 
-    for(unsigned int detector_idx = 0; detector_idx < (unsigned int)device_detectors.size() && detection_is_required.load(); detector_idx++)
+    /*-------------------------------------------------*\
+    | Save the fingerprint of a completed full          |
+    | detection for the next start                      |
+    \*-------------------------------------------------*/
+    if(!warm && detection_is_required.load())
     {
-        detection_string = device_detector_strings[detector_idx].c_str();
+        detection_cache->Save(GetConfigurationDirectory() / "DetectionCache.json");
+    }
 
-        /*-------------------------------------------------*\
-        | Check if this detector is enabled                 |
-        \*-------------------------------------------------*/
-        bool this_device_enabled = true;
-        if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
-        {
-            this_device_enabled = detector_settings["detectors"][detection_string];
-        }
+    /*-------------------------------------------------*\
+    | Save the SPD contents of new or changed DIMMs     |
+    \*-------------------------------------------------*/
+    if(use_spd_cache)
+    {
+        spd_cache->Save(GetConfigurationDirectory() / "SPDCache.json");
+    }
 
-        LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
+    /*-------------------------------------------------*\
+    | Profiles are applied when detection ends, finish  |
+    | the deferred initializations first                |
+    \*-------------------------------------------------*/
+    WaitForControllerInitialization();
 
-        if(this_device_enabled)
-        {
-            DetectionProgressChanged();
+    /*-------------------------------------------------*\
+    | Report the time and bus activity of each detector |
+    \*-------------------------------------------------*/
+    if(detection_profiler->GetEnabled())
+    {
+        std::vector<std::string> profile_table = detection_profiler->GetTable();
 
-            device_detectors[detector_idx]();
-        }
+        LOG_INFO("------------------------------------------------------");
+        LOG_INFO("|                 Detection profile                  |");
+        LOG_INFO("------------------------------------------------------");
 
-        LOG_TRACE("[%s] detection end", detection_string);
+        for(std::size_t line_idx = 0; line_idx < profile_table.size(); line_idx++)
+        {
+            LOG_INFO("%s", profile_table[line_idx].c_str());
 
-        /*-------------------------------------------------*\
-        | Update detection percent                          |
-        \*-------------------------------------------------*/
-        percent = (i2c_device_detectors.size() + hid_device_count + detector_idx + 1.0f) / percent_denominator;
+            if(detection_profile)
+            {
+                printf("%s\n", profile_table[line_idx].c_str());
+            }
+        }
 
-        detection_percent = (unsigned int)(percent * 100.0f);
+        detection_profiler->Save(GetConfigurationDirectory() / "DetectionProfile.json");
+        detection_profiler->SetEnabled(false);
     }
 
     /*-------------------------------------------------*\
@@ -1620,6 +3085,11 @@ void ResourceManager::DetectDevicesThreadFunction()
     }
 }
 
+void ResourceManager::SetDetectionProfile(bool enabled)
+{
+    detection_profile = enabled;
+}
+
 void ResourceManager::StopDeviceDetection()
 {
     LOG_INFO("Detection abort requested");
@@ -1660,18 +3130,56 @@ void ResourceManager::InitThreadFunction()
         tryAutoConnect = false;
     }
 
+    /*---------------------------------------------------------*\
+    | Saved clients have been connecting in the background      |
+    | since startup, give the remaining ones until the shared   |
+    | deadline                                                  |
+    \*---------------------------------------------------------*/
+    WaitForNetworkClients();
+
     /*---------------------------------------------------------*\
     | Perform actual detection                                  |
     | Done in the same thread (InitThread), as we need to wait  |
     | for completion anyway                                     |
     \*---------------------------------------------------------*/
+    bool warm_detection = false;
+
     if(detection_enabled)
     {
         LOG_DEBUG("[ResourceManager] Running standalone");
         if(ProcessPreDetection())
         {
+            /*-------------------------------------------------*\
+            | Start from the cached detection results when the  |
+            | cache is enabled and no command line actions need |
+            | the complete device list.  Profiling needs every  |
+            | detector to run                                   |
+            \*-------------------------------------------------*/
+            json detector_settings = settings_manager->GetSettings("Detectors");
+            bool use_cache         = true;
+
+            if(detector_settings.contains("detection_cache"))
+            {
+                use_cache = detector_settings["detection_cache"];
+            }
+
+            if(use_cache && !apply_post_options && !IsDetectionProfileEnabled(detector_settings, detection_profile))
+            {
+                warm_detection = detection_cache->Load(GetConfigurationDirectory() / "DetectionCache.json");
+            }
+
+            detection_warm = warm_detection;
+
             DetectDevicesThreadFunction();
         }
+
+#ifdef __linux__
+        /*-------------------------------------------------*\
+        | From here on, detect hotplugged HID devices on    |
+        | their own instead of requiring a full rescan      |
+        \*-------------------------------------------------*/
+        StartHotplugListener();
+#endif
     }
     else
     {
@@ -1701,6 +3209,18 @@ void ResourceManager::InitThreadFunction()
     }
 
     init_finished = true;
+
+    /*---------------------------------------------------------*\
+    | A warm start only ran the previously successful detectors,|
+    | run a full detection in the background to pick up any     |
+    | hardware changes and refresh the cache                    |
+    \*---------------------------------------------------------*/
+    if(warm_detection)
+    {
+        LOG_INFO("[ResourceManager] Starting full detection to confirm cached results");
+
+        DetectDevices();
+    }
 }
 
 void ResourceManager::UpdateDetectorSettings()
@@ -1722,9 +3242,9 @@ void ResourceManager::UpdateDetectorSettings()
     {
         detection_string = i2c_device_detector_strings[i2c_detector_idx].c_str();
 
-        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string)))
+        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(i2c_device_detector_strings[i2c_detector_idx])))
         {
-            detector_settings["detectors"][detection_string] = true;
+            detector_settings["detectors"][i2c_device_detector_strings[i2c_detector_idx]] = true;
             save_settings = true;
         }
     }
@@ -1737,9 +3257,9 @@ void ResourceManager::UpdateDetectorSettings()
     {
         detection_string = i2c_pci_device_detectors[i2c_pci_detector_idx].name.c_str();
 
-        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string)))
+        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(i2c_pci_device_detectors[i2c_pci_detector_idx].name)))
         {
-            detector_settings["detectors"][detection_string] = true;
+            detector_settings["detectors"][i2c_pci_device_detectors[i2c_pci_detector_idx].name] = true;
             save_settings = true;
         }
     }
@@ -1752,9 +3272,9 @@ void ResourceManager::UpdateDetectorSettings()
     {
         detection_string = hid_device_detectors[hid_detector_idx].name.c_str();
 
-        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string)))
+        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(hid_device_detectors[hid_detector_idx].name)))
         {
-            detector_settings["detectors"][detection_string] = true;
+            detector_settings["detectors"][hid_device_detectors[hid_detector_idx].name] = true;
             save_settings = true;
         }
     }
@@ -1767,9 +3287,9 @@ void ResourceManager::UpdateDetectorSettings()
     {
         detection_string = hid_wrapped_device_detectors[hid_wrapped_detector_idx].name.c_str();
 
-        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string)))
+        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(hid_wrapped_device_detectors[hid_wrapped_detector_idx].name)))
         {
-            detector_settings["detectors"][detection_string] = true;
+            detector_settings["detectors"][hid_wrapped_device_detectors[hid_wrapped_detector_idx].name] = true;
             save_settings = true;
         }
     }
@@ -1782,9 +3302,9 @@ void ResourceManager::UpdateDetectorSettings()
     {
         detection_string = device_detector_strings[detector_idx].c_str();
 
-        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string)))
+        if(!(detector_settings.contains("detectors") && detector_settings["detectors"].contains(device_detector_strings[detector_idx])))
         {
-            detector_settings["detectors"][detection_string] = true;
+            detector_settings["detectors"][device_detector_strings[detector_idx]] = true;
             save_settings = true;
         }
     }
@@ -13,11 +13,15 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <set>
 #include <vector>
 #include <functional>
 #include <thread>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "SPDAccessor.h"
 #include "hidapi_wrapper.h"
@@ -30,7 +34,33 @@
 
 #define CONTROLLER_LIST_HID 0
 
+/*---------------------------------------------------------*\
+| Time allowed for all saved network clients together to    |
+| come online during initialization                         |
+\*---------------------------------------------------------*/
+#define NETWORK_CLIENT_CONNECT_TIMEOUT_MS   1000
+
+/*---------------------------------------------------------*\
+| Detection order groups, in the order the detection phases |
+| register their controllers                                |
+\*---------------------------------------------------------*/
+#define DETECTION_ORDER_I2C                 0
+#define DETECTION_ORDER_I2C_DIMM            1
+#define DETECTION_ORDER_I2C_PCI             2
+#define DETECTION_ORDER_HID                 3
+#define DETECTION_ORDER_OTHER               4
+
+/*---------------------------------------------------------*\
+| Maximum number of detection worker threads                |
+\*---------------------------------------------------------*/
+#define DETECTION_MAX_THREADS               16
+
 struct hid_device_info;
+class DetectionCache;
+class DetectionProfiler;
+class SPDCache;
+class i2c_smbus_tracer;
+class HotplugListener;
 class NetworkClient;
 class NetworkServer;
 class ProfileManager;
@@ -60,6 +90,15 @@ public:
     bool compare(hid_device_info* info);
 };
 
+/*---------------------------------------------------------*\
+| HID detector index, maps a packed (vid, pid) key to the   |
+| indices of all detectors registered for that device in    |
+| registration order                                        |
+\*---------------------------------------------------------*/
+typedef std::unordered_map<uint32_t, std::vector<unsigned int>>                             HIDDetectorIndex;
+
+#define HID_DETECTOR_INDEX_KEY(vid, pid)    (((uint32_t)(vid) << 16) | (uint16_t)(pid))
+
 class HIDDeviceDetectorBlock : public BasicHIDBlock
 {
 public:
@@ -91,6 +130,63 @@ typedef struct
     uint8_t                         dimm_type;
 } I2CDIMMDeviceDetectorBlock;
 
+/*---------------------------------------------------------*\
+| Detection task, one independent unit of detection work.   |
+| Units is the number of progress steps the task reports    |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    std::function<void()>           function;
+    unsigned int                    units;
+} DetectionTask;
+
+/*---------------------------------------------------------*\
+| Controller registered by a detection task, held back with |
+| its position in the serial detection order                |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    unsigned int                    order[3];
+    RGBController*                  controller;
+    std::string                     claim;
+    std::string                     hid_path;
+} DetectedRGBController;
+
+/*---------------------------------------------------------*\
+| Controller found by a HID detector, with the path of the  |
+| interface it was found on and its detection cache claim   |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    std::string                     path;
+    std::string                     claim;
+    RGBController*                  controller;
+} HIDControllerPath;
+
+/*---------------------------------------------------------*\
+| HID backends an interface was enumerated with             |
+\*---------------------------------------------------------*/
+#define HID_BACKEND_HIDAPI                  0x01
+#define HID_BACKEND_LIBUSB                  0x02
+
+/*---------------------------------------------------------*\
+| One HID interface of the unified device table.  An        |
+| interface enumerated by both backends is a single entry.  |
+| The matching detectors are looked up once, when the table |
+| is built                                                  |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    hid_device_info*                info;
+    hid_device_info*                libusb_info;
+    unsigned int                    backends;
+    unsigned int                    position;
+    std::vector<unsigned int>       hid_detectors;
+    std::vector<unsigned int>       wrapped_detectors;
+    std::vector<unsigned int>       libusb_detectors;
+    std::vector<unsigned int>       wrapped_found;
+} HIDDeviceTableEntry;
+
 typedef void (*DeviceListChangeCallback)(void *);
 typedef void (*DetectionProgressCallback)(void *);
 typedef void (*DetectionStartCallback)(void *);
@@ -146,14 +242,20 @@ public:
 
     void RegisterI2CBus(i2c_smbus_interface *);
     std::vector<i2c_smbus_interface*> & GetI2CBusses();
+    void InvalidateI2CRegisterCaches();
+    void CheckForResume();
 
     void RegisterRGBController(RGBController *rgb_controller);
     void UnregisterRGBController(RGBController *rgb_controller);
 
+    void RegisterClientControllers(std::vector<RGBController *> & client_controllers);
+    void UnregisterClientControllers(std::vector<RGBController *> & client_controllers);
+
     std::vector<RGBController*> & GetRGBControllers();
 
     void RegisterI2CBusDetector         (I2CBusDetectorFunction     detector);
     void RegisterDeviceDetector         (std::string name, DeviceDetectorFunction     detector);
+    void RegisterNetworkDeviceDetector  (std::string name, DeviceDetectorFunction     detector);
     void RegisterI2CDeviceDetector      (std::string name, I2CDeviceDetectorFunction  detector);
     void RegisterI2CDIMMDeviceDetector  (std::string name, I2CDIMMDeviceDetectorFunction detector, uint16_t jedec_id, uint8_t dimm_type);
     void RegisterI2CPCIDeviceDetector   (std::string name, I2CPCIDeviceDetectorFunction detector, uint16_t ven_id, uint16_t dev_id, uint16_t subven_id, uint16_t subdev_id, uint8_t i2c_addr);
@@ -197,6 +299,7 @@ public:
 
     std::vector<NetworkClient*>&    GetClients();
     NetworkServer*                  GetServer();
+    bool                            GetRelayMode();
 
     ProfileManager*                 GetProfileManager();
     SettingsManager*                GetSettingsManager();
@@ -212,7 +315,7 @@ public:
 
     void Initialize(bool tryConnect, bool detectDevices, bool startServer, bool applyPostOptions);
 
-    void Cleanup();
+    void Cleanup(bool retain_hid_controllers = false);
 
     void DetectDevices();
 
@@ -220,14 +323,35 @@ public:
 
     void StopDeviceDetection();
 
+    void SetDetectionProfile(bool enabled);
+
     void WaitForInitialization();
     void WaitForDeviceDetection();
 
 private:
     void DetectDevicesThreadFunction();
+    void BuildHIDDetectorIndex();
+    void RunDetectionTasks(std::vector<DetectionTask> & tasks, bool parallel);
+    void DetectionUnitsDone(unsigned int units);
+    void RegisterDetectedControllers(unsigned int last_order);
+    void BuildHIDDeviceTable(hid_device_info* hid_devices, hid_device_info* libusb_devices, std::vector<HIDDeviceTableEntry> & table);
+    void RunHIDDeviceDetectors(HIDDeviceTableEntry & entry, std::function<bool(const std::string &, const std::string &)> detector_wanted);
+#ifdef __linux__
+    void StartHotplugListener();
+#endif
+    void HotplugDeviceAdded(const std::vector<std::string> & paths);
+    void HotplugDeviceRemoved(const std::string & path);
+    void RemoveMissingRetainedControllers(hid_device_info* hid_devices);
+    void RestoreControllerOrder();
+    void LogI2CBusStats(i2c_smbus_interface* bus);
+    void QueueControllerInitialization(RGBController* rgb_controller);
+    void CancelControllerInitialization(RGBController* rgb_controller);
+    void WaitForControllerInitialization();
+    void InitializeControllersThreadFunction();
     void UpdateDetectorSettings();
     void SetupConfigurationDirectory();
     bool AttemptLocalConnection();
+    void WaitForNetworkClients();
     void InitThreadFunction();
     bool ProcessPreDetection();
     void ProcessPostDetection();
@@ -271,33 +395,65 @@ private:
     \*-------------------------------------------------------------------------------------*/
     SettingsManager*                            settings_manager;
 
+    /*-------------------------------------------------------------------------------------*\
+    | Detection Cache, fingerprint of the last full detection.  When warm is set the next   |
+    | detection only runs the detectors recorded in the cache                               |
+    \*-------------------------------------------------------------------------------------*/
+    DetectionCache*                             detection_cache;
+    bool                                        detection_warm;
+
+    /*-------------------------------------------------------------------------------------*\
+    | SPD Cache, decoded SPD contents of the detected DIMMs.  Saves the page switching SPD  |
+    | reads on later detections while the SPD checksum matches                              |
+    \*-------------------------------------------------------------------------------------*/
+    SPDCache*                                   spd_cache;
+
+    /*-------------------------------------------------------------------------------------*\
+    | Detection Profiler, per-detector time and bus activity.  Enabled by the               |
+    | detection_profile setting or the --detection-profile command line option, which also  |
+    | prints the result                                                                     |
+    \*-------------------------------------------------------------------------------------*/
+    DetectionProfiler*                          detection_profiler;
+    bool                                        detection_profile;
+
+    /*-------------------------------------------------------------------------------------*\
+    | SMBus Tracer, records the transactions of all I2C busses into SMBusTrace.bin in the   |
+    | configuration directory when the SMBusTrace setting is enabled                        |
+    \*-------------------------------------------------------------------------------------*/
+    i2c_smbus_tracer*                           smbus_tracer;
+
     /*-------------------------------------------------------------------------------------*\
     | I2C/SMBus Interfaces                                                                  |
     \*-------------------------------------------------------------------------------------*/
     std::vector<i2c_smbus_interface*>           busses;
+    long long                                   suspended_ms;
 
     /*-------------------------------------------------------------------------------------*\
     | RGBControllers                                                                        |
     \*-------------------------------------------------------------------------------------*/
     std::vector<RGBController*>                 rgb_controllers_sizes;
     std::vector<RGBController*>                 rgb_controllers_hw;
+    std::vector<RGBController*>                 rgb_controllers_hw_ready;
     std::vector<RGBController*>                 rgb_controllers;
 
     /*-------------------------------------------------------------------------------------*\
     | Network Server                                                                        |
     \*-------------------------------------------------------------------------------------*/
     NetworkServer*                              server;
+    bool                                        all_controllers;
 
     /*-------------------------------------------------------------------------------------*\
     | Network Clients                                                                       |
     \*-------------------------------------------------------------------------------------*/
     std::vector<NetworkClient*>                 clients;
+    std::chrono::steady_clock::time_point       clients_connect_deadline;
 
     /*-------------------------------------------------------------------------------------*\
     | Detectors                                                                             |
     \*-------------------------------------------------------------------------------------*/
     std::vector<DeviceDetectorFunction>         device_detectors;
     std::vector<std::string>                    device_detector_strings;
+    std::vector<bool>                           device_detector_network;
     std::vector<I2CBusDetectorFunction>         i2c_bus_detectors;
     std::vector<I2CDeviceDetectorFunction>      i2c_device_detectors;
     std::vector<std::string>                    i2c_device_detector_strings;
@@ -305,6 +461,10 @@ private:
     std::vector<I2CPCIDeviceDetectorBlock>      i2c_pci_device_detectors;
     std::vector<HIDDeviceDetectorBlock>         hid_device_detectors;
     std::vector<HIDWrappedDeviceDetectorBlock>  hid_wrapped_device_detectors;
+    HIDDetectorIndex                            hid_device_detector_index;
+    HIDDetectorIndex                            hid_wrapped_device_detector_index;
+    std::size_t                                 hid_detectors_indexed;
+    std::size_t                                 hid_wrapped_detectors_indexed;
     std::vector<DynamicDetectorFunction>        dynamic_detectors;
     std::vector<std::string>                    dynamic_detector_strings;
     std::vector<PreDetectionHookFunction>       pre_detection_hooks;
@@ -322,8 +482,42 @@ private:
     std::atomic<unsigned int>                   detection_percent;
     std::atomic<unsigned int>                   detection_prev_size;
     std::vector<bool>                           detection_size_entry_used;
-    const char*                                 detection_string;
+    std::atomic<const char*>                    detection_string;
+
+    std::mutex                                  DetectedControllersMutex;
+    std::vector<DetectedRGBController>          detected_controllers;
+    std::atomic<unsigned int>                   detection_units_done;
+    unsigned int                                detection_units_total;
+
+    /*-------------------------------------------------------------------------------------*\
+    | Hotplug Detection, HID device path of each controller found by a HID detector so the  |
+    | controller can be removed when its device is unplugged                                |
+    \*-------------------------------------------------------------------------------------*/
+#ifdef __linux__
+    HotplugListener*                            hotplug_listener;
+#endif
+    std::vector<HIDControllerPath>              hid_controller_paths;
 
+    /*-------------------------------------------------------------------------------------*\
+    | Controller Reuse, HID controllers kept across a rescan and the identities of the      |
+    | controllers before the rescan, used to keep their order and SDK device indices        |
+    \*-------------------------------------------------------------------------------------*/
+    std::set<std::string>                       retained_hid_paths;
+    std::vector<std::string>                    previous_controller_identities;
+
+    /*-------------------------------------------------------------------------------------*\
+    | Deferred Controller Initialization, controllers registered with identity only are     |
+    | initialized one at a time on the initialize thread                                    |
+    \*-------------------------------------------------------------------------------------*/
+    bool                                        deferred_initialization;
+    std::thread *                               InitializeControllersThread;
+    std::atomic<bool>                           initialize_controllers_running;
+    std::mutex                                  InitializeControllersMutex;
+    std::mutex                                  InitializeControllersRunMutex;
+    std::condition_variable                     InitializeControllersCV;
+    std::vector<RGBController*>                 uninitialized_controllers;
+    std::set<RGBController*>                    deferred_controllers;
+    std::mutex                                  DetectionSizesMutex;
 
     /*-------------------------------------------------------------------------------------*\
     | Device List Changed Callback                                                          |
@@ -40,11 +40,25 @@ const char *spd_memory_type_name[] =
 };
 
 SPDDetector::SPDDetector(i2c_smbus_interface *bus, uint8_t address, SPDMemoryType mem_type = SPD_RESERVED)
-  : bus(bus), address(address), mem_type(mem_type), valid(false)
+  : bus(bus), address(address), mem_type(mem_type), valid(false), accessor(nullptr)
 {
     detect_memory_type();
 }
 
+SPDDetector::SPDDetector(const SPDDetector &detector)
+  : bus(detector.bus), address(detector.address), mem_type(detector.mem_type), valid(detector.valid), accessor(nullptr)
+{
+    if(detector.accessor != nullptr)
+    {
+        accessor = detector.accessor->copy();
+    }
+}
+
+SPDDetector::~SPDDetector()
+{
+    delete accessor;
+}
+
 bool SPDDetector::is_valid() const
 {
     return valid;
@@ -57,8 +71,6 @@ SPDMemoryType SPDDetector::memory_type() const
 
 void SPDDetector::detect_memory_type()
 {
-    SPDAccessor *accessor;
-
     LOG_DEBUG("Probing DRAM on address 0x%02x", address);
 
 #ifdef __linux__
@@ -105,9 +117,9 @@ void SPDDetector::detect_memory_type()
         return;
     }
 
+    // Keep the accessor, it knows the page selected for detection
     valid = true;
     mem_type = accessor->memory_type();
-    delete accessor;
 }
 
 uint8_t SPDDetector::spd_address() const
@@ -120,20 +132,36 @@ i2c_smbus_interface *SPDDetector::smbus() const
     return this->bus;
 }
 
+SPDAccessor *SPDDetector::spd_accessor() const
+{
+    return this->accessor;
+}
+
 SPDWrapper::SPDWrapper(const SPDWrapper &wrapper)
 {
-    this->accessor = wrapper.accessor->copy();
+    this->accessor = wrapper.accessor ? wrapper.accessor->copy() : nullptr;
     this->address = wrapper.address;
     this->mem_type = wrapper.mem_type;
+    this->jedec = wrapper.jedec;
+    this->jedec_valid = wrapper.jedec_valid;
 }
 
 SPDWrapper::SPDWrapper(const SPDDetector &detector)
 {
     this->address = detector.spd_address();
     this->mem_type = detector.memory_type();
+    this->jedec = 0x0000;
+    this->jedec_valid = false;
 
-    // Allocate a new accessor
-    this->accessor = SPDAccessor::for_memory_type(this->mem_type, detector.smbus(), this->address);
+    // Copy the accessor of the detection, or allocate a new one
+    if(detector.spd_accessor() != nullptr && (this->mem_type == SPD_DDR4_SDRAM || this->mem_type == SPD_DDR5_SDRAM))
+    {
+        this->accessor = detector.spd_accessor()->copy();
+    }
+    else
+    {
+        this->accessor = SPDAccessor::for_memory_type(this->mem_type, detector.smbus(), this->address);
+    }
 }
 
 SPDWrapper::~SPDWrapper()
@@ -157,7 +185,29 @@ uint16_t SPDWrapper::jedec_id()
     {
         return 0x0000;
     }
-    return accessor->jedec_id();
+
+    // Detectors look up the ID of every slot, only read it once
+    if(!jedec_valid)
+    {
+        jedec = accessor->jedec_id();
+        jedec_valid = true;
+    }
+    return jedec;
+}
+
+bool SPDWrapper::checksum(uint16_t *crc)
+{
+    if(accessor == nullptr)
+    {
+        return false;
+    }
+    return accessor->checksum(crc);
+}
+
+void SPDWrapper::set_jedec_id(uint16_t jedec_id)
+{
+    jedec = jedec_id;
+    jedec_valid = true;
 }
 
 /*-------------------------------------------------------------------------*\
@@ -205,6 +255,19 @@ SPDAccessor::~SPDAccessor()
 {
 }
 
+void SPDAccessor::read(uint16_t addr, uint8_t *data, uint8_t length)
+{
+    for(uint8_t idx = 0; idx < length; idx++)
+    {
+        data[idx] = this->at(addr + idx);
+    }
+}
+
+bool SPDAccessor::checksum(uint16_t * /*crc*/)
+{
+    return false;
+}
+
 SPDAccessor *SPDAccessor::for_memory_type(SPDMemoryType type, i2c_smbus_interface *bus, uint8_t spd_addr)
 {
     if(type == SPD_DDR4_SDRAM)
@@ -247,7 +310,9 @@ SPDMemoryType DDR4Accessor::memory_type()
 
 uint16_t DDR4Accessor::jedec_id()
 {
-    return (this->at(0x140) << 8) + (this->at(0x141) & 0x7f) - 1;
+    uint8_t id[2];
+    this->read(0x140, id, sizeof(id));
+    return (id[0] << 8) + (id[1] & 0x7f) - 1;
 }
 
 DDR5Accessor::DDR5Accessor(i2c_smbus_interface *bus, uint8_t spd_addr)
@@ -266,7 +331,9 @@ SPDMemoryType DDR5Accessor::memory_type()
 
 uint16_t DDR5Accessor::jedec_id()
 {
-    return (this->at(0x200) << 8) + (this->at(0x201) & 0x7f) - 1;
+    uint8_t id[2];
+    this->read(0x200, id, sizeof(id));
+    return (id[0] << 8) + (id[1] & 0x7f) - 1;
 }
 
 DDR4DirectAccessor::DDR4DirectAccessor(i2c_smbus_interface *bus, uint8_t spd_addr)
@@ -296,7 +363,9 @@ bool DDR4DirectAccessor::isAvailable(i2c_smbus_interface *bus, uint8_t spd_addr)
 
 SPDAccessor *DDR4DirectAccessor::copy()
 {
-    return new DDR4DirectAccessor(bus, address);
+    DDR4DirectAccessor *access = new DDR4DirectAccessor(bus, address);
+    access->current_page = this->current_page;
+    return access;
 }
 
 uint8_t DDR4DirectAccessor::at(uint16_t addr)
@@ -313,6 +382,36 @@ uint8_t DDR4DirectAccessor::at(uint16_t addr)
     return (uint8_t)value;
 }
 
+void DDR4DirectAccessor::read(uint16_t addr, uint8_t *data, uint8_t length)
+{
+    // A block read does not cross a page
+    if(addr + length > SPD_DDR4_EEPROM_LENGTH ||
+       (addr >> SPD_DDR4_EEPROM_PAGE_SHIFT) != ((addr + length - 1) >> SPD_DDR4_EEPROM_PAGE_SHIFT))
+    {
+        SPDAccessor::read(addr, data, length);
+        return;
+    }
+    set_page(addr >> SPD_DDR4_EEPROM_PAGE_SHIFT);
+    uint8_t offset = (uint8_t)(addr & SPD_DDR4_EEPROM_PAGE_MASK);
+    if(bus->i2c_smbus_read_i2c_block_data(address, offset, length, data) == length)
+    {
+        std::this_thread::sleep_for(SPD_IO_DELAY);
+        return;
+    }
+
+    // Not every SMBus controller supports I2C block reads
+    SPDAccessor::read(addr, data, length);
+}
+
+bool DDR4DirectAccessor::checksum(uint16_t *crc)
+{
+    // CRC of the base configuration, bytes 126 and 127 on page 0
+    uint8_t value[2];
+    this->read(0x7E, value, sizeof(value));
+    *crc = value[0] | (value[1] << 8);
+    return true;
+}
+
 void DDR4DirectAccessor::set_page(uint8_t page)
 {
     if(current_page != page)
@@ -373,6 +472,7 @@ void EE1004Accessor::readEeprom()
     {
         eeprom_file.read((char*)dump, sizeof(dump));
         eeprom_file.close();
+        valid = true;
     }
     delete[] filename;
 }
@@ -453,6 +553,27 @@ uint8_t DDR5DirectAccessor::at(uint16_t addr)
     return (uint8_t)value;
 }
 
+void DDR5DirectAccessor::read(uint16_t addr, uint8_t *data, uint8_t length)
+{
+    // A block read does not cross a page
+    if(addr + length > SPD_DDR5_EEPROM_LENGTH ||
+       (addr >> SPD_DDR5_EEPROM_PAGE_SHIFT) != ((addr + length - 1) >> SPD_DDR5_EEPROM_PAGE_SHIFT))
+    {
+        SPDAccessor::read(addr, data, length);
+        return;
+    }
+    set_page(addr >> SPD_DDR5_EEPROM_PAGE_SHIFT);
+    uint8_t offset = (uint8_t)(addr & SPD_DDR5_EEPROM_PAGE_MASK) | 0x80;
+    if(bus->i2c_smbus_read_i2c_block_data(address, offset, length, data) == length)
+    {
+        std::this_thread::sleep_for(SPD_IO_DELAY);
+        return;
+    }
+
+    // Not every SMBus controller supports I2C block reads
+    SPDAccessor::read(addr, data, length);
+}
+
 void DDR5DirectAccessor::set_page(uint8_t page)
 {
     if(current_page != page)
@@ -513,6 +634,7 @@ void SPD5118Accessor::readEeprom()
     {
         eeprom_file.read((char*)dump, sizeof(dump));
         eeprom_file.close();
+        valid = true;
     }
     delete[] filename;
 }
@@ -52,21 +52,28 @@ typedef enum
 
 extern const char *spd_memory_type_name[];
 
+class SPDAccessor;
+
 class SPDDetector
 {
   public:
     SPDDetector(i2c_smbus_interface *bus, uint8_t address, SPDMemoryType mem_type);
+    SPDDetector(const SPDDetector &detector);
+    SPDDetector &operator=(const SPDDetector &detector) = delete;
+    ~SPDDetector();
 
     bool is_valid() const;
     SPDMemoryType memory_type() const;
     uint8_t spd_address() const;
     i2c_smbus_interface *smbus() const;
+    SPDAccessor *spd_accessor() const;
 
   private:
     i2c_smbus_interface *bus;
     uint8_t address;
     SPDMemoryType mem_type;
     bool valid;
+    SPDAccessor *accessor;
 
     void detect_memory_type();
 };
@@ -85,6 +92,10 @@ class SPDAccessor
     virtual SPDAccessor *copy() = 0;
 
     virtual uint8_t at(uint16_t addr) = 0;
+    virtual void read(uint16_t addr, uint8_t *data, uint8_t length);
+
+    // Checksum readable from the detection page, false if there is none
+    virtual bool checksum(uint16_t *crc);
 
   protected:
     i2c_smbus_interface *bus;
@@ -102,10 +113,15 @@ class SPDWrapper
     int index();
     uint16_t jedec_id();
 
+    bool checksum(uint16_t *crc);
+    void set_jedec_id(uint16_t jedec_id);
+
   private:
     SPDAccessor *accessor;
     uint8_t address;
     SPDMemoryType mem_type;
+    uint16_t jedec;
+    bool jedec_valid;
 };
 
 /*-------------------------------------------------------------------------*\
@@ -131,6 +147,8 @@ class DDR4DirectAccessor : public DDR4Accessor
 
     virtual SPDAccessor *copy();
     virtual uint8_t at(uint16_t addr);
+    virtual void read(uint16_t addr, uint8_t *data, uint8_t length);
+    virtual bool checksum(uint16_t *crc);
 
   private:
     uint8_t current_page = 0xFF;
@@ -182,6 +200,7 @@ class DDR5DirectAccessor : public DDR5Accessor
 
     virtual SPDAccessor *copy();
     virtual uint8_t at(uint16_t addr);
+    virtual void read(uint16_t addr, uint8_t *data, uint8_t length);
 
   private:
     uint8_t current_page = 0xFF;
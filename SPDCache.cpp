@@ -0,0 +1,179 @@
+/*---------------------------------------------------------*\
+| SPDCache.cpp                                              |
+|                                                           |
+|   Decoded SPD contents of the DIMMs found by the last     |
+|   detection, lets later detections skip the SPD reads     |
+|   that need a page switch                                 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <cstdio>
+#include <fstream>
+#include "SPDCache.h"
+#include "LogManager.h"
+#include "SettingsManager.h"
+
+SPDCache::SPDCache()
+{
+    changed = false;
+}
+
+bool SPDCache::Load(const filesystem::path& filename)
+{
+    json cache_data;
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    entries.clear();
+    changed = false;
+
+    if(!filesystem::exists(filename))
+    {
+        return(false);
+    }
+
+    std::ifstream cache_file(filename, std::ios::in | std::ios::binary);
+
+    if(!cache_file)
+    {
+        return(false);
+    }
+
+    try
+    {
+        cache_file >> cache_data;
+
+        for(json::const_iterator dimm = cache_data["dimms"].begin(); dimm != cache_data["dimms"].end(); dimm++)
+        {
+            SPDCacheEntry entry;
+
+            entry.mem_type  = (SPDMemoryType)dimm.value()["type"].get<int>();
+            entry.checksum  = dimm.value()["checksum"].get<uint16_t>();
+            entry.jedec_id  = dimm.value()["jedec_id"].get<uint16_t>();
+
+            entries[dimm.key()] = entry;
+        }
+    }
+    catch(const std::exception& e)
+    {
+        LOG_ERROR("[SPDCache] JSON parsing failed: %s", e.what());
+
+        entries.clear();
+        return(false);
+    }
+
+    LOG_INFO("[SPDCache] Loaded %d DIMMs", (int)entries.size());
+
+    return(true);
+}
+
+void SPDCache::Save(const filesystem::path& filename)
+{
+    json cache_data;
+
+    mutex.lock();
+
+    if(!changed)
+    {
+        mutex.unlock();
+        return;
+    }
+
+    cache_data["dimms"] = json::object();
+
+    for(std::map<std::string, SPDCacheEntry>::const_iterator entry = entries.begin(); entry != entries.end(); entry++)
+    {
+        json dimm_data;
+
+        dimm_data["type"]       = (int)entry->second.mem_type;
+        dimm_data["checksum"]   = entry->second.checksum;
+        dimm_data["jedec_id"]   = entry->second.jedec_id;
+
+        cache_data["dimms"][entry->first] = dimm_data;
+    }
+
+    changed = false;
+
+    mutex.unlock();
+
+    std::ofstream cache_file(filename, std::ios::out | std::ios::binary);
+
+    if(cache_file)
+    {
+        try
+        {
+            cache_file << cache_data.dump(4);
+        }
+        catch(const std::exception& e)
+        {
+            LOG_ERROR("[SPDCache] Cannot write to file: %s", e.what());
+        }
+
+        cache_file.close();
+    }
+}
+
+uint16_t SPDCache::GetJedecID(i2c_smbus_interface* bus, SPDWrapper& slot)
+{
+    uint16_t checksum;
+
+    /*-----------------------------------------------------*\
+    | Without a checksum on the detection page there is     |
+    | nothing to save, read the ID                          |
+    \*-----------------------------------------------------*/
+    if(!slot.checksum(&checksum))
+    {
+        return(slot.jedec_id());
+    }
+
+    std::string key = DIMMKey(bus, slot);
+
+    mutex.lock();
+
+    std::map<std::string, SPDCacheEntry>::const_iterator entry = entries.find(key);
+
+    if(entry != entries.end()
+    && entry->second.mem_type == slot.memory_type()
+    && entry->second.checksum == checksum)
+    {
+        uint16_t jedec_id = entry->second.jedec_id;
+
+        mutex.unlock();
+
+        slot.set_jedec_id(jedec_id);
+
+        return(jedec_id);
+    }
+
+    mutex.unlock();
+
+    /*-----------------------------------------------------*\
+    | New or changed DIMM, read the ID outside of the lock, |
+    | other busses are scanned at the same time             |
+    \*-----------------------------------------------------*/
+    SPDCacheEntry new_entry;
+
+    new_entry.mem_type  = slot.memory_type();
+    new_entry.checksum  = checksum;
+    new_entry.jedec_id  = slot.jedec_id();
+
+    mutex.lock();
+
+    entries[key] = new_entry;
+    changed      = true;
+
+    mutex.unlock();
+
+    return(new_entry.jedec_id);
+}
+
+std::string SPDCache::DIMMKey(i2c_smbus_interface* bus, SPDWrapper& slot)
+{
+    char ids[40];
+
+    snprintf(ids, sizeof(ids), "%04X:%04X:%04X:%04X 0x%02X ", bus->pci_vendor, bus->pci_device, bus->pci_subsystem_vendor, bus->pci_subsystem_device, 0x50 + slot.index());
+
+    return(std::string(ids) + bus->device_name);
+}
@@ -0,0 +1,51 @@
+/*---------------------------------------------------------*\
+| SPDCache.h                                                |
+|                                                           |
+|   Decoded SPD contents of the DIMMs found by the last     |
+|   detection, lets later detections skip the SPD reads     |
+|   that need a page switch                                 |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include "i2c_smbus.h"
+#include "filesystem.h"
+#include "SPDAccessor.h"
+
+/*---------------------------------------------------------*\
+| One DIMM, valid while its SPD checksum is unchanged       |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    SPDMemoryType                   mem_type;
+    uint16_t                        checksum;
+    uint16_t                        jedec_id;
+} SPDCacheEntry;
+
+class SPDCache
+{
+public:
+    SPDCache();
+
+    bool Load(const filesystem::path& filename);
+    void Save(const filesystem::path& filename);
+
+    /*-----------------------------------------------------*\
+    | Returns the JEDEC ID of the slot, from the cache when |
+    | the checksum still matches.  Sets the ID of the slot  |
+    \*-----------------------------------------------------*/
+    uint16_t GetJedecID(i2c_smbus_interface* bus, SPDWrapper& slot);
+
+private:
+    static std::string DIMMKey(i2c_smbus_interface* bus, SPDWrapper& slot);
+
+    std::mutex                              mutex;
+    std::map<std::string, SPDCacheEntry>    entries;
+    bool                                    changed;
+};
@@ -0,0 +1,302 @@
+/*---------------------------------------------------------*\
+| DetectorRegistryBenchmark.cpp                             |
+|                                                           |
+|   Compares the cost of the static detector registrations  |
+|   that run before main()                                  |
+|                                                           |
+|   The old registration built a name string and a          |
+|   std::function for every detector and appended a block   |
+|   to the ResourceManager detector list.  A descriptor     |
+|   only stores a name pointer and a function pointer and   |
+|   links itself into a list, the blocks are built when the |
+|   first detection registers the list.                     |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include <hidapi.h>
+#include "ResourceManager.h"
+
+struct BenchmarkOptions
+{
+    unsigned int    detectors       = 1000;
+    unsigned int    iterations      = 200;
+};
+
+/*---------------------------------------------------------*\
+| Heap usage counters, updated by the global operator new   |
+\*---------------------------------------------------------*/
+static unsigned long long heap_allocations  = 0;
+static unsigned long long heap_bytes        = 0;
+
+void* operator new(std::size_t size)
+{
+    heap_allocations++;
+    heap_bytes += size;
+
+    void* ptr = malloc(size ? size : 1);
+
+    if(ptr == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    return(ptr);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    free(ptr);
+}
+
+static void BenchmarkDetector(hid_device_info* /*info*/, const std::string& /*name*/)
+{
+}
+
+/*---------------------------------------------------------*\
+| Same layout and construction as the descriptors in        |
+| DeviceDetector.h.  DeviceDetector.h registers through     |
+| ResourceManager.cpp, which is not linked here             |
+\*---------------------------------------------------------*/
+typedef void (*HIDDeviceDetectorPointer)(hid_device_info*, const std::string&);
+
+class BenchmarkDescriptor
+{
+public:
+    BenchmarkDescriptor(BenchmarkDescriptor** list_tail, const char* name, HIDDeviceDetectorPointer detector, uint16_t vid, uint16_t pid, int interface, int usage_page, int usage)
+    {
+        this->name          = name;
+        this->detector      = detector;
+        this->vid           = vid;
+        this->pid           = pid;
+        this->interface     = interface;
+        this->usage_page    = usage_page;
+        this->usage         = usage;
+        this->next          = nullptr;
+
+        if(*list_tail != nullptr)
+        {
+            (*list_tail)->next = this;
+        }
+
+        *list_tail = this;
+    }
+
+    virtual ~BenchmarkDescriptor() = default;
+
+    virtual void Register(std::vector<HIDDeviceDetectorBlock>& detectors)
+    {
+        HIDDeviceDetectorBlock block;
+
+        block.name          = name;
+        block.vid           = vid;
+        block.pid           = pid;
+        block.function      = detector;
+        block.interface     = interface;
+        block.usage_page    = usage_page;
+        block.usage         = usage;
+
+        detectors.push_back(block);
+    }
+
+    BenchmarkDescriptor*                next;
+
+private:
+    const char*                         name;
+    HIDDeviceDetectorPointer            detector;
+    uint16_t                            vid;
+    uint16_t                            pid;
+    int                                 interface;
+    int                                 usage_page;
+    int                                 usage;
+};
+
+/*---------------------------------------------------------*\
+| Old registration, as done by the HIDDeviceDetector        |
+| constructor and RegisterHIDDeviceDetector()               |
+\*---------------------------------------------------------*/
+static void RegisterBlock(std::vector<HIDDeviceDetectorBlock>& detectors, std::string name, HIDDeviceDetectorFunction detector, uint16_t vid, uint16_t pid, int interface, int usage_page, int usage)
+{
+    HIDDeviceDetectorBlock block;
+
+    block.name          = name;
+    block.vid           = vid;
+    block.pid           = pid;
+    block.function      = detector;
+    block.interface     = interface;
+    block.usage_page    = usage_page;
+    block.usage         = usage;
+
+    detectors.push_back(block);
+}
+
+static void PrintHelp()
+{
+    printf("OpenRGB detector registry benchmark\n\n");
+    printf("Usage: OpenRGBDetectorRegistryBenchmark [options]\n\n");
+    printf("--detectors N     Number of registered HID detectors (default 1000)\n");
+    printf("--iterations N    Number of registration passes to time (default 200)\n");
+}
+
+static bool ParseOptions(int argc, char* argv[], BenchmarkOptions* options)
+{
+    for(int arg_idx = 1; arg_idx < argc; arg_idx++)
+    {
+        std::string option = argv[arg_idx];
+
+        if(option == "--help" || option == "-h")
+        {
+            return false;
+        }
+
+        if(arg_idx + 1 >= argc)
+        {
+            printf("Error: Missing argument for %s\n", option.c_str());
+            return false;
+        }
+
+        unsigned long value = strtoul(argv[++arg_idx], NULL, 10);
+
+        if(value == 0)
+        {
+            printf("Error: Invalid argument for %s\n", option.c_str());
+            return false;
+        }
+
+        if(option == "--detectors")
+        {
+            options->detectors  = (unsigned int)value;
+        }
+        else if(option == "--iterations")
+        {
+            options->iterations = (unsigned int)value;
+        }
+        else
+        {
+            printf("Error: Unknown option %s\n", option.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+
+    if(!ParseOptions(argc, argv, &options))
+    {
+        PrintHelp();
+        return 1;
+    }
+
+    /*-----------------------------------------------------*\
+    | Detector names are string literals of 10 to 40        |
+    | characters in the registrations                       |
+    \*-----------------------------------------------------*/
+    std::vector<std::string> names(options.detectors);
+
+    for(unsigned int detector_idx = 0; detector_idx < options.detectors; detector_idx++)
+    {
+        names[detector_idx] = "Vendor Device Model " + std::to_string(detector_idx) + std::string(detector_idx % 20, 'X');
+    }
+
+    /*-----------------------------------------------------*\
+    | Descriptors live in static storage in the real        |
+    | program, reserve their storage outside the timing     |
+    \*-----------------------------------------------------*/
+    char*                               storage     = (char*)malloc(sizeof(BenchmarkDescriptor) * options.detectors);
+    BenchmarkDescriptor*                descriptors = (BenchmarkDescriptor*)storage;
+    std::vector<HIDDeviceDetectorBlock> detectors;
+
+    double              old_us          = 0.0;
+    double              link_us         = 0.0;
+    double              register_us     = 0.0;
+    unsigned long long  old_allocs      = 0;
+    unsigned long long  old_bytes       = 0;
+    unsigned long long  link_allocs     = 0;
+    unsigned long long  link_bytes      = 0;
+
+    for(unsigned int iteration = 0; iteration < options.iterations; iteration++)
+    {
+        /*-------------------------------------------------*\
+        | Old static registration                           |
+        \*-------------------------------------------------*/
+        detectors = std::vector<HIDDeviceDetectorBlock>();
+
+        unsigned long long allocs_start = heap_allocations;
+        unsigned long long bytes_start  = heap_bytes;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for(unsigned int detector_idx = 0; detector_idx < options.detectors; detector_idx++)
+        {
+            RegisterBlock(detectors, names[detector_idx].c_str(), BenchmarkDetector, 0x1000, (uint16_t)detector_idx, 0, 0xFF00, 1);
+        }
+
+        old_us     += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        old_allocs += heap_allocations - allocs_start;
+        old_bytes  += heap_bytes - bytes_start;
+
+        /*-------------------------------------------------*\
+        | Descriptor construction                           |
+        \*-------------------------------------------------*/
+        BenchmarkDescriptor* list_tail = nullptr;
+
+        allocs_start = heap_allocations;
+        bytes_start  = heap_bytes;
+
+        start = std::chrono::steady_clock::now();
+
+        for(unsigned int detector_idx = 0; detector_idx < options.detectors; detector_idx++)
+        {
+            new(&descriptors[detector_idx]) BenchmarkDescriptor(&list_tail, names[detector_idx].c_str(), BenchmarkDetector, 0x1000, (uint16_t)detector_idx, 0, 0xFF00, 1);
+        }
+
+        link_us     += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        link_allocs += heap_allocations - allocs_start;
+        link_bytes  += heap_bytes - bytes_start;
+
+        /*-------------------------------------------------*\
+        | Deferred registration at the first detection      |
+        \*-------------------------------------------------*/
+        detectors = std::vector<HIDDeviceDetectorBlock>();
+
+        start = std::chrono::steady_clock::now();
+
+        for(BenchmarkDescriptor* descriptor = &descriptors[0]; descriptor != nullptr; descriptor = descriptor->next)
+        {
+            descriptor->Register(detectors);
+        }
+
+        register_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        for(unsigned int detector_idx = 0; detector_idx < options.detectors; detector_idx++)
+        {
+            descriptors[detector_idx].~BenchmarkDescriptor();
+        }
+    }
+
+    free(storage);
+
+    printf("Detectors:                %u\n", options.detectors);
+    printf("Static registration:      %10.2f us  %llu allocations, %llu bytes\n", old_us / options.iterations, old_allocs / options.iterations, old_bytes / options.iterations);
+    printf("Descriptor construction:  %10.2f us  %llu allocations, %llu bytes\n", link_us / options.iterations, link_allocs / options.iterations, link_bytes / options.iterations);
+    printf("Deferred registration:    %10.2f us  (at the first detection)\n", register_us / options.iterations);
+    printf("Time before main():       %10.1fx less\n", old_us / link_us);
+
+    return 0;
+}
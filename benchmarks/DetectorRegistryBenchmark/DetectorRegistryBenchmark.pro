@@ -0,0 +1,68 @@
+#-----------------------------------------------------------------------------------------------#
+# OpenRGB Detector Registry Benchmark QMake Project                                             #
+#                                                                                               #
+#   Standalone benchmark comparing the old static detector registration, which built a name     #
+#   string and a std::function per detector before main(), with the detector descriptors from   #
+#   DeviceDetector.h.  Uses a synthetic detector list, so it does not require Qt or any RGB     #
+#   hardware.                                                                                   #
+#                                                                                               #
+#   Build:  qmake benchmarks/DetectorRegistryBenchmark/DetectorRegistryBenchmark.pro && make    #
+#-----------------------------------------------------------------------------------------------#
+
+QT      -=                                                                                      \
+    core                                                                                        \
+    gui                                                                                         \
+
+CONFIG  +=  c++17                                                                               \
+            console                                                                             \
+            silent                                                                              \
+
+CONFIG  -=  app_bundle                                                                          \
+            qt                                                                                  \
+
+TARGET      = OpenRGBDetectorRegistryBenchmark
+TEMPLATE    = app
+
+ROOT        = $$PWD/../..
+
+INCLUDEPATH +=                                                                                  \
+    $$ROOT                                                                                      \
+    $$ROOT/dependencies/json                                                                    \
+    $$ROOT/hidapi_wrapper                                                                       \
+    $$ROOT/i2c_smbus                                                                            \
+    $$ROOT/net_port                                                                             \
+    $$ROOT/RGBController                                                                        \
+
+HEADERS +=                                                                                      \
+    $$ROOT/ResourceManager.h                                                                    \
+
+SOURCES +=                                                                                      \
+    DetectorRegistryBenchmark.cpp                                                               \
+
+#-----------------------------------------------------------------------------------------------#
+# Windows-specific Configuration                                                                #
+#-----------------------------------------------------------------------------------------------#
+win32:INCLUDEPATH +=                                                                            \
+    $$ROOT/dependencies/hidapi-win/include                                                      \
+
+#-----------------------------------------------------------------------------------------------#
+# Linux-specific Configuration                                                                  #
+#   hidapi is only needed for the hid_device_info definition                                    #
+#-----------------------------------------------------------------------------------------------#
+contains(QMAKE_PLATFORM, linux) {
+    CONFIG      += link_pkgconfig
+
+    packagesExist(hidapi-hidraw) {
+        PKGCONFIG += hidapi-hidraw
+    } else {
+        PKGCONFIG += hidapi
+    }
+}
+
+#-----------------------------------------------------------------------------------------------#
+# MacOS-specific Configuration                                                                  #
+#-----------------------------------------------------------------------------------------------#
+macx {
+    CONFIG      += link_pkgconfig
+    PKGCONFIG   += hidapi
+}
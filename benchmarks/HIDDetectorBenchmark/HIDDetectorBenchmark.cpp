@@ -0,0 +1,344 @@
+/*---------------------------------------------------------*\
+| HIDDetectorBenchmark.cpp                                  |
+|                                                           |
+|   Compares the linear HID detector scan against the       |
+|   (vid, pid) indexed dispatch used by ResourceManager     |
+|                                                           |
+|   A synthetic detector list with the same shape as the    |
+|   REGISTER_HID_DETECTOR* registrations is matched against |
+|   a synthetic HID enumeration.  Both methods must select  |
+|   the same detectors in the same order.                   |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include <hidapi.h>
+#include "ResourceManager.h"
+
+struct BenchmarkOptions
+{
+    unsigned int    detectors       = 1000;
+    unsigned int    interfaces      = 40;
+    unsigned int    vendors         = 60;
+    unsigned int    iterations      = 2000;
+};
+
+/*---------------------------------------------------------*\
+| Same matching rules as BasicHIDBlock::compare() built     |
+| with USE_HID_USAGE.  BasicHIDBlock::compare() lives in    |
+| ResourceManager.cpp, which is not linked here             |
+\*---------------------------------------------------------*/
+static inline bool CompareBlock(const BasicHIDBlock& block, const hid_device_info* info)
+{
+    return ( (block.vid == info->vendor_id)
+        && (block.pid == info->product_id)
+        && ( (block.usage_page == HID_USAGE_PAGE_ANY)
+            || (block.usage_page == info->usage_page) )
+        && ( (block.usage      == HID_USAGE_ANY)
+            || (block.usage      == info->usage) )
+        && ( (block.interface  == HID_INTERFACE_ANY)
+            || (block.interface  == info->interface_number ) )
+            );
+}
+
+static void GenerateDetectors(const BenchmarkOptions& options, std::mt19937& rng, std::vector<BasicHIDBlock>& detectors)
+{
+    std::uniform_int_distribution<unsigned int> vendor_dist(0, options.vendors - 1);
+    std::uniform_int_distribution<unsigned int> pid_dist(0x0001, 0xFFFE);
+    std::uniform_int_distribution<unsigned int> kind_dist(0, 99);
+    std::uniform_int_distribution<int>          interface_dist(0, 3);
+
+    detectors.clear();
+
+    while(detectors.size() < options.detectors)
+    {
+        BasicHIDBlock block;
+
+        block.name          = "Detector " + std::to_string(detectors.size());
+        block.vid           = (uint16_t)(0x1000 + vendor_dist(rng));
+        block.pid           = (uint16_t)pid_dist(rng);
+        block.interface     = HID_INTERFACE_ANY;
+        block.usage_page    = HID_USAGE_PAGE_ANY;
+        block.usage         = HID_USAGE_ANY;
+
+        /*-----------------------------------------------------*\
+        | Mix of plain, _I, _IP, _IPU and _PU registrations in  |
+        | roughly the proportions found in Controllers/         |
+        \*-----------------------------------------------------*/
+        unsigned int kind = kind_dist(rng);
+
+        if(kind >= 15)
+        {
+            block.interface     = interface_dist(rng);
+        }
+        if(kind >= 25)
+        {
+            block.usage_page    = 0xFF00 | interface_dist(rng);
+        }
+        if(kind >= 50)
+        {
+            block.usage         = 1 + interface_dist(rng);
+        }
+
+        detectors.push_back(block);
+
+        /*-----------------------------------------------------*\
+        | Some devices register several interfaces under the    |
+        | same vid/pid                                          |
+        \*-----------------------------------------------------*/
+        if(kind % 7 == 0 && detectors.size() < options.detectors)
+        {
+            block.interface = (block.interface == HID_INTERFACE_ANY) ? 0 : block.interface + 1;
+            detectors.push_back(block);
+        }
+    }
+}
+
+static void GenerateInterfaces(const BenchmarkOptions& options, std::mt19937& rng, const std::vector<BasicHIDBlock>& detectors, std::vector<hid_device_info>& interfaces)
+{
+    std::uniform_int_distribution<unsigned int> detector_dist(0, (unsigned int)detectors.size() - 1);
+    std::uniform_int_distribution<unsigned int> pid_dist(0x0001, 0xFFFE);
+    std::uniform_int_distribution<unsigned int> kind_dist(0, 99);
+    std::uniform_int_distribution<int>          interface_dist(0, 3);
+
+    interfaces.assign(options.interfaces, hid_device_info());
+
+    for(unsigned int interface_idx = 0; interface_idx < options.interfaces; interface_idx++)
+    {
+        hid_device_info& info = interfaces[interface_idx];
+
+        /*-----------------------------------------------------*\
+        | About a quarter of the interfaces belong to supported |
+        | RGB devices, the rest are keyboards, mice, hubs etc.  |
+        \*-----------------------------------------------------*/
+        if(kind_dist(rng) < 25)
+        {
+            const BasicHIDBlock& block = detectors[detector_dist(rng)];
+
+            info.vendor_id          = block.vid;
+            info.product_id         = block.pid;
+            info.interface_number   = (block.interface  == HID_INTERFACE_ANY)  ? interface_dist(rng) : block.interface;
+            info.usage_page         = (block.usage_page == HID_USAGE_PAGE_ANY) ? 0xFF00              : block.usage_page;
+            info.usage              = (block.usage      == HID_USAGE_ANY)      ? 1                   : block.usage;
+        }
+        else
+        {
+            info.vendor_id          = (uint16_t)pid_dist(rng);
+            info.product_id         = (uint16_t)pid_dist(rng);
+            info.interface_number   = interface_dist(rng);
+            info.usage_page         = 0x0001;
+            info.usage              = 0x0006;
+        }
+
+        info.next = (interface_idx + 1 < options.interfaces) ? &interfaces[interface_idx + 1] : NULL;
+    }
+}
+
+static void BuildIndex(const std::vector<BasicHIDBlock>& detectors, HIDDetectorIndex& index)
+{
+    index.clear();
+    index.reserve(detectors.size());
+
+    for(unsigned int detector_idx = 0; detector_idx < (unsigned int)detectors.size(); detector_idx++)
+    {
+        index[HID_DETECTOR_INDEX_KEY(detectors[detector_idx].vid, detectors[detector_idx].pid)].push_back(detector_idx);
+    }
+}
+
+static unsigned long long RunLinear(const std::vector<BasicHIDBlock>& detectors, hid_device_info* devices, std::vector<unsigned int>& matches)
+{
+    unsigned long long compares = 0;
+
+    for(hid_device_info* current = devices; current; current = current->next)
+    {
+        for(unsigned int detector_idx = 0; detector_idx < (unsigned int)detectors.size(); detector_idx++)
+        {
+            compares++;
+
+            if(CompareBlock(detectors[detector_idx], current))
+            {
+                matches.push_back(detector_idx);
+            }
+        }
+    }
+
+    return(compares);
+}
+
+static unsigned long long RunIndexed(const std::vector<BasicHIDBlock>& detectors, const HIDDetectorIndex& index, hid_device_info* devices, std::vector<unsigned int>& matches)
+{
+    unsigned long long compares = 0;
+
+    for(hid_device_info* current = devices; current; current = current->next)
+    {
+        HIDDetectorIndex::const_iterator candidates = index.find(HID_DETECTOR_INDEX_KEY(current->vendor_id, current->product_id));
+
+        if(candidates == index.end())
+        {
+            continue;
+        }
+
+        for(unsigned int candidate_idx = 0; candidate_idx < (unsigned int)candidates->second.size(); candidate_idx++)
+        {
+            unsigned int detector_idx = candidates->second[candidate_idx];
+
+            compares++;
+
+            if(CompareBlock(detectors[detector_idx], current))
+            {
+                matches.push_back(detector_idx);
+            }
+        }
+    }
+
+    return(compares);
+}
+
+static void PrintHelp()
+{
+    printf("OpenRGB HID detector dispatch benchmark\n\n");
+    printf("Usage: OpenRGBHIDDetectorBenchmark [options]\n\n");
+    printf("--detectors N     Number of registered HID detectors (default 1000)\n");
+    printf("--interfaces N    Number of enumerated HID interfaces (default 40)\n");
+    printf("--vendors N       Number of distinct vendor IDs among the detectors (default 60)\n");
+    printf("--iterations N    Number of detection passes to time (default 2000)\n");
+}
+
+static bool ParseOptions(int argc, char* argv[], BenchmarkOptions* options)
+{
+    for(int arg_idx = 1; arg_idx < argc; arg_idx++)
+    {
+        std::string option = argv[arg_idx];
+
+        if(option == "--help" || option == "-h")
+        {
+            return false;
+        }
+
+        if(arg_idx + 1 >= argc)
+        {
+            printf("Error: Missing argument for %s\n", option.c_str());
+            return false;
+        }
+
+        unsigned long value = strtoul(argv[++arg_idx], NULL, 10);
+
+        if(value == 0)
+        {
+            printf("Error: Invalid argument for %s\n", option.c_str());
+            return false;
+        }
+
+        if(option == "--detectors")
+        {
+            options->detectors  = (unsigned int)value;
+        }
+        else if(option == "--interfaces")
+        {
+            options->interfaces = (unsigned int)value;
+        }
+        else if(option == "--vendors")
+        {
+            options->vendors    = (unsigned int)value;
+        }
+        else if(option == "--iterations")
+        {
+            options->iterations = (unsigned int)value;
+        }
+        else
+        {
+            printf("Error: Unknown option %s\n", option.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+
+    if(!ParseOptions(argc, argv, &options))
+    {
+        PrintHelp();
+        return 1;
+    }
+
+    std::mt19937                    rng(0x4F524742);
+    std::vector<BasicHIDBlock>      detectors;
+    std::vector<hid_device_info>    interfaces;
+    HIDDetectorIndex                index;
+
+    GenerateDetectors(options, rng, detectors);
+    GenerateInterfaces(options, rng, detectors, interfaces);
+
+    /*-----------------------------------------------------*\
+    | Check that both methods select the same detectors     |
+    \*-----------------------------------------------------*/
+    std::vector<unsigned int> linear_matches;
+    std::vector<unsigned int> indexed_matches;
+
+    BuildIndex(detectors, index);
+
+    unsigned long long linear_compares  = RunLinear(detectors, &interfaces[0], linear_matches);
+    unsigned long long indexed_compares = RunIndexed(detectors, index, &interfaces[0], indexed_matches);
+
+    if(linear_matches != indexed_matches)
+    {
+        printf("Error: indexed dispatch selected different detectors than the linear scan\n");
+        return 1;
+    }
+
+    /*-----------------------------------------------------*\
+    | Time both methods                                     |
+    \*-----------------------------------------------------*/
+    std::vector<unsigned int> matches;
+    matches.reserve(linear_matches.size());
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for(unsigned int iteration = 0; iteration < options.iterations; iteration++)
+    {
+        matches.clear();
+        RunLinear(detectors, &interfaces[0], matches);
+    }
+
+    double linear_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / options.iterations;
+
+    start = std::chrono::steady_clock::now();
+
+    for(unsigned int iteration = 0; iteration < options.iterations; iteration++)
+    {
+        BuildIndex(detectors, index);
+    }
+
+    double build_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / options.iterations;
+
+    start = std::chrono::steady_clock::now();
+
+    for(unsigned int iteration = 0; iteration < options.iterations; iteration++)
+    {
+        matches.clear();
+        RunIndexed(detectors, index, &interfaces[0], matches);
+    }
+
+    double indexed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / options.iterations;
+
+    printf("Detectors:            %u (%u distinct vid/pid)\n", (unsigned int)detectors.size(), (unsigned int)index.size());
+    printf("HID interfaces:       %u (%u detector matches)\n", options.interfaces, (unsigned int)linear_matches.size());
+    printf("Linear scan:          %10.2f us/pass  %llu compares\n", linear_us, linear_compares);
+    printf("Index build:          %10.2f us\n", build_us);
+    printf("Indexed dispatch:     %10.2f us/pass  %llu lookups, %llu compares\n", indexed_us, (unsigned long long)options.interfaces, indexed_compares);
+    printf("Speedup per pass:     %10.1fx\n", linear_us / indexed_us);
+    printf("Speedup incl. build:  %10.1fx\n", linear_us / (indexed_us + build_us));
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+#-----------------------------------------------------------------------------------------------#
+# OpenRGB HID Detector Dispatch Benchmark QMake Project                                         #
+#                                                                                               #
+#   Standalone benchmark comparing the linear HID detector scan with the (vid, pid) indexed     #
+#   dispatch used by ResourceManager.  Uses synthetic detector and device lists, so it does not #
+#   require Qt or any RGB hardware.                                                             #
+#                                                                                               #
+#   Build:  qmake benchmarks/HIDDetectorBenchmark/HIDDetectorBenchmark.pro && make              #
+#-----------------------------------------------------------------------------------------------#
+
+QT      -=                                                                                      \
+    core                                                                                        \
+    gui                                                                                         \
+
+CONFIG  +=  c++17                                                                               \
+            console                                                                             \
+            silent                                                                              \
+
+CONFIG  -=  app_bundle                                                                          \
+            qt                                                                                  \
+
+TARGET      = OpenRGBHIDDetectorBenchmark
+TEMPLATE    = app
+
+ROOT        = $$PWD/../..
+
+INCLUDEPATH +=                                                                                  \
+    $$ROOT                                                                                      \
+    $$ROOT/dependencies/json                                                                    \
+    $$ROOT/hidapi_wrapper                                                                       \
+    $$ROOT/i2c_smbus                                                                            \
+    $$ROOT/net_port                                                                             \
+    $$ROOT/RGBController                                                                        \
+
+HEADERS +=                                                                                      \
+    $$ROOT/ResourceManager.h                                                                    \
+
+SOURCES +=                                                                                      \
+    HIDDetectorBenchmark.cpp                                                                    \
+
+#-----------------------------------------------------------------------------------------------#
+# Windows-specific Configuration                                                                #
+#-----------------------------------------------------------------------------------------------#
+win32:INCLUDEPATH +=                                                                            \
+    $$ROOT/dependencies/hidapi-win/include                                                      \
+
+#-----------------------------------------------------------------------------------------------#
+# Linux-specific Configuration                                                                  #
+#   hidapi is only needed for the hid_device_info definition                                    #
+#-----------------------------------------------------------------------------------------------#
+contains(QMAKE_PLATFORM, linux) {
+    CONFIG      += link_pkgconfig
+
+    packagesExist(hidapi-hidraw) {
+        PKGCONFIG += hidapi-hidraw
+    } else {
+        PKGCONFIG += hidapi
+    }
+}
+
+#-----------------------------------------------------------------------------------------------#
+# MacOS-specific Configuration                                                                  #
+#-----------------------------------------------------------------------------------------------#
+macx {
+    CONFIG      += link_pkgconfig
+    PKGCONFIG   += hidapi
+}
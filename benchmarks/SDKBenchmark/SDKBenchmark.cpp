@@ -0,0 +1,552 @@
+/*---------------------------------------------------------*\
+| SDKBenchmark.cpp                                          |
+|                                                           |
+|   Load generator and benchmark harness for the OpenRGB    |
+|   SDK server                                              |
+|                                                           |
+|   The server runs in a forked child process so that its   |
+|   CPU usage can be measured separately from the clients.  |
+|   Each UPDATELEDS frame carries its send time in the      |
+|   first LED color, which lets the server side measure the |
+|   latency from send until DeviceUpdateLEDs() runs.        |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "NetworkClient.h"
+#include "NetworkServer.h"
+#include "RGBController_Dummy.h"
+
+using namespace std::chrono_literals;
+
+/*---------------------------------------------------------*\
+| Control bytes passed between the parent and server child  |
+\*---------------------------------------------------------*/
+#define BENCHMARK_CMD_READY     'r'
+#define BENCHMARK_CMD_GO        'g'
+#define BENCHMARK_CMD_STOP      's'
+
+struct BenchmarkOptions
+{
+    unsigned int    devices         = 4;
+    unsigned int    leds            = 100;
+    unsigned int    clients         = 1;
+    unsigned int    rate            = 60;
+    unsigned int    duration        = 10;
+    unsigned short  port            = 16742;
+};
+
+struct BenchmarkServerResults
+{
+    unsigned long long  frames_applied;
+    double              cpu_seconds;
+    double              wall_seconds;
+    double              latency_p50_us;
+    double              latency_p99_us;
+    double              latency_max_us;
+    double              latency_mean_us;
+};
+
+/*---------------------------------------------------------*\
+| Timestamps are microseconds on the steady clock truncated |
+| to 32 bits.  CLOCK_MONOTONIC is shared between processes  |
+| on Linux and the modular difference stays correct as long |
+| as a frame is not delayed by more than ~71 minutes.       |
+\*---------------------------------------------------------*/
+static unsigned int BenchmarkTimestamp()
+{
+    return (unsigned int)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double TimevalToSeconds(const struct timeval& tv)
+{
+    return (double)tv.tv_sec + ((double)tv.tv_usec / 1000000.0);
+}
+
+/*---------------------------------------------------------*\
+| Server-side latency recording                             |
+\*---------------------------------------------------------*/
+static std::atomic<bool>            recording(false);
+static std::mutex                   latency_mutex;
+static std::vector<unsigned int>    latency_samples;
+
+class RGBController_Benchmark : public RGBController_Dummy
+{
+public:
+    RGBController_Benchmark(unsigned int index, unsigned int led_count)
+    {
+        name                    = "Benchmark Device " + std::to_string(index);
+        vendor                  = "OpenRGB";
+        type                    = DEVICE_TYPE_LEDSTRIP;
+        description             = "SDK Benchmark Device";
+        location                = "Benchmark Location " + std::to_string(index);
+        version                 = "1.0";
+        serial                  = std::to_string(index);
+
+        mode Direct;
+        Direct.name             = "Direct";
+        Direct.value            = 0;
+        Direct.flags            = MODE_FLAG_HAS_PER_LED_COLOR;
+        Direct.color_mode       = MODE_COLORS_PER_LED;
+        modes.push_back(Direct);
+
+        zone strip_zone;
+        strip_zone.name         = "Strip";
+        strip_zone.type         = ZONE_TYPE_LINEAR;
+        strip_zone.leds_min     = led_count;
+        strip_zone.leds_max     = led_count;
+        strip_zone.leds_count   = led_count;
+        strip_zone.matrix_map   = NULL;
+        zones.push_back(strip_zone);
+
+        for(unsigned int led_idx = 0; led_idx < led_count; led_idx++)
+        {
+            led strip_led;
+            strip_led.name      = "LED " + std::to_string(led_idx);
+            strip_led.value     = led_idx;
+            leds.push_back(strip_led);
+        }
+
+        SetupColors();
+    }
+
+    void DeviceUpdateLEDs()
+    {
+        unsigned int now = BenchmarkTimestamp();
+
+        if(!recording.load() || colors.empty())
+        {
+            return;
+        }
+
+        unsigned int latency = now - colors[0];
+
+        latency_mutex.lock();
+        latency_samples.push_back(latency);
+        latency_mutex.unlock();
+    }
+};
+
+static double Percentile(const std::vector<unsigned int>& sorted, double fraction)
+{
+    if(sorted.empty())
+    {
+        return 0.0;
+    }
+
+    std::size_t idx = (std::size_t)(fraction * (double)(sorted.size() - 1));
+
+    return (double)sorted[idx];
+}
+
+/******************************************************************************************\
+*                                                                                          *
+*   RunServer                                                                              *
+*                                                                                          *
+*       Runs in the forked child.  Starts a NetworkServer with dummy devices, waits for   *
+*       the parent to start and stop the measurement window and reports the results back   *
+*       over the result pipe.                                                              *
+*                                                                                          *
+\******************************************************************************************/
+
+static int RunServer(const BenchmarkOptions& options, int cmd_fd, int result_fd)
+{
+    std::vector<RGBController *> controllers;
+
+    for(unsigned int dev_idx = 0; dev_idx < options.devices; dev_idx++)
+    {
+        controllers.push_back(new RGBController_Benchmark(dev_idx, options.leds));
+    }
+
+    NetworkServer server(controllers);
+
+    server.SetHost("127.0.0.1");
+    server.SetPort(options.port);
+    server.StartServer();
+
+    char cmd = BENCHMARK_CMD_READY;
+
+    if(!server.GetOnline())
+    {
+        cmd = BENCHMARK_CMD_STOP;
+    }
+
+    if(write(result_fd, &cmd, 1) != 1 || cmd != BENCHMARK_CMD_READY)
+    {
+        return 1;
+    }
+
+    BenchmarkServerResults              results;
+    struct rusage                       usage_start;
+    struct rusage                       usage_end;
+    std::chrono::steady_clock::time_point wall_start = std::chrono::steady_clock::now();
+
+    memset(&results, 0, sizeof(results));
+    getrusage(RUSAGE_SELF, &usage_start);
+
+    while(read(cmd_fd, &cmd, 1) == 1)
+    {
+        if(cmd == BENCHMARK_CMD_GO)
+        {
+            latency_mutex.lock();
+            latency_samples.clear();
+            latency_samples.reserve(options.devices * options.clients * options.rate * options.duration);
+            latency_mutex.unlock();
+
+            getrusage(RUSAGE_SELF, &usage_start);
+            wall_start = std::chrono::steady_clock::now();
+            recording  = true;
+        }
+        else if(cmd == BENCHMARK_CMD_STOP)
+        {
+            break;
+        }
+    }
+
+    recording = false;
+
+    getrusage(RUSAGE_SELF, &usage_end);
+
+    results.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    results.cpu_seconds  = (TimevalToSeconds(usage_end.ru_utime) - TimevalToSeconds(usage_start.ru_utime))
+                         + (TimevalToSeconds(usage_end.ru_stime) - TimevalToSeconds(usage_start.ru_stime));
+
+    latency_mutex.lock();
+
+    std::vector<unsigned int> sorted = latency_samples;
+
+    latency_mutex.unlock();
+
+    std::sort(sorted.begin(), sorted.end());
+
+    results.frames_applied = sorted.size();
+    results.latency_p50_us = Percentile(sorted, 0.50);
+    results.latency_p99_us = Percentile(sorted, 0.99);
+
+    if(!sorted.empty())
+    {
+        double sum = 0.0;
+
+        for(std::size_t sample_idx = 0; sample_idx < sorted.size(); sample_idx++)
+        {
+            sum += sorted[sample_idx];
+        }
+
+        results.latency_mean_us = sum / (double)sorted.size();
+        results.latency_max_us  = (double)sorted.back();
+    }
+
+    if(write(result_fd, &results, sizeof(results)) != sizeof(results))
+    {
+        return 1;
+    }
+
+    /*-----------------------------------------------------*\
+    | Skip destructors, the parent tears down the clients   |
+    | and the process exit closes the server sockets        |
+    \*-----------------------------------------------------*/
+    _exit(0);
+}
+
+/******************************************************************************************\
+*                                                                                          *
+*   ClientSendThreadFunction                                                               *
+*                                                                                          *
+*       Streams UPDATELEDS to every device of the server at the target frame rate          *
+*                                                                                          *
+\******************************************************************************************/
+
+static void ClientSendThreadFunction(NetworkClient* client, const BenchmarkOptions* options, std::atomic<bool>* running, std::atomic<unsigned long long>* packets)
+{
+    std::chrono::steady_clock::duration     frame_time  = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / (double)options->rate));
+    std::chrono::steady_clock::time_point   next_frame  = std::chrono::steady_clock::now();
+    unsigned int                            frame       = 0;
+
+    while(running->load())
+    {
+        client->ControllerListMutex.lock();
+
+        for(unsigned int dev_idx = 0; dev_idx < client->server_controllers.size(); dev_idx++)
+        {
+            RGBController* controller = client->server_controllers[dev_idx];
+
+            for(std::size_t color_idx = 1; color_idx < controller->colors.size(); color_idx++)
+            {
+                controller->colors[color_idx] = ToRGBColor(frame & 0xFF, color_idx & 0xFF, dev_idx & 0xFF);
+            }
+
+            controller->colors[0] = BenchmarkTimestamp();
+
+            unsigned char * data = controller->GetColorDescription();
+            unsigned int    size;
+
+            memcpy(&size, data, sizeof(size));
+
+            client->SendRequest_RGBController_UpdateLEDs(dev_idx, data, size);
+
+            delete[] data;
+
+            (*packets)++;
+        }
+
+        client->ControllerListMutex.unlock();
+
+        frame++;
+        next_frame += frame_time;
+
+        std::this_thread::sleep_until(next_frame);
+    }
+}
+
+static void PrintHelp()
+{
+    printf("OpenRGB SDK server benchmark\n\n");
+    printf("Usage: OpenRGBSDKBenchmark [options]\n\n");
+    printf("--devices N       Number of dummy devices on the server (default 4)\n");
+    printf("--leds N          Number of LEDs per dummy device (default 100)\n");
+    printf("--clients N       Number of synthetic SDK clients (default 1)\n");
+    printf("--rate N          UPDATELEDS frames per second per client, each frame updates every device (default 60)\n");
+    printf("--duration N      Measurement duration in seconds (default 10)\n");
+    printf("--port N          Loopback port for the benchmark server (default 16742)\n");
+}
+
+static bool ParseOptions(int argc, char* argv[], BenchmarkOptions* options)
+{
+    for(int arg_idx = 1; arg_idx < argc; arg_idx++)
+    {
+        std::string option = argv[arg_idx];
+
+        if(option == "--help" || option == "-h")
+        {
+            return false;
+        }
+
+        if(arg_idx + 1 >= argc)
+        {
+            printf("Error: Missing argument for %s\n", option.c_str());
+            return false;
+        }
+
+        unsigned long value = strtoul(argv[++arg_idx], NULL, 10);
+
+        if(value == 0)
+        {
+            printf("Error: Invalid argument for %s\n", option.c_str());
+            return false;
+        }
+
+        if(option == "--devices")
+        {
+            options->devices  = (unsigned int)value;
+        }
+        else if(option == "--leds")
+        {
+            options->leds     = (unsigned int)value;
+        }
+        else if(option == "--clients")
+        {
+            options->clients  = (unsigned int)value;
+        }
+        else if(option == "--rate")
+        {
+            options->rate     = (unsigned int)value;
+        }
+        else if(option == "--duration")
+        {
+            options->duration = (unsigned int)value;
+        }
+        else if(option == "--port" && value < 65536)
+        {
+            options->port     = (unsigned short)value;
+        }
+        else
+        {
+            printf("Error: Unknown option %s\n", option.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+
+    if(!ParseOptions(argc, argv, &options))
+    {
+        PrintHelp();
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    /*-----------------------------------------------------*\
+    | Fork the server before any threads are created        |
+    \*-----------------------------------------------------*/
+    int cmd_pipe[2];
+    int result_pipe[2];
+
+    if(pipe(cmd_pipe) != 0 || pipe(result_pipe) != 0)
+    {
+        perror("pipe");
+        return 1;
+    }
+
+    pid_t server_pid = fork();
+
+    if(server_pid < 0)
+    {
+        perror("fork");
+        return 1;
+    }
+
+    if(server_pid == 0)
+    {
+        close(cmd_pipe[1]);
+        close(result_pipe[0]);
+
+        return RunServer(options, cmd_pipe[0], result_pipe[1]);
+    }
+
+    close(cmd_pipe[0]);
+    close(result_pipe[1]);
+
+    char cmd;
+
+    if(read(result_pipe[0], &cmd, 1) != 1 || cmd != BENCHMARK_CMD_READY)
+    {
+        printf("Error: Benchmark server failed to start on port %hu\n", options.port);
+        waitpid(server_pid, NULL, 0);
+        return 1;
+    }
+
+    /*-----------------------------------------------------*\
+    | Connect the synthetic clients and wait until each has |
+    | received the full device list                         |
+    \*-----------------------------------------------------*/
+    std::vector<std::vector<RGBController *> *> client_controllers;
+    std::vector<NetworkClient *>                clients;
+
+    for(unsigned int client_idx = 0; client_idx < options.clients; client_idx++)
+    {
+        std::vector<RGBController *> * controller_list = new std::vector<RGBController *>();
+        NetworkClient *                client          = new NetworkClient(*controller_list);
+
+        client->SetIP("127.0.0.1");
+        client->SetPort(options.port);
+        client->SetName("OpenRGB SDK Benchmark " + std::to_string(client_idx));
+        client->StartClient();
+
+        client_controllers.push_back(controller_list);
+        clients.push_back(client);
+    }
+
+    for(unsigned int client_idx = 0; client_idx < clients.size(); client_idx++)
+    {
+        for(int timeout = 0; timeout < 1000 && !clients[client_idx]->GetOnline(); timeout++)
+        {
+            std::this_thread::sleep_for(10ms);
+        }
+
+        if(!clients[client_idx]->GetOnline() || clients[client_idx]->server_controllers.size() != options.devices)
+        {
+            printf("Error: Client %u failed to come online\n", client_idx);
+            kill(server_pid, SIGKILL);
+            waitpid(server_pid, NULL, 0);
+            return 1;
+        }
+    }
+
+    /*-----------------------------------------------------*\
+    | Run the measurement window                            |
+    \*-----------------------------------------------------*/
+    std::atomic<bool>               running(true);
+    std::atomic<unsigned long long> packets(0);
+    std::vector<std::thread *>      send_threads;
+
+    cmd = BENCHMARK_CMD_GO;
+    if(write(cmd_pipe[1], &cmd, 1) != 1)
+    {
+        return 1;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for(unsigned int client_idx = 0; client_idx < clients.size(); client_idx++)
+    {
+        send_threads.push_back(new std::thread(ClientSendThreadFunction, clients[client_idx], &options, &running, &packets));
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(options.duration));
+
+    running = false;
+
+    for(unsigned int thread_idx = 0; thread_idx < send_threads.size(); thread_idx++)
+    {
+        send_threads[thread_idx]->join();
+        delete send_threads[thread_idx];
+    }
+
+    double send_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    /*-----------------------------------------------------*\
+    | Let the server drain in-flight frames before stopping |
+    \*-----------------------------------------------------*/
+    std::this_thread::sleep_for(100ms);
+
+    BenchmarkServerResults results;
+
+    cmd = BENCHMARK_CMD_STOP;
+    if(write(cmd_pipe[1], &cmd, 1) != 1 || read(result_pipe[0], &results, sizeof(results)) != sizeof(results))
+    {
+        printf("Error: Failed to read results from benchmark server\n");
+        kill(server_pid, SIGKILL);
+        waitpid(server_pid, NULL, 0);
+        return 1;
+    }
+
+    waitpid(server_pid, NULL, 0);
+
+    for(unsigned int client_idx = 0; client_idx < clients.size(); client_idx++)
+    {
+        clients[client_idx]->StopClient();
+    }
+
+    /*-----------------------------------------------------*\
+    | Report                                                |
+    \*-----------------------------------------------------*/
+    double packets_per_second = (double)packets.load() / send_seconds;
+    double frames_per_second  = (double)results.frames_applied / results.wall_seconds;
+    double cpu_percent        = 100.0 * results.cpu_seconds / results.wall_seconds;
+
+    printf("\n");
+    printf("Devices:                 %u x %u LEDs\n", options.devices, options.leds);
+    printf("Clients:                 %u at %u frames/s\n", options.clients, options.rate);
+    printf("Duration:                %.2f s\n", send_seconds);
+    printf("UPDATELEDS sent:         %llu (%.1f packets/s)\n", packets.load(), packets_per_second);
+    printf("DeviceUpdateLEDs calls:  %llu (%.1f /s, frames arriving together are coalesced)\n", results.frames_applied, frames_per_second);
+    printf("Server CPU:              %.3f s (%.1f%% of one core)\n", results.cpu_seconds, cpu_percent);
+    printf("Latency p50:             %.0f us\n", results.latency_p50_us);
+    printf("Latency p99:             %.0f us\n", results.latency_p99_us);
+    printf("Latency mean:            %.0f us\n", results.latency_mean_us);
+    printf("Latency max:             %.0f us\n", results.latency_max_us);
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#-----------------------------------------------------------------------------------------------#
+# OpenRGB SDK Server Benchmark QMake Project                                                    #
+#                                                                                               #
+#   Standalone load generator for the OpenRGB SDK server.  Starts a NetworkServer with dummy    #
+#   devices and streams UPDATELEDS packets to it from synthetic NetworkClient instances over    #
+#   loopback.  Does not require Qt or any RGB hardware.                                         #
+#                                                                                               #
+#   Build:  qmake benchmarks/SDKBenchmark/SDKBenchmark.pro && make                              #
+#-----------------------------------------------------------------------------------------------#
+
+QT      -=                                                                                      \
+    core                                                                                        \
+    gui                                                                                         \
+
+CONFIG  +=  c++17                                                                               \
+            console                                                                             \
+            silent                                                                              \
+
+CONFIG  -=  app_bundle                                                                          \
+            qt                                                                                  \
+
+TARGET      = OpenRGBSDKBenchmark
+TEMPLATE    = app
+
+ROOT        = $$PWD/../..
+
+#-----------------------------------------------------------------------------------------------#
+# Build information used by LogManager                                                          #
+#-----------------------------------------------------------------------------------------------#
+GIT_COMMIT_ID           = $$system(git -C $$ROOT log -n 1 --pretty=format:"%H")
+GIT_COMMIT_DATE         = $$system(git -C $$ROOT log -n 1 --pretty=format:"%ci")
+
+DEFINES +=                                                                                      \
+    VERSION_STRING=\\"\"\"benchmark\\"\"\"                                                      \
+    GIT_COMMIT_ID=\\"\"\"$$GIT_COMMIT_ID\\"\"\"                                                 \
+    GIT_COMMIT_DATE=\\"\"\"$$GIT_COMMIT_DATE\\"\"\"                                             \
+
+INCLUDEPATH +=                                                                                  \
+    $$ROOT                                                                                      \
+    $$ROOT/dependencies/json                                                                    \
+    $$ROOT/hidapi_wrapper                                                                       \
+    $$ROOT/i2c_smbus                                                                            \
+    $$ROOT/net_port                                                                             \
+    $$ROOT/RGBController                                                                        \
+
+HEADERS +=                                                                                      \
+    $$ROOT/LogManager.h                                                                         \
+    $$ROOT/NetworkClient.h                                                                      \
+    $$ROOT/NetworkProtocol.h                                                                    \
+    $$ROOT/NetworkServer.h                                                                      \
+    $$ROOT/net_port/net_port.h                                                                  \
+    $$ROOT/RGBController/RGBController.h                                                        \
+    $$ROOT/RGBController/RGBController_Dummy.h                                                  \
+    $$ROOT/RGBController/RGBController_Network.h                                                \
+
+SOURCES +=                                                                                      \
+    SDKBenchmark.cpp                                                                            \
+    $$ROOT/LogManager.cpp                                                                       \
+    $$ROOT/NetworkClient.cpp                                                                    \
+    $$ROOT/NetworkProtocol.cpp                                                                  \
+    $$ROOT/NetworkServer.cpp                                                                    \
+    $$ROOT/net_port/net_port.cpp                                                                \
+    $$ROOT/RGBController/RGBController.cpp                                                      \
+    $$ROOT/RGBController/RGBController_Dummy.cpp                                                \
+    $$ROOT/RGBController/RGBController_Network.cpp                                              \
+
+#-----------------------------------------------------------------------------------------------#
+# Linux-specific Configuration                                                                  #
+#   hidapi is only needed for its header, which LogManager pulls in through ResourceManager.h   #
+#-----------------------------------------------------------------------------------------------#
+contains(QMAKE_PLATFORM, linux) {
+    CONFIG      += link_pkgconfig
+
+    packagesExist(hidapi-hidraw) {
+        PKGCONFIG += hidapi-hidraw
+    } else {
+        PKGCONFIG += hidapi
+    }
+
+    LIBS        += -lpthread
+}
+
+!unix {
+    error("The SDK benchmark uses fork() and is only supported on Linux and other Unix-like systems")
+}
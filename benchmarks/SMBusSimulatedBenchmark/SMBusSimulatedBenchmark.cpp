@@ -0,0 +1,305 @@
+/*---------------------------------------------------------*\
+| SMBusSimulatedBenchmark.cpp                               |
+|                                                           |
+|   Runs the DRAM update paths against the device models of |
+|   the simulated SMBus                                     |
+|                                                           |
+|   Measures the frame time of Corsair Vengeance Pro        |
+|   modules updated one after another and through a shared  |
+|   group updater, and counts the transactions of an ENE    |
+|   direct color update for the block size of the adapter.  |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CorsairVengeanceProController.h"
+#include "ENESMBusInterface_i2c_smbus.h"
+#include "i2c_smbus_group_updater.h"
+#include "i2c_smbus_simulated.h"
+
+#define BENCHMARK_CORSAIR_BASE_ADDR     0x58
+#define BENCHMARK_CORSAIR_MAX_MODULES   8
+#define BENCHMARK_ENE_ADDR              0x71
+#define BENCHMARK_ENE_LED_COUNT         10
+
+struct BenchmarkOptions
+{
+    unsigned int    frames          = 100;
+    unsigned int    modules         = 4;
+    unsigned int    latency_ns      = 0;
+};
+
+/*---------------------------------------------------------*\
+| Simulated bus of an adapter that takes shorter block      |
+| writes, such as the 3 bytes ENE used before the size was  |
+| probed                                                    |
+\*---------------------------------------------------------*/
+class BenchmarkShortBlockBus : public i2c_smbus_simulated
+{
+public:
+    BenchmarkShortBlockBus(int max_block_size)
+    {
+        this->max_block_size = max_block_size;
+    }
+
+    int probe_max_block_size()
+    {
+        return(max_block_size);
+    }
+
+private:
+    int             max_block_size;
+};
+
+static void PrintHelp()
+{
+    printf("OpenRGB simulated SMBus benchmark\n\n");
+    printf("Usage: OpenRGBSMBusSimulatedBenchmark [options]\n\n");
+    printf("--frames N        Color updates per mode (default 100)\n");
+    printf("--modules N       Corsair Vengeance Pro modules on the bus, 1 to 8 (default 4)\n");
+    printf("--latency-ns N    Simulated time of one transaction (default 0)\n");
+}
+
+static bool ParseOptions(int argc, char* argv[], BenchmarkOptions* options)
+{
+    for(int arg_idx = 1; arg_idx < argc; arg_idx++)
+    {
+        std::string option = argv[arg_idx];
+
+        if(option == "--help" || option == "-h")
+        {
+            return false;
+        }
+
+        if(arg_idx + 1 >= argc)
+        {
+            printf("Error: Missing argument for %s\n", option.c_str());
+            return false;
+        }
+
+        char*         end   = NULL;
+        unsigned long value = strtoul(argv[++arg_idx], &end, 10);
+
+        if(end == argv[arg_idx] || *end != '\0')
+        {
+            printf("Error: Invalid argument for %s\n", option.c_str());
+            return false;
+        }
+
+        if(option == "--frames" && value > 0)
+        {
+            options->frames         = (unsigned int)value;
+        }
+        else if(option == "--modules" && value > 0 && value <= BENCHMARK_CORSAIR_MAX_MODULES)
+        {
+            options->modules        = (unsigned int)value;
+        }
+        else if(option == "--latency-ns")
+        {
+            options->latency_ns     = (unsigned int)value;
+        }
+        else
+        {
+            printf("Error: Unknown option or invalid argument %s\n", option.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*---------------------------------------------------------*\
+| Updates the Vengeance Pro modules on a simulated bus.     |
+| Sequential gives every module its own group and updates   |
+| them one after another, as each module was updated before |
+| the group updater.  Grouped shares one group and updates  |
+| every module from its own thread for all of the frames,   |
+| as the controllers' update threads do.  Returns           |
+| milliseconds per frame                                    |
+\*---------------------------------------------------------*/
+static double RunCorsairFrames(const BenchmarkOptions& options, bool direct, bool grouped, unsigned int* crc_errors)
+{
+    i2c_smbus_simulated                                         bus;
+    std::vector<i2c_smbus_simulated_corsair_vengeance_pro*>     models;
+    std::vector<CorsairVengeanceProController*>                 controllers;
+    std::shared_ptr<i2c_smbus_group_updater>                    shared_group = std::make_shared<i2c_smbus_group_updater>(&bus);
+
+    snprintf(bus.device_name, 512, "Simulated DRAM");
+    bus.set_latency_ns(options.latency_ns);
+
+    for(unsigned int module_idx = 0; module_idx < options.modules; module_idx++)
+    {
+        u8 addr = (u8)(BENCHMARK_CORSAIR_BASE_ADDR + module_idx);
+
+        models.push_back(new i2c_smbus_simulated_corsair_vengeance_pro(addr));
+        bus.add_device(models.back());
+
+        if(grouped)
+        {
+            controllers.push_back(new CorsairVengeanceProController(&bus, addr, shared_group));
+        }
+        else
+        {
+            controllers.push_back(new CorsairVengeanceProController(&bus, addr, std::make_shared<i2c_smbus_group_updater>(&bus)));
+        }
+
+        controllers.back()->SetDirect(direct);
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if(grouped)
+    {
+        std::vector<std::thread> updaters;
+
+        for(std::size_t module_idx = 0; module_idx < controllers.size(); module_idx++)
+        {
+            CorsairVengeanceProController* controller = controllers[module_idx];
+
+            updaters.emplace_back([controller, &options]()
+            {
+                for(unsigned int frame_idx = 0; frame_idx < options.frames; frame_idx++)
+                {
+                    controller->SetAllColors((unsigned char)frame_idx, (unsigned char)(frame_idx * 2), (unsigned char)(frame_idx * 3));
+                    controller->ApplyColors();
+                }
+            });
+        }
+
+        for(std::size_t module_idx = 0; module_idx < updaters.size(); module_idx++)
+        {
+            updaters[module_idx].join();
+        }
+    }
+    else
+    {
+        for(unsigned int frame_idx = 0; frame_idx < options.frames; frame_idx++)
+        {
+            for(std::size_t module_idx = 0; module_idx < controllers.size(); module_idx++)
+            {
+                controllers[module_idx]->SetAllColors((unsigned char)frame_idx, (unsigned char)(frame_idx * 2), (unsigned char)(frame_idx * 3));
+                controllers[module_idx]->ApplyColors();
+            }
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    /*-----------------------------------------------------*\
+    | The models check the CRC of every direct packet, a    |
+    | bad packet means the frames were interleaved wrong    |
+    \*-----------------------------------------------------*/
+    *crc_errors = 0;
+
+    for(std::size_t module_idx = 0; module_idx < models.size(); module_idx++)
+    {
+        *crc_errors += models[module_idx]->crc_errors;
+    }
+
+    for(std::size_t module_idx = 0; module_idx < controllers.size(); module_idx++)
+    {
+        delete controllers[module_idx];
+    }
+
+    return(ms / options.frames);
+}
+
+/*---------------------------------------------------------*\
+| Writes the direct colors of an ENE controller, 3 bytes    |
+| per LED, and returns the transactions it took.  The data  |
+| is read back to check that no bytes were lost             |
+\*---------------------------------------------------------*/
+static unsigned long long RunENEColors(i2c_smbus_simulated* bus, int* max_block, bool* verified)
+{
+    ENESMBusInterface_i2c_smbus ene(bus);
+    unsigned char               colors[BENCHMARK_ENE_LED_COUNT * 3];
+
+    snprintf(bus->device_name, 512, "Simulated ENE");
+    bus->add_device(new i2c_smbus_simulated_ene(BENCHMARK_ENE_ADDR, "AUMA0-E6K5-0106", BENCHMARK_ENE_LED_COUNT));
+
+    for(unsigned int byte_idx = 0; byte_idx < sizeof(colors); byte_idx++)
+    {
+        colors[byte_idx] = (unsigned char)(byte_idx + 1);
+    }
+
+    bus->reset_client_stats();
+
+    ene.ENERegisterWriteBlocks(BENCHMARK_ENE_ADDR, 0x8100, colors, sizeof(colors));
+
+    std::vector<i2c_smbus_client_stats> stats        = bus->get_client_stats();
+    unsigned long long                  transactions = 0;
+
+    for(std::size_t stats_idx = 0; stats_idx < stats.size(); stats_idx++)
+    {
+        transactions += stats[stats_idx].transactions;
+    }
+
+    *max_block = ene.GetMaxBlock();
+    *verified  = true;
+
+    for(unsigned int byte_idx = 0; byte_idx < sizeof(colors); byte_idx++)
+    {
+        if(ene.ENERegisterRead(BENCHMARK_ENE_ADDR, (ene_register)(0x8100 + byte_idx)) != colors[byte_idx])
+        {
+            *verified = false;
+        }
+    }
+
+    return(transactions);
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+
+    if(!ParseOptions(argc, argv, &options))
+    {
+        PrintHelp();
+        return 1;
+    }
+
+    printf("Frames:                   %u x %u Corsair Vengeance Pro modules\n", options.frames, options.modules);
+    printf("Simulated latency:        %u ns\n", options.latency_ns);
+
+    for(int direct = 0; direct < 2; direct++)
+    {
+        unsigned int sequential_errors = 0;
+        unsigned int grouped_errors    = 0;
+
+        double sequential_ms = RunCorsairFrames(options, direct != 0, false, &sequential_errors);
+        double grouped_ms    = RunCorsairFrames(options, direct != 0, true,  &grouped_errors);
+
+        printf("%s mode:\n", direct ? "Direct" : "Register");
+        printf("  Sequential:             %8.3f ms/frame  %u CRC errors\n", sequential_ms, sequential_errors);
+        printf("  Grouped:                %8.3f ms/frame  %u CRC errors\n", grouped_ms, grouped_errors);
+    }
+
+    /*-----------------------------------------------------*\
+    | ENE direct colors with the default block size of the  |
+    | simulated bus and with 3 byte blocks                  |
+    \*-----------------------------------------------------*/
+    i2c_smbus_simulated     default_bus;
+    BenchmarkShortBlockBus  short_bus(3);
+
+    int                 default_block;
+    int                 short_block;
+    bool                default_verified;
+    bool                short_verified;
+    unsigned long long  default_transactions = RunENEColors(&default_bus, &default_block, &default_verified);
+    unsigned long long  short_transactions   = RunENEColors(&short_bus, &short_block, &short_verified);
+
+    printf("ENE colors:               %u LEDs\n", BENCHMARK_ENE_LED_COUNT);
+    printf("  %2d byte blocks:         %8llu transactions  %s\n", default_block, default_transactions, default_verified ? "verified" : "MISMATCH");
+    printf("  %2d byte blocks:         %8llu transactions  %s\n", short_block, short_transactions, short_verified ? "verified" : "MISMATCH");
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+#-----------------------------------------------------------------------------------------------#
+# OpenRGB Simulated SMBus Benchmark QMake Project                                               #
+#                                                                                               #
+#   Standalone benchmark running the Corsair Vengeance Pro and ENE DRAM update paths against    #
+#   the device models of the simulated SMBus.  Compares modules updated one after another with  #
+#   modules sharing a group updater, and counts the transactions of an ENE color update per     #
+#   block size.  Does not require Qt or any SMBus hardware.                                     #
+#                                                                                               #
+#   Build:  qmake benchmarks/SMBusSimulatedBenchmark/SMBusSimulatedBenchmark.pro && make        #
+#-----------------------------------------------------------------------------------------------#
+
+QT      -=                                                                                      \
+    core                                                                                        \
+    gui                                                                                         \
+
+CONFIG  +=  c++17                                                                               \
+            console                                                                             \
+            silent                                                                              \
+            thread                                                                              \
+
+CONFIG  -=  app_bundle                                                                          \
+            qt                                                                                  \
+
+TARGET      = OpenRGBSMBusSimulatedBenchmark
+TEMPLATE    = app
+
+ROOT        = $$PWD/../..
+
+#-----------------------------------------------------------------------------------------------#
+# Build information used by LogManager                                                          #
+#-----------------------------------------------------------------------------------------------#
+GIT_COMMIT_ID           = $$system(git -C $$ROOT log -n 1 --pretty=format:"%H")
+GIT_COMMIT_DATE         = $$system(git -C $$ROOT log -n 1 --pretty=format:"%ci")
+
+DEFINES +=                                                                                      \
+    VERSION_STRING=\\"\"\"benchmark\\"\"\"                                                      \
+    GIT_COMMIT_ID=\\"\"\"$$GIT_COMMIT_ID\\"\"\"                                                 \
+    GIT_COMMIT_DATE=\\"\"\"$$GIT_COMMIT_DATE\\"\"\"                                             \
+
+INCLUDEPATH +=                                                                                  \
+    $$ROOT                                                                                      \
+    $$ROOT/Controllers/CorsairVengeanceProController                                            \
+    $$ROOT/Controllers/ENESMBusController                                                       \
+    $$ROOT/Controllers/ENESMBusController/ENESMBusInterface                                     \
+    $$ROOT/dependencies/CRCpp                                                                   \
+    $$ROOT/dependencies/json                                                                    \
+    $$ROOT/hidapi_wrapper                                                                       \
+    $$ROOT/i2c_smbus                                                                            \
+
+HEADERS +=                                                                                      \
+    $$ROOT/LogManager.h                                                                         \
+    $$ROOT/Controllers/CorsairVengeanceProController/CorsairVengeanceProController.h            \
+    $$ROOT/Controllers/ENESMBusController/ENESMBusInterface/ENESMBusInterface.h                 \
+    $$ROOT/Controllers/ENESMBusController/ENESMBusInterface/ENESMBusInterface_i2c_smbus.h       \
+    $$ROOT/i2c_smbus/i2c_smbus.h                                                                \
+    $$ROOT/i2c_smbus/i2c_smbus_group_updater.h                                                  \
+    $$ROOT/i2c_smbus/i2c_smbus_register_cache.h                                                 \
+    $$ROOT/i2c_smbus/i2c_smbus_simulated.h                                                      \
+    $$ROOT/i2c_smbus/i2c_smbus_trace.h                                                          \
+
+SOURCES +=                                                                                      \
+    SMBusSimulatedBenchmark.cpp                                                                 \
+    $$ROOT/LogManager.cpp                                                                       \
+    $$ROOT/Controllers/CorsairVengeanceProController/CorsairVengeanceProController.cpp          \
+    $$ROOT/Controllers/ENESMBusController/ENESMBusInterface/ENESMBusInterface_i2c_smbus.cpp     \
+    $$ROOT/i2c_smbus/i2c_smbus.cpp                                                              \
+    $$ROOT/i2c_smbus/i2c_smbus_group_updater.cpp                                                \
+    $$ROOT/i2c_smbus/i2c_smbus_register_cache.cpp                                               \
+    $$ROOT/i2c_smbus/i2c_smbus_simulated.cpp                                                    \
+    $$ROOT/i2c_smbus/i2c_smbus_trace.cpp                                                        \
+
+#-----------------------------------------------------------------------------------------------#
+# hidapi is only needed for its header, which LogManager pulls in through ResourceManager.h     #
+#-----------------------------------------------------------------------------------------------#
+win32:INCLUDEPATH +=                                                                            \
+    $$ROOT/dependencies/hidapi-win/include                                                      \
+
+macx {
+    CONFIG      += link_pkgconfig
+
+    PKGCONFIG   += hidapi
+}
+
+#-----------------------------------------------------------------------------------------------#
+# Linux-specific Configuration                                                                  #
+#-----------------------------------------------------------------------------------------------#
+contains(QMAKE_PLATFORM, linux) {
+    CONFIG      += link_pkgconfig
+
+    packagesExist(hidapi-hidraw) {
+        PKGCONFIG += hidapi-hidraw
+    } else {
+        PKGCONFIG += hidapi
+    }
+
+    LIBS        += -lpthread
+}
@@ -0,0 +1,286 @@
+/*---------------------------------------------------------*\
+| SMBusSlaveSelectBenchmark.cpp                             |
+|                                                           |
+|   Compares the Linux SMBus transfer path selecting the    |
+|   slave address with I2C_SLAVE before every transfer with |
+|   the path that only selects it when it changes           |
+|                                                           |
+|   With --device the transfers go to an i2c-dev device,    |
+|   e.g. i2c-stub loaded with                               |
+|   modprobe i2c-stub chip_addr=0x70,0x71,0x72,0x73         |
+|   Without it every ioctl is replaced by a FIONREAD on a   |
+|   pipe and the registers are kept in memory, so the       |
+|   system call cost is still measured.                     |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include "i2c_smbus.h"
+
+#define BENCHMARK_FIRST_ADDR    0x70
+
+struct BenchmarkOptions
+{
+    std::string     device;
+    unsigned int    transactions    = 200000;
+    unsigned int    devices         = 1;
+};
+
+/*---------------------------------------------------------*\
+| Same transfer path as i2c_smbus_linux::i2c_smbus_xfer,    |
+| with the slave address cache switchable.  i2c_smbus_linux |
+| is not linked here as it pulls in the detection code      |
+\*---------------------------------------------------------*/
+class BenchmarkBus : public i2c_smbus_interface
+{
+public:
+    BenchmarkBus(int handle, bool in_memory, bool cache_slave)
+    {
+        this->handle        = handle;
+        this->in_memory     = in_memory;
+        this->cache_slave   = cache_slave;
+        slave_handle        = -1;
+        slave_addr          = -1;
+        selects             = 0;
+
+        memset(registers, 0, sizeof(registers));
+    }
+
+    s32 i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data)
+    {
+        if(!cache_slave || handle != slave_handle || addr != slave_addr)
+        {
+            selects++;
+
+            if(Ioctl(I2C_SLAVE, (void*)(unsigned long)addr) < 0)
+            {
+                slave_handle = -1;
+            }
+            else
+            {
+                slave_handle = handle;
+                slave_addr   = addr;
+            }
+        }
+
+        if(!in_memory)
+        {
+            struct i2c_smbus_ioctl_data args;
+
+            args.read_write = read_write;
+            args.command    = command;
+            args.size       = size;
+            args.data       = data;
+
+            return(Ioctl(I2C_SMBUS, &args));
+        }
+
+        Ioctl(I2C_SMBUS, NULL);
+
+        u8* reg = &registers[addr & 0x7F][command];
+
+        if(read_write == I2C_SMBUS_WRITE && size == I2C_SMBUS_BYTE_DATA)
+        {
+            *reg = data->byte;
+        }
+        else if(read_write == I2C_SMBUS_READ && size == I2C_SMBUS_BYTE_DATA)
+        {
+            data->byte = *reg;
+        }
+
+        return(0);
+    }
+
+    s32 i2c_xfer(u8 /*addr*/, char /*read_write*/, int* /*size*/, u8* /*data*/)
+    {
+        return(-1);
+    }
+
+    unsigned int    selects;
+
+private:
+    int Ioctl(unsigned long request, void* arg)
+    {
+        if(in_memory)
+        {
+            int available;
+
+            return(ioctl(handle, FIONREAD, &available));
+        }
+
+        return(ioctl(handle, request, arg));
+    }
+
+    int             handle;
+    bool            in_memory;
+    bool            cache_slave;
+    int             slave_handle;
+    int             slave_addr;
+    u8              registers[128][256];
+};
+
+static void PrintHelp()
+{
+    printf("OpenRGB SMBus slave select benchmark\n\n");
+    printf("Usage: OpenRGBSMBusSlaveSelectBenchmark [options]\n\n");
+    printf("--device PATH     i2c-dev device to use, e.g. an i2c-stub bus (default in-memory bus)\n");
+    printf("--transactions N  Transactions per mode (default 200000)\n");
+    printf("--devices N       Devices addressed in turn from 0x70 on (default 1)\n");
+}
+
+static bool ParseOptions(int argc, char* argv[], BenchmarkOptions* options)
+{
+    for(int arg_idx = 1; arg_idx < argc; arg_idx++)
+    {
+        std::string option = argv[arg_idx];
+
+        if(option == "--help" || option == "-h")
+        {
+            return false;
+        }
+
+        if(arg_idx + 1 >= argc)
+        {
+            printf("Error: Missing argument for %s\n", option.c_str());
+            return false;
+        }
+
+        if(option == "--device")
+        {
+            options->device = argv[++arg_idx];
+            continue;
+        }
+
+        char*         end   = NULL;
+        unsigned long value = strtoul(argv[++arg_idx], &end, 10);
+
+        if(end == argv[arg_idx] || *end != '\0' || value == 0)
+        {
+            printf("Error: Invalid argument for %s\n", option.c_str());
+            return false;
+        }
+
+        if(option == "--transactions")
+        {
+            options->transactions   = (unsigned int)value;
+        }
+        else if(option == "--devices" && value <= 0x80 - BENCHMARK_FIRST_ADDR)
+        {
+            options->devices        = (unsigned int)value;
+        }
+        else
+        {
+            printf("Error: Unknown option or invalid argument %s\n", option.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*---------------------------------------------------------*\
+| Runs of byte writes and reads to one device before moving |
+| to the next, the pattern of a DRAM controller update.     |
+| Returns transactions per second                           |
+\*---------------------------------------------------------*/
+static double RunTransactions(const BenchmarkOptions& options, int handle, bool cache_slave, unsigned int* selects)
+{
+    BenchmarkBus bus(handle, options.device.empty(), cache_slave);
+
+    bus.set_transfer_mode(I2C_SMBUS_TRANSFER_INLINE);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for(unsigned int transaction_idx = 0; transaction_idx < options.transactions; transaction_idx += 2)
+    {
+        u8 addr = (u8)(BENCHMARK_FIRST_ADDR + (transaction_idx / 64) % options.devices);
+
+        bus.i2c_smbus_write_byte_data(addr, 0x00, (u8)transaction_idx);
+        bus.i2c_smbus_read_byte_data(addr, 0x00);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    *selects = bus.selects;
+
+    return((double)options.transactions / seconds);
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+
+    if(!ParseOptions(argc, argv, &options))
+    {
+        PrintHelp();
+        return 1;
+    }
+
+    /*-----------------------------------------------------*\
+    | Open the device, or a pipe standing in for it         |
+    \*-----------------------------------------------------*/
+    int handle;
+    int pipe_fds[2] = { -1, -1 };
+
+    if(options.device.empty())
+    {
+        if(pipe(pipe_fds) < 0)
+        {
+            printf("Error: Cannot create pipe\n");
+            return 1;
+        }
+
+        handle = pipe_fds[0];
+    }
+    else
+    {
+        handle = open(options.device.c_str(), O_RDWR);
+
+        if(handle < 0)
+        {
+            printf("Error: Cannot open %s\n", options.device.c_str());
+            return 1;
+        }
+    }
+
+    unsigned int     selects_every  = 0;
+    unsigned int     selects_cached = 0;
+    BenchmarkOptions warmup         = options;
+
+    warmup.transactions = 1000;
+
+    RunTransactions(warmup, handle, false, &selects_every);
+    RunTransactions(warmup, handle, true,  &selects_cached);
+
+    double every_rate  = RunTransactions(options, handle, false, &selects_every);
+    double cached_rate = RunTransactions(options, handle, true,  &selects_cached);
+
+    printf("Bus:                      %s\n", options.device.empty() ? "in-memory" : options.device.c_str());
+    printf("Transactions:             %u to %u devices\n", options.transactions, options.devices);
+    printf("Select every transfer:    %12.0f transactions/s  %8.2f us each  %u selects\n", every_rate, 1000000.0 / every_rate, selects_every);
+    printf("Select on change:         %12.0f transactions/s  %8.2f us each  %u selects\n", cached_rate, 1000000.0 / cached_rate, selects_cached);
+    printf("Speedup:                  %12.2fx\n", cached_rate / every_rate);
+
+    if(options.device.empty())
+    {
+        close(pipe_fds[0]);
+        close(pipe_fds[1]);
+    }
+    else
+    {
+        close(handle);
+    }
+
+    return 0;
+}
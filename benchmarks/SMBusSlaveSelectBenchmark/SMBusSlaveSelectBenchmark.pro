@@ -0,0 +1,38 @@
+#-----------------------------------------------------------------------------------------------#
+# OpenRGB SMBus Slave Select Benchmark QMake Project                                            #
+#                                                                                               #
+#   Standalone benchmark comparing the Linux SMBus transfer path selecting the slave address    #
+#   before every transfer with the path that only selects it when it changes.  Runs against an  #
+#   i2c-dev device such as i2c-stub, or an in-memory bus without any SMBus hardware.            #
+#                                                                                               #
+#   Build:  qmake benchmarks/SMBusSlaveSelectBenchmark/SMBusSlaveSelectBenchmark.pro && make    #
+#-----------------------------------------------------------------------------------------------#
+
+QT      -=                                                                                      \
+    core                                                                                        \
+    gui                                                                                         \
+
+CONFIG  +=  c++17                                                                               \
+            console                                                                             \
+            silent                                                                              \
+            thread                                                                              \
+
+CONFIG  -=  app_bundle                                                                          \
+            qt                                                                                  \
+
+TARGET      = OpenRGBSMBusSlaveSelectBenchmark
+TEMPLATE    = app
+
+ROOT        = $$PWD/../..
+
+INCLUDEPATH +=                                                                                  \
+    $$ROOT/i2c_smbus                                                                            \
+
+HEADERS +=                                                                                      \
+    $$ROOT/i2c_smbus/i2c_smbus.h                                                                \
+    $$ROOT/i2c_smbus/i2c_smbus_trace.h                                                          \
+
+SOURCES +=                                                                                      \
+    $$ROOT/i2c_smbus/i2c_smbus.cpp                                                              \
+    $$ROOT/i2c_smbus/i2c_smbus_trace.cpp                                                        \
+    SMBusSlaveSelectBenchmark.cpp                                                               \
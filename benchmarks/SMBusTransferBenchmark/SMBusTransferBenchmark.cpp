@@ -0,0 +1,206 @@
+/*---------------------------------------------------------*\
+| SMBusTransferBenchmark.cpp                                |
+|                                                           |
+|   Compares SMBus transactions handed to the interface     |
+|   thread with transactions run inline on the calling      |
+|   thread                                                  |
+|                                                           |
+|   The simulated bus spends a configurable time in every   |
+|   transfer, zero measures the cost of the handoff alone.  |
+|   Several callers can share the bus, as controllers on    |
+|   one bus do.                                             |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "i2c_smbus.h"
+
+struct BenchmarkOptions
+{
+    unsigned int    transactions    = 100000;
+    unsigned int    callers         = 1;
+    unsigned int    transfer_ns     = 0;
+};
+
+/*---------------------------------------------------------*\
+| Bus that busy waits for the transfer time, like a driver  |
+| polling the controller status                             |
+\*---------------------------------------------------------*/
+class BenchmarkBus : public i2c_smbus_interface
+{
+public:
+    BenchmarkBus(unsigned int transfer_ns)
+    {
+        this->transfer_ns = transfer_ns;
+    }
+
+    s32 i2c_smbus_xfer(u8 /*addr*/, char read_write, u8 command, int /*size*/, i2c_smbus_data* data)
+    {
+        Wait();
+
+        if(read_write == I2C_SMBUS_READ && data != NULL)
+        {
+            data->byte = command;
+        }
+
+        return(0);
+    }
+
+    s32 i2c_xfer(u8 /*addr*/, char /*read_write*/, int* /*size*/, u8* /*data*/)
+    {
+        Wait();
+
+        return(0);
+    }
+
+private:
+    void Wait()
+    {
+        if(transfer_ns == 0)
+        {
+            return;
+        }
+
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(transfer_ns);
+
+        while(std::chrono::steady_clock::now() < end)
+        {
+        }
+    }
+
+    unsigned int    transfer_ns;
+};
+
+static void PrintHelp()
+{
+    printf("OpenRGB SMBus transfer benchmark\n\n");
+    printf("Usage: OpenRGBSMBusTransferBenchmark [options]\n\n");
+    printf("--transactions N  Transactions per caller and mode (default 100000)\n");
+    printf("--callers N       Threads sharing the bus (default 1)\n");
+    printf("--transfer-ns N   Simulated time of one transfer (default 0)\n");
+}
+
+static bool ParseOptions(int argc, char* argv[], BenchmarkOptions* options)
+{
+    for(int arg_idx = 1; arg_idx < argc; arg_idx++)
+    {
+        std::string option = argv[arg_idx];
+
+        if(option == "--help" || option == "-h")
+        {
+            return false;
+        }
+
+        if(arg_idx + 1 >= argc)
+        {
+            printf("Error: Missing argument for %s\n", option.c_str());
+            return false;
+        }
+
+        char*         end   = NULL;
+        unsigned long value = strtoul(argv[++arg_idx], &end, 10);
+
+        if(end == argv[arg_idx] || *end != '\0')
+        {
+            printf("Error: Invalid argument for %s\n", option.c_str());
+            return false;
+        }
+
+        if(option == "--transactions" && value > 0)
+        {
+            options->transactions   = (unsigned int)value;
+        }
+        else if(option == "--callers" && value > 0)
+        {
+            options->callers        = (unsigned int)value;
+        }
+        else if(option == "--transfer-ns")
+        {
+            options->transfer_ns    = (unsigned int)value;
+        }
+        else
+        {
+            printf("Error: Unknown option or invalid argument %s\n", option.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*---------------------------------------------------------*\
+| Alternating byte writes and reads, the pattern of a DRAM  |
+| controller update.  Returns transactions per second       |
+\*---------------------------------------------------------*/
+static double RunTransactions(const BenchmarkOptions& options, int mode)
+{
+    BenchmarkBus             bus(options.transfer_ns);
+    std::vector<std::thread> callers;
+
+    bus.set_transfer_mode(mode);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for(unsigned int caller_idx = 0; caller_idx < options.callers; caller_idx++)
+    {
+        callers.emplace_back([&bus, &options, caller_idx]()
+        {
+            u8 addr = (u8)(0x70 + caller_idx);
+
+            for(unsigned int transaction_idx = 0; transaction_idx < options.transactions; transaction_idx += 2)
+            {
+                bus.i2c_smbus_write_byte_data(addr, 0x00, (u8)transaction_idx);
+                bus.i2c_smbus_read_byte_data(addr, 0x81);
+            }
+        });
+    }
+
+    for(std::size_t caller_idx = 0; caller_idx < callers.size(); caller_idx++)
+    {
+        callers[caller_idx].join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return((double)options.transactions * options.callers / seconds);
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+
+    if(!ParseOptions(argc, argv, &options))
+    {
+        PrintHelp();
+        return 1;
+    }
+
+    /*-----------------------------------------------------*\
+    | Warm up both paths once so thread creation and page   |
+    | faults are not part of the measurement                |
+    \*-----------------------------------------------------*/
+    BenchmarkOptions warmup = options;
+
+    warmup.transactions = 1000;
+
+    RunTransactions(warmup, I2C_SMBUS_TRANSFER_THREAD);
+    RunTransactions(warmup, I2C_SMBUS_TRANSFER_INLINE);
+
+    double thread_rate = RunTransactions(options, I2C_SMBUS_TRANSFER_THREAD);
+    double inline_rate = RunTransactions(options, I2C_SMBUS_TRANSFER_INLINE);
+
+    printf("Transactions:             %u x %u callers\n", options.transactions, options.callers);
+    printf("Simulated transfer time:  %u ns\n", options.transfer_ns);
+    printf("Interface thread:         %12.0f transactions/s  %8.2f us each\n", thread_rate, 1000000.0 / thread_rate);
+    printf("Inline:                   %12.0f transactions/s  %8.2f us each\n", inline_rate, 1000000.0 / inline_rate);
+    printf("Speedup:                  %12.1fx\n", inline_rate / thread_rate);
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+#-----------------------------------------------------------------------------------------------#
+# OpenRGB SMBus Transfer Benchmark QMake Project                                                #
+#                                                                                               #
+#   Standalone benchmark comparing SMBus transactions handed to the interface thread with       #
+#   transactions run inline on the calling thread.  Uses a simulated bus, so it does not        #
+#   require Qt or any SMBus hardware.                                                           #
+#                                                                                               #
+#   Build:  qmake benchmarks/SMBusTransferBenchmark/SMBusTransferBenchmark.pro && make          #
+#-----------------------------------------------------------------------------------------------#
+
+QT      -=                                                                                      \
+    core                                                                                        \
+    gui                                                                                         \
+
+CONFIG  +=  c++17                                                                               \
+            console                                                                             \
+            silent                                                                              \
+            thread                                                                              \
+
+CONFIG  -=  app_bundle                                                                          \
+            qt                                                                                  \
+
+TARGET      = OpenRGBSMBusTransferBenchmark
+TEMPLATE    = app
+
+ROOT        = $$PWD/../..
+
+INCLUDEPATH +=                                                                                  \
+    $$ROOT/i2c_smbus                                                                            \
+
+HEADERS +=                                                                                      \
+    $$ROOT/i2c_smbus/i2c_smbus.h                                                                \
+    $$ROOT/i2c_smbus/i2c_smbus_trace.h                                                          \
+
+SOURCES +=                                                                                      \
+    $$ROOT/i2c_smbus/i2c_smbus.cpp                                                              \
+    $$ROOT/i2c_smbus/i2c_smbus_trace.cpp                                                        \
+    SMBusTransferBenchmark.cpp                                                                  \
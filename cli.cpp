@@ -424,6 +424,8 @@ void OptionHelp()
     help_text += "--config path                            Use a custom path instead of the global configuration directory.\n";
     help_text += "--nodetect                               Do not try to detect hardware at startup.\n";
     help_text += "--noautoconnect                          Do not try to autoconnect to a local server at startup.\n";
+    help_text += "--detection-profile                      Print the time, SMBus transactions, and devices found of each detector after detection.\n";
+    help_text += "                                           The profile is also saved to DetectionProfile.json in the configuration directory.\n";
     help_text += "--loglevel [0-6 | error | warning ...]   Set the log level (0: fatal to 6: trace).\n";
     help_text += "--print-source                           Print the source code file and line number for each log entry.\n";
     help_text += "-v,  --verbose                           Print log messages to stdout.\n";
@@ -1059,6 +1061,7 @@ int ProcessOptions(Options* options, std::vector<RGBController *>& rgb_controlle
             if((option == "--localconfig")
              ||(option == "--nodetect")
              ||(option == "--noautoconnect")
+             ||(option == "--detection-profile")
              ||(option == "--server")
              ||(option == "--gui")
              ||(option == "--i2c-tools" || option == "--yolo")
@@ -1345,6 +1348,15 @@ unsigned int cli_pre_detection(int argc, char* argv[])
             cfg_args++;
         }
 
+        /*---------------------------------------------------------*\
+        | --detection-profile (no arguments)                        |
+        \*---------------------------------------------------------*/
+        else if(option == "--detection-profile")
+        {
+            ResourceManager::get()->SetDetectionProfile(true);
+            cfg_args++;
+        }
+
         /*---------------------------------------------------------*\
         | --client                                                  |
         \*---------------------------------------------------------*/
@@ -1373,18 +1385,14 @@ unsigned int cli_pre_detection(int argc, char* argv[])
             client->SetName(titleString.c_str());
             client->SetPort(port_val);
 
-            client->StartClient();
-
-            for(int timeout = 0; timeout < 100; timeout++)
-            {
-                if(client->GetConnected())
-                {
-                    break;
-                }
-                std::this_thread::sleep_for(10ms);
-            }
+            /*-----------------------------------------------------*\
+            | Do not wait for the connection here.  Each client     |
+            | connects on its own thread and initialization waits   |
+            | for all of them against a single deadline             |
+            \*-----------------------------------------------------*/
+            ResourceManager::get()->RegisterNetworkClient(client);
 
-            ResourceManager::get()->GetClients().push_back(client);
+            client->StartClient();
 
             cfg_args++;
             arg_index++;
@@ -11,6 +11,10 @@
 \*---------------------------------------------------------*/
 
 #include "i2c_smbus.h"
+#include "i2c_smbus_trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <string.h>
 
 #ifdef WIN32
@@ -19,26 +23,301 @@
 #include <unistd.h>
 #endif
 
+static thread_local i2c_smbus_thread_stats thread_stats = { 0, 0 };
+
+// The Windows backends (NVAPI, ADL and the port I/O drivers) are only called from one
+// thread.  Elsewhere each transfer runs on the calling thread, which saves two context
+// switches per transaction
+#ifdef WIN32
+#define I2C_SMBUS_TRANSFER_DEFAULT  I2C_SMBUS_TRANSFER_THREAD
+#else
+#define I2C_SMBUS_TRANSFER_DEFAULT  I2C_SMBUS_TRANSFER_INLINE
+#endif
+
+// Consecutive failed transactions that degrade a device, and the retry backoff range
+#define I2C_SMBUS_DEGRADE_ERRORS    3
+#define I2C_SMBUS_RETRY_MIN_MS      250
+#define I2C_SMBUS_RETRY_MAX_MS      8000
+
 i2c_smbus_interface::i2c_smbus_interface()
 {
     i2c_smbus_start            = false;
     i2c_smbus_done             = false;
     this->port_id              = -1;
+    this->bus_id               = -1;
     this->pci_device           = -1;
     this->pci_vendor           = -1;
     this->pci_subsystem_device = -1;
     this->pci_subsystem_vendor = -1;
+    i2c_smbus_thread_running   = false;
+    i2c_smbus_thread           = NULL;
+    i2c_batch                  = NULL;
+    i2c_batch_count            = 0;
+    arbiter_next_ticket        = 0;
+    arbiter_serving_ticket     = 0;
+    arbiter_owner_addr         = 0;
+    arbiter_owner_count        = 0;
+    register_cache_generation  = 0;
+    max_block_size             = -1;
+    tracer                     = NULL;
+    trace_bus                  = I2C_SMBUS_TRACE_NO_BUS;
+    transfer_mode              = I2C_SMBUS_TRANSFER_DEFAULT;
+
+    reset_client_stats();
+
+    for(int addr = 0; addr < 128; addr++)
+    {
+        client_health[addr].acknowledged       = false;
+        client_health[addr].degraded           = false;
+        client_health[addr].retrying           = false;
+        client_health[addr].consecutive_errors = 0;
+        client_health[addr].backoff_ms         = I2C_SMBUS_RETRY_MIN_MS;
+    }
+
+    if(transfer_mode == I2C_SMBUS_TRANSFER_THREAD)
+    {
+        start_thread();
+    }
+}
+
+i2c_smbus_interface::~i2c_smbus_interface()
+{
+    if(i2c_smbus_thread != NULL)
+    {
+        i2c_smbus_thread_running = false;
+        i2c_smbus_start = true;
+        i2c_smbus_start_cv.notify_all();
+        i2c_smbus_thread->join();
+        delete i2c_smbus_thread;
+    }
+}
+
+void i2c_smbus_interface::start_thread()
+{
     i2c_smbus_thread_running   = true;
     i2c_smbus_thread           = new std::thread(&i2c_smbus_interface::i2c_smbus_thread_function, this);
 }
 
-i2c_smbus_interface::~i2c_smbus_interface()
+void i2c_smbus_interface::set_transfer_mode(int mode)
 {
-    i2c_smbus_thread_running = false;
-    i2c_smbus_start = true;
-    i2c_smbus_start_cv.notify_all();
-    i2c_smbus_thread->join();
-    delete i2c_smbus_thread;
+    xfer_lock(0, 0);
+
+    if(mode == I2C_SMBUS_TRANSFER_THREAD && i2c_smbus_thread == NULL)
+    {
+        start_thread();
+    }
+
+    transfer_mode = mode;
+
+    xfer_unlock();
+}
+
+int i2c_smbus_interface::get_transfer_mode()
+{
+    return(transfer_mode);
+}
+
+void i2c_smbus_interface::invalidate_register_caches()
+{
+    register_cache_generation++;
+}
+
+unsigned int i2c_smbus_interface::get_register_cache_generation()
+{
+    return(register_cache_generation);
+}
+
+void i2c_smbus_interface::set_tracer(i2c_smbus_tracer* tracer)
+{
+    xfer_lock(0, 0);
+
+    this->tracer    = tracer;
+    trace_bus       = (tracer != NULL) ? tracer->add_bus(this) : I2C_SMBUS_TRACE_NO_BUS;
+
+    xfer_unlock();
+}
+
+// The duration of a traced transaction runs from the bus grant until now
+void i2c_smbus_interface::trace_smbus(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data, s32 result)
+{
+    u8 flags = (read_write == I2C_SMBUS_READ && size != I2C_SMBUS_QUICK) ? I2C_SMBUS_TRACE_FLAG_READ : 0;
+
+    tracer->record(trace_bus, addr, flags, command, size, (const u8*)data, i2c_smbus_tracer::data_length(size, data), result, arbiter_grant_time, std::chrono::steady_clock::now());
+}
+
+void i2c_smbus_interface::trace_i2c(u8 addr, char read_write, int* size, u8* data, s32 result)
+{
+    u8 flags = I2C_SMBUS_TRACE_FLAG_I2C | ((read_write == I2C_SMBUS_READ) ? I2C_SMBUS_TRACE_FLAG_READ : 0);
+
+    tracer->record(trace_bus, addr, flags, 0, 0, data, (*size > 0) ? (unsigned int)*size : 0, result, arbiter_grant_time, std::chrono::steady_clock::now());
+}
+
+void i2c_smbus_interface::trace_batch(i2c_smbus_transaction* transactions, int count, s32 result)
+{
+    std::chrono::steady_clock::time_point end      = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration   duration = end - arbiter_grant_time;
+
+    for(int transaction_idx = 0; transaction_idx < count; transaction_idx++)
+    {
+        i2c_smbus_transaction* transaction = &transactions[transaction_idx];
+        u8                     flags       = I2C_SMBUS_TRACE_FLAG_BATCH;
+
+        if(transaction->read_write == I2C_SMBUS_READ && transaction->size != I2C_SMBUS_QUICK)
+        {
+            flags |= I2C_SMBUS_TRACE_FLAG_READ;
+        }
+
+        tracer->record(trace_bus, transaction->addr, flags, transaction->command, transaction->size,
+                       (const u8*)&transaction->data, i2c_smbus_tracer::data_length(transaction->size, &transaction->data), result,
+                       arbiter_grant_time + duration * transaction_idx / count,
+                       arbiter_grant_time + duration * (transaction_idx + 1) / count);
+    }
+}
+
+std::vector<i2c_smbus_client_stats> i2c_smbus_interface::get_client_stats()
+{
+    std::vector<i2c_smbus_client_stats> stats;
+    std::lock_guard<std::mutex>         guard(arbiter_mutex);
+
+    for(int addr = 0; addr < 128; addr++)
+    {
+        if(client_stats[addr].transactions > 0 || client_stats[addr].skipped > 0)
+        {
+            stats.push_back(client_stats[addr]);
+            stats.back().degraded = client_health[addr].degraded;
+        }
+    }
+
+    return(stats);
+}
+
+double i2c_smbus_interface::get_utilization()
+{
+    std::lock_guard<std::mutex> guard(arbiter_mutex);
+
+    double elapsed_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - client_stats_start).count();
+
+    if(elapsed_ns <= 0.0)
+    {
+        return(0.0);
+    }
+
+    return(client_busy_ns / elapsed_ns);
+}
+
+void i2c_smbus_interface::reset_client_stats()
+{
+    std::lock_guard<std::mutex> guard(arbiter_mutex);
+
+    for(int addr = 0; addr < 128; addr++)
+    {
+        memset(&client_stats[addr], 0, sizeof(client_stats[addr]));
+        client_stats[addr].addr = (u8)addr;
+    }
+
+    client_busy_ns      = 0;
+    client_stats_start  = std::chrono::steady_clock::now();
+}
+
+bool i2c_smbus_interface::is_degraded(u8 addr)
+{
+    std::lock_guard<std::mutex> guard(arbiter_mutex);
+
+    return(client_health[addr & 0x7F].degraded);
+}
+
+/*---------------------------------------------------------*\
+| Refuses a transfer that addresses a degraded device whose |
+| retry time has not come.  Otherwise the transfer goes     |
+| ahead, as the retry of the degraded devices it addresses  |
+\*---------------------------------------------------------*/
+bool i2c_smbus_interface::client_admit(const std::bitset<128>& addrs)
+{
+    std::lock_guard<std::mutex>             guard(arbiter_mutex);
+    std::chrono::steady_clock::time_point   now = std::chrono::steady_clock::now();
+
+    for(int addr = 0; addr < 128; addr++)
+    {
+        if(addrs[addr] && client_health[addr].degraded && (client_health[addr].retrying || now < client_health[addr].retry_time))
+        {
+            client_stats[addr].skipped++;
+            return(false);
+        }
+    }
+
+    for(int addr = 0; addr < 128; addr++)
+    {
+        if(addrs[addr] && client_health[addr].degraded)
+        {
+            client_health[addr].retrying = true;
+            client_stats[addr].retries++;
+        }
+    }
+
+    return(true);
+}
+
+// Doubles the backoff after a failed retry and schedules the next one
+static void back_off(i2c_smbus_client_health* health, std::chrono::steady_clock::time_point now)
+{
+    health->retrying    = false;
+    health->backoff_ms  = std::min(health->backoff_ms * 2, (unsigned int)I2C_SMBUS_RETRY_MAX_MS);
+    health->retry_time  = now + std::chrono::milliseconds(health->backoff_ms);
+}
+
+/*---------------------------------------------------------*\
+| Only devices that answered before count errors, so the    |
+| probing of empty addresses during detection is ignored.   |
+| A failed transfer to several devices does not tell which  |
+| one failed and is not counted against any of them         |
+\*---------------------------------------------------------*/
+void i2c_smbus_interface::client_result(const std::bitset<128>& addrs, s32 result)
+{
+    std::lock_guard<std::mutex>             guard(arbiter_mutex);
+    std::chrono::steady_clock::time_point   now = std::chrono::steady_clock::now();
+
+    for(int addr = 0; addr < 128; addr++)
+    {
+        if(!addrs[addr])
+        {
+            continue;
+        }
+
+        i2c_smbus_client_health* health = &client_health[addr];
+
+        if(result >= 0)
+        {
+            health->acknowledged        = true;
+            health->degraded            = false;
+            health->retrying            = false;
+            health->consecutive_errors  = 0;
+            health->backoff_ms          = I2C_SMBUS_RETRY_MIN_MS;
+        }
+        else if(addrs.count() > 1)
+        {
+            //The retry of a degraded device in the batch is used up, wait out the backoff again
+            if(health->retrying)
+            {
+                back_off(health, now);
+            }
+        }
+        else if(health->acknowledged)
+        {
+            client_stats[addr].errors++;
+            health->consecutive_errors++;
+
+            if(health->retrying)
+            {
+                back_off(health, now);
+            }
+            else if(!health->degraded && health->consecutive_errors >= I2C_SMBUS_DEGRADE_ERRORS)
+            {
+                health->degraded        = true;
+                health->backoff_ms      = I2C_SMBUS_RETRY_MIN_MS;
+                health->retry_time      = now + std::chrono::milliseconds(health->backoff_ms);
+            }
+        }
+    }
 }
 
 s32 i2c_smbus_interface::i2c_smbus_write_quick(u8 addr, u8 value)
@@ -161,15 +440,110 @@ s32 i2c_smbus_interface::i2c_smbus_write_i2c_block_data(u8 addr, u8 command, u8
     return i2c_smbus_xfer_call(addr, I2C_SMBUS_WRITE, command, I2C_SMBUS_I2C_BLOCK_DATA, &data);
 }
 
+i2c_smbus_thread_stats i2c_smbus_interface::get_thread_stats()
+{
+    return(thread_stats);
+}
+
+// Waits for the bus in ticket order.  count is the number of transactions to run, zero
+// takes the bus without counting it as bus activity
+void i2c_smbus_interface::xfer_lock(u8 addr, int count)
+{
+    thread_stats.transactions += count;
+
+    std::unique_lock<std::mutex> lock(arbiter_mutex);
+
+    unsigned long long ticket  = arbiter_next_ticket++;
+    unsigned long long wait_ns = 0;
+
+    if(ticket != arbiter_serving_ticket)
+    {
+        std::chrono::steady_clock::time_point wait_start = std::chrono::steady_clock::now();
+
+        arbiter_cv.wait(lock, [this, ticket]{ return arbiter_serving_ticket == ticket; });
+
+        wait_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wait_start).count();
+
+        thread_stats.blocked_ns += wait_ns;
+    }
+
+    arbiter_owner_addr  = addr & 0x7F;
+    arbiter_owner_count = count;
+
+    if(count > 0)
+    {
+        i2c_smbus_client_stats* client = &client_stats[arbiter_owner_addr];
+
+        client->transactions += count;
+        client->wait_ns      += wait_ns;
+
+        if(wait_ns > client->max_wait_ns)
+        {
+            client->max_wait_ns = wait_ns;
+        }
+    }
+
+    arbiter_grant_time = std::chrono::steady_clock::now();
+}
+
+// Passes the bus to the next waiting caller
+void i2c_smbus_interface::xfer_unlock()
+{
+    std::chrono::steady_clock::time_point release_time = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> guard(arbiter_mutex);
+
+    if(arbiter_owner_count > 0)
+    {
+        unsigned long long busy_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(release_time - arbiter_grant_time).count();
+
+        client_stats[arbiter_owner_addr].busy_ns += busy_ns;
+        client_busy_ns                           += busy_ns;
+    }
+
+    arbiter_serving_ticket++;
+
+    if(arbiter_serving_ticket != arbiter_next_ticket)
+    {
+        arbiter_cv.notify_all();
+    }
+}
+
 s32 i2c_smbus_interface::i2c_smbus_xfer_call(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data)
 {
-    i2c_smbus_xfer_mutex.lock();
+    std::bitset<128> addrs;
+
+    addrs.set(addr & 0x7F);
+
+    if(!client_admit(addrs))
+    {
+        return(-EBUSY);
+    }
+
+    xfer_lock(addr, 1);
+
+    if(transfer_mode == I2C_SMBUS_TRANSFER_INLINE)
+    {
+        s32 ret = i2c_smbus_xfer(addr, read_write, command, size, data);
+
+        if(tracer != NULL)
+        {
+            trace_smbus(addr, read_write, command, size, data, ret);
+        }
+
+        xfer_unlock();
+
+        client_result(addrs, ret);
+
+        return(ret);
+    }
 
     i2c_addr        = addr;
     i2c_read_write  = read_write;
     i2c_command     = command;
     i2c_size_smbus  = size;
     i2c_data_smbus  = data;
+    i2c_batch       = NULL;
     smbus_xfer      = true;
 
     std::unique_lock<std::mutex> start_lock(i2c_smbus_start_mutex);
@@ -182,19 +556,54 @@ s32 i2c_smbus_interface::i2c_smbus_xfer_call(u8 addr, char read_write, u8 comman
     i2c_smbus_done_cv.wait(done_lock, [this]{ return i2c_smbus_done.load(); });
     i2c_smbus_done  = false;
 
-    i2c_smbus_xfer_mutex.unlock();
+    if(tracer != NULL)
+    {
+        trace_smbus(addr, read_write, command, size, data, i2c_ret);
+    }
+
+    s32 ret = i2c_ret;
 
-    return(i2c_ret);
+    xfer_unlock();
+
+    client_result(addrs, ret);
+
+    return(ret);
 }
 
 s32 i2c_smbus_interface::i2c_xfer_call(u8 addr, char read_write, int* size, u8 *data)
 {
-    i2c_smbus_xfer_mutex.lock();
+    std::bitset<128> addrs;
+
+    addrs.set(addr & 0x7F);
+
+    if(!client_admit(addrs))
+    {
+        return(-EBUSY);
+    }
+
+    xfer_lock(addr, 1);
+
+    if(transfer_mode == I2C_SMBUS_TRANSFER_INLINE)
+    {
+        s32 ret = i2c_xfer(addr, read_write, size, data);
+
+        if(tracer != NULL)
+        {
+            trace_i2c(addr, read_write, size, data, ret);
+        }
+
+        xfer_unlock();
+
+        client_result(addrs, ret);
+
+        return(ret);
+    }
 
     i2c_addr        = addr;
     i2c_read_write  = read_write;
     i2c_size        = size;
     i2c_data        = data;
+    i2c_batch       = NULL;
     smbus_xfer      = false;
 
     std::unique_lock<std::mutex> start_lock(i2c_smbus_start_mutex);
@@ -207,9 +616,126 @@ s32 i2c_smbus_interface::i2c_xfer_call(u8 addr, char read_write, int* size, u8 *
     i2c_smbus_done_cv.wait(done_lock, [this]{ return i2c_smbus_done.load(); });
     i2c_smbus_done  = false;
 
-    i2c_smbus_xfer_mutex.unlock();
+    if(tracer != NULL)
+    {
+        trace_i2c(addr, read_write, size, data, i2c_ret);
+    }
+
+    s32 ret = i2c_ret;
+
+    xfer_unlock();
 
-    return(i2c_ret);
+    client_result(addrs, ret);
+
+    return(ret);
+}
+
+s32 i2c_smbus_interface::i2c_smbus_xfer_batch_call(i2c_smbus_transaction* transactions, int count)
+{
+    if(count <= 0)
+    {
+        return 0;
+    }
+
+    std::bitset<128> addrs;
+
+    for(int transaction_idx = 0; transaction_idx < count; transaction_idx++)
+    {
+        addrs.set(transactions[transaction_idx].addr & 0x7F);
+    }
+
+    if(!client_admit(addrs))
+    {
+        return(-EBUSY);
+    }
+
+    xfer_lock(transactions[0].addr, count);
+
+    if(transfer_mode == I2C_SMBUS_TRANSFER_INLINE)
+    {
+        s32 ret = i2c_smbus_xfer_batch(transactions, count);
+
+        if(tracer != NULL)
+        {
+            trace_batch(transactions, count, ret);
+        }
+
+        xfer_unlock();
+
+        client_result(addrs, ret);
+
+        return(ret);
+    }
+
+    i2c_batch       = transactions;
+    i2c_batch_count = count;
+
+    std::unique_lock<std::mutex> start_lock(i2c_smbus_start_mutex);
+    i2c_smbus_start = true;
+    i2c_smbus_start_cv.notify_all();
+    start_lock.unlock();
+
+    std::unique_lock<std::mutex> done_lock(i2c_smbus_done_mutex);
+
+    i2c_smbus_done_cv.wait(done_lock, [this]{ return i2c_smbus_done.load(); });
+    i2c_smbus_done  = false;
+
+    if(tracer != NULL)
+    {
+        trace_batch(transactions, count, i2c_ret);
+    }
+
+    s32 ret = i2c_ret;
+
+    xfer_unlock();
+
+    client_result(addrs, ret);
+
+    return(ret);
+}
+
+s32 i2c_smbus_interface::i2c_smbus_xfer_batch(i2c_smbus_transaction* transactions, int count)
+{
+    for(int transaction_idx = 0; transaction_idx < count; transaction_idx++)
+    {
+        i2c_smbus_transaction* transaction = &transactions[transaction_idx];
+
+        s32 ret = i2c_smbus_xfer(transaction->addr, transaction->read_write, transaction->command, transaction->size, &transaction->data);
+
+        if(ret != 0)
+        {
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+int i2c_smbus_interface::get_max_block_size()
+{
+    if(max_block_size < 0)
+    {
+        /*-------------------------------------------------*\
+        | The probe may query the adapter, hold the bus so  |
+        | it does not run during a transfer or a second     |
+        | probe from another thread                         |
+        \*-------------------------------------------------*/
+        xfer_lock(0, 0);
+
+        if(max_block_size < 0)
+        {
+            max_block_size = probe_max_block_size();
+        }
+
+        xfer_unlock();
+    }
+
+    return(max_block_size);
+}
+
+int i2c_smbus_interface::probe_max_block_size()
+{
+    return(I2C_SMBUS_BLOCK_MAX);
 }
 
 s32 i2c_smbus_interface::i2c_read_block(u8 addr, int* size, u8* data)
@@ -236,7 +762,11 @@ void i2c_smbus_interface::i2c_smbus_thread_function()
             break;
         }
 
-        if(smbus_xfer)
+        if(i2c_batch != NULL)
+        {
+            i2c_ret = i2c_smbus_xfer_batch(i2c_batch, i2c_batch_count);
+        }
+        else if(smbus_xfer)
         {
             i2c_ret = i2c_smbus_xfer(i2c_addr, i2c_read_write, i2c_command, i2c_size_smbus, i2c_data_smbus);
         }
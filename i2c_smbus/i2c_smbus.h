@@ -14,9 +14,12 @@
 #define I2C_SMBUS_H
 
 #include <atomic>
+#include <bitset>
+#include <chrono>
 #include <thread>
 #include <condition_variable>
 #include <mutex>
+#include <vector>
 
 typedef unsigned char   u8;
 typedef unsigned short  u16;
@@ -72,6 +75,53 @@ union i2c_smbus_data
 #define I2C_SMBUS_BLOCK_PROC_CALL   7           /* SMBus 2.0 */
 #define I2C_SMBUS_I2C_BLOCK_DATA    8
 
+// Transfer modes
+#define I2C_SMBUS_TRANSFER_INLINE   0           /* On the calling thread    */
+#define I2C_SMBUS_TRANSFER_THREAD   1           /* On the interface thread  */
+
+// One SMBus transaction of a batch, the arguments of i2c_smbus_xfer
+typedef struct
+{
+    u8                  addr;
+    char                read_write;
+    u8                  command;
+    int                 size;
+    i2c_smbus_data      data;
+} i2c_smbus_transaction;
+
+// SMBus/I2C activity of the calling thread, summed over all interfaces
+typedef struct
+{
+    unsigned long long  transactions;
+    unsigned long long  blocked_ns;
+} i2c_smbus_thread_stats;
+
+// Bus activity of one slave address on an interface, that is, of one controller
+typedef struct
+{
+    u8                  addr;
+    unsigned long long  transactions;
+    unsigned long long  busy_ns;
+    unsigned long long  wait_ns;
+    unsigned long long  max_wait_ns;
+    unsigned long long  errors;             /* Failed transactions of a device that answered    */
+    unsigned long long  retries;            /* Transfers let through to a degraded device       */
+    unsigned long long  skipped;            /* Transfers failed while the device was degraded   */
+    bool                degraded;
+} i2c_smbus_client_stats;
+
+// Error recovery state of one slave address
+typedef struct
+{
+    bool                acknowledged;       /* Has completed a transaction                      */
+    bool                degraded;
+    bool                retrying;           /* A retry transfer is on the bus                   */
+    unsigned int        consecutive_errors;
+    unsigned int        backoff_ms;
+    std::chrono::steady_clock::time_point retry_time;
+} i2c_smbus_client_health;
+
+class i2c_smbus_tracer;
 
 class i2c_smbus_interface
 {
@@ -79,6 +129,7 @@ public:
     char device_name[512];
 
     int port_id;
+    int bus_id;                 /* Index in the registered bus list, -1 before registration */
     int pci_device;
     int pci_vendor;
     int pci_subsystem_device;
@@ -106,6 +157,10 @@ public:
     s32 i2c_read_block(u8 addr, int* size, u8* data);
     s32 i2c_write_block(u8 addr, int size, u8* data);
 
+    //Runs a list of transactions in order without releasing the bus.  Stops at the first
+    //failed transaction and returns its error, read data is returned in the transactions
+    s32 i2c_smbus_xfer_batch_call(i2c_smbus_transaction* transactions, int count);
+
     //Handle SMBus and I2C transfer calls in a single thread
     s32 i2c_smbus_xfer_call(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
     s32 i2c_xfer_call(u8 addr, char read_write, int* size, u8 *data);
@@ -113,7 +168,55 @@ public:
     virtual s32 i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data) = 0;
     virtual s32 i2c_xfer(u8 addr, char read_write, int* size, u8* data) = 0;
 
+    //Drivers that can submit several transactions at once override this, the default runs
+    //them one at a time through i2c_smbus_xfer
+    virtual s32 i2c_smbus_xfer_batch(i2c_smbus_transaction* transactions, int count);
+
+    //Largest SMBus block write the adapter takes, 0 when it can not send block writes.
+    //Probed once with the bus held, RegisterI2CBus probes it before the bus is published
+    int get_max_block_size();
+
+    //Drivers whose adapter takes shorter block writes than I2C_SMBUS_BLOCK_MAX override this
+    virtual int probe_max_block_size();
+
+    //Transaction count and time spent waiting for busy interfaces on the calling thread
+    static i2c_smbus_thread_stats get_thread_stats();
+
+    //Run transfers inline under the bus mutex, or hand them to the interface thread for
+    //backends that must only be called from a single thread
+    void set_transfer_mode(int mode);
+    int  get_transfer_mode();
+
+    //Bus time and wait time per slave address since the last reset, and the fraction of
+    //that time the bus was in use
+    std::vector<i2c_smbus_client_stats> get_client_stats();
+    double get_utilization();
+    void   reset_client_stats();
+
+    //A device that fails several transactions in a row is degraded.  Its transfers fail
+    //right away with -EBUSY instead of holding the bus, until a backoff timer lets the
+    //next one through as a retry.  A successful transfer clears the state
+    bool   is_degraded(u8 addr);
+
+    //Makes the register caches of the devices on this bus forget their contents, for when
+    //the devices may have lost their state, e.g. after a resume
+    void         invalidate_register_caches();
+    unsigned int get_register_cache_generation();
+
+    //Records every transaction on this bus with the tracer, NULL stops the recording
+    void set_tracer(i2c_smbus_tracer* tracer);
+
 private:
+    void xfer_lock(u8 addr, int count);
+    void xfer_unlock();
+    bool client_admit(const std::bitset<128>& addrs);
+    void client_result(const std::bitset<128>& addrs, s32 result);
+    void start_thread();
+
+    void trace_smbus(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data, s32 result);
+    void trace_i2c(u8 addr, char read_write, int* size, u8* data, s32 result);
+    void trace_batch(i2c_smbus_transaction* transactions, int count, s32 result);
+
     std::thread *           i2c_smbus_thread;
     std::atomic<bool>       i2c_smbus_thread_running;
 
@@ -125,17 +228,41 @@ private:
     std::condition_variable i2c_smbus_done_cv;
     std::mutex              i2c_smbus_done_mutex;
 
-    std::mutex              i2c_smbus_xfer_mutex;
-
-    u8                  i2c_addr;
-    char                i2c_read_write;
-    u8                  i2c_command;
-    int                 i2c_size_smbus;
-    int*                i2c_size;
-    i2c_smbus_data*     i2c_data_smbus;
-    u8*                 i2c_data;
-    s32                 i2c_ret;
-    bool                smbus_xfer;
+    //Callers are served in the order they asked for the bus, so a controller that sends
+    //transactions back to back can not starve the other controllers on the bus
+    std::mutex              arbiter_mutex;
+    std::condition_variable arbiter_cv;
+    unsigned long long      arbiter_next_ticket;
+    unsigned long long      arbiter_serving_ticket;
+    u8                      arbiter_owner_addr;
+    int                     arbiter_owner_count;
+    std::chrono::steady_clock::time_point arbiter_grant_time;
+
+    std::chrono::steady_clock::time_point client_stats_start;
+    unsigned long long      client_busy_ns;
+    i2c_smbus_client_stats  client_stats[128];
+    i2c_smbus_client_health client_health[128];
+
+    std::atomic<unsigned int> register_cache_generation;
+
+    std::atomic<int>        max_block_size;
+
+    i2c_smbus_tracer*       tracer;
+    u8                      trace_bus;
+
+    int                     transfer_mode;
+
+    u8                      i2c_addr;
+    char                    i2c_read_write;
+    u8                      i2c_command;
+    int                     i2c_size_smbus;
+    int*                    i2c_size;
+    i2c_smbus_data*         i2c_data_smbus;
+    u8*                     i2c_data;
+    i2c_smbus_transaction*  i2c_batch;
+    int                     i2c_batch_count;
+    s32                     i2c_ret;
+    bool                    smbus_xfer;
 };
 
 #endif /* I2C_SMBUS_H */
@@ -0,0 +1,268 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_group_updater.cpp                               |
+|                                                           |
+|   Sends the frames of the modules on a bus, such as the   |
+|   DIMMs of a memory kit, interleaved in shared batches    |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <cstring>
+#include <thread>
+#include "i2c_smbus_group_updater.h"
+
+i2c_smbus_group_updater::i2c_smbus_group_updater(i2c_smbus_interface* bus)
+{
+    this->bus   = bus;
+    members     = 0;
+    sending     = false;
+    ready_time  = std::chrono::steady_clock::now();
+}
+
+void i2c_smbus_group_updater::add_member()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    members++;
+}
+
+void i2c_smbus_group_updater::remove_member()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if(members > 0)
+    {
+        members--;
+    }
+
+    cv.notify_all();
+}
+
+s32 i2c_smbus_group_updater::update(u8 addr, const i2c_smbus_frame& frame)
+{
+    /*-----------------------------------------------------*\
+    | Without a settle time to overlap, waiting for the     |
+    | other members only delays the frame                   |
+    \*-----------------------------------------------------*/
+    if(frame.size() == 1 && frame[0].settle.count() == 0)
+    {
+        std::vector<i2c_smbus_transaction> transactions = frame[0].transactions;
+
+        if(transactions.empty())
+        {
+            return(0);
+        }
+
+        return(bus->i2c_smbus_xfer_batch_call(transactions.data(), (int)transactions.size()));
+    }
+
+    i2c_smbus_group_request request;
+
+    request.addr    = addr;
+    request.frame   = &frame;
+    request.result  = 0;
+    request.done    = false;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    last_update[addr] = std::chrono::steady_clock::now();
+
+    queued.push_back(&request);
+    cv.notify_all();
+
+    /*-----------------------------------------------------*\
+    | The first caller that finds the bus idle waits for    |
+    | the frames of the active members and sends every      |
+    | frame queued so far, the other callers wait until     |
+    | theirs has been sent                                  |
+    \*-----------------------------------------------------*/
+    while(!request.done)
+    {
+        if(sending)
+        {
+            cv.wait(lock);
+            continue;
+        }
+
+        sending = true;
+
+        std::chrono::steady_clock::time_point gather_start = std::chrono::steady_clock::now();
+        unsigned int                          active       = active_members(gather_start);
+
+        cv.wait_until(lock, gather_start + I2C_SMBUS_GROUP_GATHER_TIME, [this, active]{ return(queued.size() >= active); });
+
+        std::vector<i2c_smbus_group_request*> requests;
+
+        requests.swap(queued);
+
+        lock.unlock();
+        send(requests);
+        lock.lock();
+
+        for(std::size_t request_idx = 0; request_idx < requests.size(); request_idx++)
+        {
+            requests[request_idx]->done = true;
+        }
+
+        sending = false;
+        cv.notify_all();
+    }
+
+    return(request.result);
+}
+
+/*---------------------------------------------------------*\
+| Members that sent a frame recently, at most the member    |
+| count.  Addresses that have been idle are forgotten       |
+\*---------------------------------------------------------*/
+unsigned int i2c_smbus_group_updater::active_members(std::chrono::steady_clock::time_point now)
+{
+    unsigned int active = 0;
+
+    for(i2c_smbus_group_activity::iterator it = last_update.begin(); it != last_update.end();)
+    {
+        if(now - it->second > I2C_SMBUS_GROUP_ACTIVE_TIME)
+        {
+            it = last_update.erase(it);
+        }
+        else
+        {
+            active++;
+            it++;
+        }
+    }
+
+    if(active > members)
+    {
+        active = members;
+    }
+
+    return(active);
+}
+
+void i2c_smbus_group_updater::send(std::vector<i2c_smbus_group_request*>& requests)
+{
+    std::vector<i2c_smbus_transaction>      batch;
+    std::vector<i2c_smbus_group_request*>   batch_requests;
+    std::vector<std::size_t>                batch_offsets;
+
+    for(std::size_t step_idx = 0; ; step_idx++)
+    {
+        std::chrono::microseconds settle(0);
+
+        batch.clear();
+        batch_requests.clear();
+        batch_offsets.clear();
+
+        /*-------------------------------------------------*\
+        | Queue step n of every module that has one and     |
+        | has not failed an earlier step                    |
+        \*-------------------------------------------------*/
+        bool steps_left = false;
+
+        for(std::size_t request_idx = 0; request_idx < requests.size(); request_idx++)
+        {
+            i2c_smbus_group_request* request = requests[request_idx];
+
+            if(step_idx >= request->frame->size())
+            {
+                continue;
+            }
+
+            steps_left = true;
+
+            if(request->result < 0)
+            {
+                continue;
+            }
+
+            const i2c_smbus_frame_step& step = (*request->frame)[step_idx];
+
+            batch_requests.push_back(request);
+            batch_offsets.push_back(batch.size());
+            batch.insert(batch.end(), step.transactions.begin(), step.transactions.end());
+
+            if(step.settle > settle)
+            {
+                settle = step.settle;
+            }
+        }
+
+        if(!steps_left)
+        {
+            break;
+        }
+
+        if(batch.empty())
+        {
+            continue;
+        }
+
+        /*-------------------------------------------------*\
+        | Wait for the modules to settle from the previous  |
+        | step once, for all of them                        |
+        \*-------------------------------------------------*/
+        std::this_thread::sleep_until(ready_time);
+
+        s32 result = bus->i2c_smbus_xfer_batch_call(batch.data(), (int)batch.size());
+
+        /*-------------------------------------------------*\
+        | A failed batch does not tell which transaction    |
+        | failed, send the step of each module on its own   |
+        | so one missing module does not fail the others    |
+        \*-------------------------------------------------*/
+        if(result < 0)
+        {
+            for(std::size_t module_idx = 0; module_idx < batch_requests.size(); module_idx++)
+            {
+                std::size_t start = batch_offsets[module_idx];
+                std::size_t end   = (module_idx + 1 < batch_offsets.size()) ? batch_offsets[module_idx + 1] : batch.size();
+
+                if(batch_requests.size() > 1)
+                {
+                    batch_requests[module_idx]->result = bus->i2c_smbus_xfer_batch_call(&batch[start], (int)(end - start));
+                }
+                else
+                {
+                    batch_requests[module_idx]->result = result;
+                }
+            }
+        }
+
+        ready_time = std::chrono::steady_clock::now() + settle;
+    }
+}
+
+void i2c_smbus_group_updater::add_write_byte_data(i2c_smbus_frame_step* step, u8 addr, u8 command, u8 value)
+{
+    i2c_smbus_transaction transaction;
+
+    transaction.addr        = addr;
+    transaction.read_write  = I2C_SMBUS_WRITE;
+    transaction.command     = command;
+    transaction.size        = I2C_SMBUS_BYTE_DATA;
+    transaction.data.byte   = value;
+
+    step->transactions.push_back(transaction);
+}
+
+void i2c_smbus_group_updater::add_write_block_data(i2c_smbus_frame_step* step, u8 addr, u8 command, u8 length, const u8* values)
+{
+    i2c_smbus_transaction transaction;
+
+    if(length > I2C_SMBUS_BLOCK_MAX)
+    {
+        length = I2C_SMBUS_BLOCK_MAX;
+    }
+
+    transaction.addr            = addr;
+    transaction.read_write      = I2C_SMBUS_WRITE;
+    transaction.command         = command;
+    transaction.size            = I2C_SMBUS_BLOCK_DATA;
+    transaction.data.block[0]   = length;
+
+    memcpy(&transaction.data.block[1], values, length);
+
+    step->transactions.push_back(transaction);
+}
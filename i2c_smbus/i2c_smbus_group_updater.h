@@ -0,0 +1,91 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_group_updater.h                                 |
+|                                                           |
+|   Sends the frames of the modules on a bus, such as the   |
+|   DIMMs of a memory kit, interleaved in shared batches    |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "i2c_smbus.h"
+
+/*---------------------------------------------------------*\
+| How long the first module of an update waits for the      |
+| frames of the other modules before the batch is sent.     |
+| Controllers poll for updates every millisecond, so the    |
+| modules of one effect frame arrive within this window     |
+\*---------------------------------------------------------*/
+#define I2C_SMBUS_GROUP_GATHER_TIME     std::chrono::milliseconds(2)
+
+/*---------------------------------------------------------*\
+| Members that have not sent a frame through the group for  |
+| this long, e.g. modules in a hardware mode, are not       |
+| waited for                                                |
+\*---------------------------------------------------------*/
+#define I2C_SMBUS_GROUP_ACTIVE_TIME     std::chrono::milliseconds(100)
+
+/*---------------------------------------------------------*\
+| One step of a module's frame: write transactions and the  |
+| time the module needs after them before its next step     |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    std::vector<i2c_smbus_transaction>  transactions;
+    std::chrono::microseconds           settle;
+} i2c_smbus_frame_step;
+
+typedef std::vector<i2c_smbus_frame_step> i2c_smbus_frame;
+
+class i2c_smbus_group_updater
+{
+public:
+    i2c_smbus_group_updater(i2c_smbus_interface* bus);
+
+    //Modules of the group, the updater waits for the frames of all members before it
+    //sends a batch
+    void add_member();
+    void remove_member();
+
+    //Sends the frame of the module at addr together with the frames of the other members.
+    //Step n of every frame goes out in one batch, and the settle times of the modules run
+    //at the same time instead of one after another.  A frame of one step without a settle
+    //time has nothing to share and goes to the bus right away.  Returns once the frame was
+    //sent, with the first error of the module's transactions
+    s32  update(u8 addr, const i2c_smbus_frame& frame);
+
+    //Helpers to fill a frame step
+    static void add_write_byte_data(i2c_smbus_frame_step* step, u8 addr, u8 command, u8 value);
+    static void add_write_block_data(i2c_smbus_frame_step* step, u8 addr, u8 command, u8 length, const u8* values);
+
+private:
+    typedef struct
+    {
+        u8                      addr;
+        const i2c_smbus_frame*  frame;
+        s32                     result;
+        bool                    done;
+    } i2c_smbus_group_request;
+
+    //Time of the last frame of each member address
+    typedef std::map<u8, std::chrono::steady_clock::time_point> i2c_smbus_group_activity;
+
+    void         send(std::vector<i2c_smbus_group_request*>& requests);
+    unsigned int active_members(std::chrono::steady_clock::time_point now);
+
+    i2c_smbus_interface*                    bus;
+    std::mutex                              mutex;
+    std::condition_variable                 cv;
+    unsigned int                            members;
+    bool                                    sending;
+    std::vector<i2c_smbus_group_request*>   queued;
+    i2c_smbus_group_activity                last_update;
+    std::chrono::steady_clock::time_point   ready_time;
+};
@@ -17,13 +17,192 @@
 #include "i2c_smbus.h"
 #include "i2c_smbus_linux.h"
 
+/*---------------------------------------------------------*\
+| Buffer of one transaction in an I2C_RDWR batch.  Byte 0   |
+| is the command, read data is returned from byte 1 on      |
+\*---------------------------------------------------------*/
+#define I2C_SMBUS_LINUX_BATCH_BUF   (I2C_SMBUS_BLOCK_MAX + 3)
+
+/*---------------------------------------------------------*\
+| Transactions that can be sent as plain I2C messages, the  |
+| same way the kernel emulates SMBus on I2C adapters        |
+\*---------------------------------------------------------*/
+static bool i2c_smbus_linux_can_emulate(const i2c_smbus_transaction* transaction)
+{
+    switch(transaction->size)
+    {
+        case I2C_SMBUS_BYTE:
+        case I2C_SMBUS_BYTE_DATA:
+        case I2C_SMBUS_WORD_DATA:
+            return true;
+
+        case I2C_SMBUS_BLOCK_DATA:
+            return(transaction->read_write == I2C_SMBUS_WRITE && transaction->data.block[0] <= I2C_SMBUS_BLOCK_MAX);
+
+        case I2C_SMBUS_I2C_BLOCK_DATA:
+            return(transaction->data.block[0] <= I2C_SMBUS_BLOCK_MAX);
+
+        default:
+            return false;
+    }
+}
+
+/*---------------------------------------------------------*\
+| Fills the messages of one transaction, returns how many   |
+\*---------------------------------------------------------*/
+static int i2c_smbus_linux_messages(const i2c_smbus_transaction* transaction, i2c_msg* msgs, u8* buf)
+{
+    u16 read_len = 0;
+
+    msgs[0].addr    = transaction->addr;
+    msgs[0].flags   = 0;
+    msgs[0].len     = 1;
+    msgs[0].buf     = buf;
+    buf[0]          = transaction->command;
+
+    if(transaction->read_write == I2C_SMBUS_WRITE)
+    {
+        switch(transaction->size)
+        {
+            case I2C_SMBUS_BYTE_DATA:
+                buf[1]          = transaction->data.byte;
+                msgs[0].len     = 2;
+                break;
+
+            case I2C_SMBUS_WORD_DATA:
+                buf[1]          = transaction->data.word & 0xFF;
+                buf[2]          = transaction->data.word >> 8;
+                msgs[0].len     = 3;
+                break;
+
+            case I2C_SMBUS_BLOCK_DATA:
+                memcpy(&buf[1], transaction->data.block, transaction->data.block[0] + 1);
+                msgs[0].len     = transaction->data.block[0] + 2;
+                break;
+
+            case I2C_SMBUS_I2C_BLOCK_DATA:
+                memcpy(&buf[1], &transaction->data.block[1], transaction->data.block[0]);
+                msgs[0].len     = transaction->data.block[0] + 1;
+                break;
+        }
+
+        return 1;
+    }
+
+    switch(transaction->size)
+    {
+        case I2C_SMBUS_BYTE:
+            msgs[0].flags   = I2C_M_RD;
+            msgs[0].buf     = &buf[1];
+            return 1;
+
+        case I2C_SMBUS_BYTE_DATA:
+            read_len        = 1;
+            break;
+
+        case I2C_SMBUS_WORD_DATA:
+            read_len        = 2;
+            break;
+
+        case I2C_SMBUS_I2C_BLOCK_DATA:
+            read_len        = transaction->data.block[0];
+            break;
+    }
+
+    msgs[1].addr    = transaction->addr;
+    msgs[1].flags   = I2C_M_RD;
+    msgs[1].len     = read_len;
+    msgs[1].buf     = &buf[1];
+
+    return 2;
+}
+
+/*---------------------------------------------------------*\
+| Copies the read data of one transaction back from its     |
+| buffer                                                    |
+\*---------------------------------------------------------*/
+static void i2c_smbus_linux_read_data(i2c_smbus_transaction* transaction, const u8* buf)
+{
+    if(transaction->read_write != I2C_SMBUS_READ)
+    {
+        return;
+    }
+
+    switch(transaction->size)
+    {
+        case I2C_SMBUS_BYTE:
+        case I2C_SMBUS_BYTE_DATA:
+            transaction->data.byte = buf[1];
+            break;
+
+        case I2C_SMBUS_WORD_DATA:
+            transaction->data.word = buf[1] | (buf[2] << 8);
+            break;
+
+        case I2C_SMBUS_I2C_BLOCK_DATA:
+            memcpy(&transaction->data.block[1], &buf[1], transaction->data.block[0]);
+            break;
+    }
+}
+
+i2c_smbus_linux::i2c_smbus_linux()
+{
+    handle          = -1;
+    funcs           = 0;
+    funcs_valid     = false;
+    slave_handle    = -1;
+    slave_addr      = -1;
+}
+
+unsigned long i2c_smbus_linux::get_funcs()
+{
+    if(!funcs_valid)
+    {
+        if(ioctl(handle, I2C_FUNCS, &funcs) < 0)
+        {
+            funcs = 0;
+        }
+
+        funcs_valid = true;
+    }
+
+    return funcs;
+}
+
+int i2c_smbus_linux::probe_max_block_size()
+{
+    /*-----------------------------------------------------*\
+    | SMBus block writes are either native to the adapter   |
+    | or emulated by the kernel over plain I2C, both are    |
+    | reported through I2C_FUNCS                            |
+    \*-----------------------------------------------------*/
+    if(get_funcs() & I2C_FUNC_SMBUS_WRITE_BLOCK_DATA)
+    {
+        return(I2C_SMBUS_BLOCK_MAX);
+    }
+
+    return(0);
+}
+
 s32 i2c_smbus_linux::i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, union i2c_smbus_data* data)
 {
 
     struct i2c_smbus_ioctl_data args;
 
-    //Tell I2C host which slave address to transfer to
-    ioctl(handle, I2C_SLAVE, addr);
+    //Tell I2C host which slave address to transfer to.  The address stays selected on the
+    //handle, so only select it when it changes.  Retry after a failed select
+    if(handle != slave_handle || addr != slave_addr)
+    {
+        if(ioctl(handle, I2C_SLAVE, addr) < 0)
+        {
+            slave_handle = -1;
+        }
+        else
+        {
+            slave_handle = handle;
+            slave_addr   = addr;
+        }
+    }
 
     args.read_write = read_write;
     args.command = command;
@@ -64,6 +243,64 @@ s32 i2c_smbus_linux::i2c_xfer(u8 addr, char read_write, int* size, u8* data)
     return ret_val;
 }
 
+s32 i2c_smbus_linux::i2c_smbus_xfer_batch(i2c_smbus_transaction* transactions, int count)
+{
+    /*-------------------------------------------------*\
+    | SMBus only adapters can not take I2C messages,    |
+    | run the transactions one at a time                |
+    \*-------------------------------------------------*/
+    bool emulate = (get_funcs() & I2C_FUNC_I2C) != 0;
+
+    for(int transaction_idx = 0; emulate && transaction_idx < count; transaction_idx++)
+    {
+        emulate = i2c_smbus_linux_can_emulate(&transactions[transaction_idx]);
+    }
+
+    if(!emulate)
+    {
+        return i2c_smbus_interface::i2c_smbus_xfer_batch(transactions, count);
+    }
+
+    /*-------------------------------------------------*\
+    | Submit as few I2C_RDWR calls as the message limit |
+    | allows, a transaction takes one or two messages   |
+    \*-------------------------------------------------*/
+    i2c_rdwr_ioctl_data rdwr;
+    i2c_msg             msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+    u8                  bufs[I2C_RDWR_IOCTL_MAX_MSGS][I2C_SMBUS_LINUX_BATCH_BUF];
+    int                 chunk_start = 0;
+    int                 nmsgs       = 0;
+
+    for(int transaction_idx = 0; transaction_idx <= count; transaction_idx++)
+    {
+        if(transaction_idx == count || nmsgs + 2 > I2C_RDWR_IOCTL_MAX_MSGS)
+        {
+            rdwr.msgs   = msgs;
+            rdwr.nmsgs  = nmsgs;
+
+            if(ioctl(handle, I2C_RDWR, &rdwr) < 0)
+            {
+                return -1;
+            }
+
+            for(int chunk_idx = chunk_start; chunk_idx < transaction_idx; chunk_idx++)
+            {
+                i2c_smbus_linux_read_data(&transactions[chunk_idx], bufs[chunk_idx - chunk_start]);
+            }
+
+            chunk_start = transaction_idx;
+            nmsgs       = 0;
+        }
+
+        if(transaction_idx < count)
+        {
+            nmsgs += i2c_smbus_linux_messages(&transactions[transaction_idx], &msgs[nmsgs], bufs[transaction_idx - chunk_start]);
+        }
+    }
+
+    return 0;
+}
+
 #include "Detector.h"
 #include <fcntl.h>
 #include <unistd.h>
@@ -14,9 +14,26 @@
 class i2c_smbus_linux : public i2c_smbus_interface
 {
 public:
+    i2c_smbus_linux();
+
     int handle;
 
 private:
     s32 i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
     s32 i2c_xfer(u8 addr, char read_write, int* size, u8* data);
+    s32 i2c_smbus_xfer_batch(i2c_smbus_transaction* transactions, int count);
+    int probe_max_block_size();
+
+    //Only called with the bus held, from a transfer or from the block size probe
+    unsigned long get_funcs();
+
+    unsigned long   funcs;
+    bool            funcs_valid;
+
+    /*-----------------------------------------------------*\
+    | Slave address last selected with I2C_SLAVE and the    |
+    | handle it was selected on                             |
+    \*-----------------------------------------------------*/
+    int             slave_handle;
+    int             slave_addr;
 };
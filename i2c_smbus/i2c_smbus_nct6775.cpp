@@ -235,6 +235,16 @@ s32 i2c_smbus_nct6775::i2c_xfer(u8 /*addr*/, char /*read_write*/, int* /*size*/,
     return -1;
 }
 
+int i2c_smbus_nct6775::probe_max_block_size()
+{
+    /*-----------------------------------------------------*\
+    | Longer blocks are fed to the 4 byte FIFO while the    |
+    | transfer runs, waiting a millisecond for each refill, |
+    | so only blocks that fit the FIFO are sent at once     |
+    \*-----------------------------------------------------*/
+    return(4);
+}
+
 bool i2c_smbus_nct6775_detect()
 {
     if(!InitializeOls() || GetDllStatus())
@@ -61,6 +61,7 @@ private:
     s32 nct6775_access(u16 addr, char read_write, u8 command, int size, i2c_smbus_data *data);
     s32 i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
     s32 i2c_xfer(u8 addr, char read_write, int* size, u8* data);
+    int probe_max_block_size();
 
     HANDLE global_smbus_access_handle = NULL;
 };
@@ -162,6 +162,15 @@ s32 i2c_smbus_nvapi::i2c_xfer(u8 addr, char read_write, int* size, u8* data)
     return(ret);
 }
 
+int i2c_smbus_nvapi::probe_max_block_size()
+{
+    /*-----------------------------------------------------*\
+    | The length byte goes into the I2C_SMBUS_BLOCK_MAX     |
+    | byte transfer buffer ahead of the data                |
+    \*-----------------------------------------------------*/
+    return(I2C_SMBUS_BLOCK_MAX - 1);
+}
+
 #include "Detector.h"
 
 bool i2c_smbus_nvapi_detect()
@@ -24,5 +24,6 @@ public:
 private:
     s32 i2c_smbus_xfer(u8 addr, char read_write, u8 command, int mode, i2c_smbus_data* data);
     s32 i2c_xfer(u8 addr, char read_write, int* size, u8* data);
+    int probe_max_block_size();
     NV_PHYSICAL_GPU_HANDLE handle;
 };
@@ -0,0 +1,99 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_register_cache.cpp                              |
+|                                                           |
+|   Write-through cache of the registers of SMBus devices,  |
+|   used to skip writes of values a register already holds  |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include "i2c_smbus_register_cache.h"
+
+static u32 register_key(u8 addr, u16 reg)
+{
+    return(((u32)addr << 16) | reg);
+}
+
+i2c_smbus_register_cache::i2c_smbus_register_cache(i2c_smbus_interface* bus)
+{
+    this->bus   = bus;
+    generation  = bus->get_register_cache_generation();
+}
+
+void i2c_smbus_register_cache::set_volatile(u8 addr, u16 reg)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    volatile_registers.insert(register_key(addr, reg));
+    values.erase(register_key(addr, reg));
+}
+
+bool i2c_smbus_register_cache::matches(u8 addr, u16 reg, u8 value)
+{
+    return(matches(addr, reg, &value, 1));
+}
+
+bool i2c_smbus_register_cache::matches(u8 addr, u16 reg, const u8* values, unsigned int length)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    check_generation();
+
+    for(unsigned int value_idx = 0; value_idx < length; value_idx++)
+    {
+        std::unordered_map<u32, u8>::iterator cached = this->values.find(register_key(addr, (u16)(reg + value_idx)));
+
+        if(cached == this->values.end() || cached->second != values[value_idx])
+        {
+            return(false);
+        }
+    }
+
+    return(length > 0);
+}
+
+void i2c_smbus_register_cache::update(u8 addr, u16 reg, u8 value, s32 result)
+{
+    update(addr, reg, &value, 1, result);
+}
+
+void i2c_smbus_register_cache::update(u8 addr, u16 reg, const u8* values, unsigned int length, s32 result)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    check_generation();
+
+    for(unsigned int value_idx = 0; value_idx < length; value_idx++)
+    {
+        u32 key = register_key(addr, (u16)(reg + value_idx));
+
+        if(result < 0 || volatile_registers.count(key) > 0)
+        {
+            this->values.erase(key);
+        }
+        else
+        {
+            this->values[key] = values[value_idx];
+        }
+    }
+}
+
+void i2c_smbus_register_cache::invalidate()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    values.clear();
+}
+
+// Drops the cached values when the bus invalidated its caches, e.g. after a resume
+void i2c_smbus_register_cache::check_generation()
+{
+    unsigned int bus_generation = bus->get_register_cache_generation();
+
+    if(bus_generation != generation)
+    {
+        values.clear();
+        generation = bus_generation;
+    }
+}
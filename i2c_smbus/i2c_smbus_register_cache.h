@@ -0,0 +1,47 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_register_cache.h                                |
+|                                                           |
+|   Write-through cache of the registers of SMBus devices,  |
+|   used to skip writes of values a register already holds  |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include "i2c_smbus.h"
+
+class i2c_smbus_register_cache
+{
+public:
+    i2c_smbus_register_cache(i2c_smbus_interface* bus);
+
+    //Registers that trigger an action when written, such as apply registers, are never
+    //reported as matching
+    void set_volatile(u8 addr, u16 reg);
+
+    //True when the registers are known to hold the values, so the write can be skipped
+    bool matches(u8 addr, u16 reg, u8 value);
+    bool matches(u8 addr, u16 reg, const u8* values, unsigned int length);
+
+    //Records the result of a write.  Acknowledged values are kept, the registers of a
+    //failed write are forgotten as their contents are unknown
+    void update(u8 addr, u16 reg, u8 value, s32 result);
+    void update(u8 addr, u16 reg, const u8* values, unsigned int length, s32 result);
+
+    //Forgets all registers
+    void invalidate();
+
+private:
+    void check_generation();
+
+    i2c_smbus_interface*            bus;
+    std::mutex                      mutex;
+    unsigned int                    generation;
+    std::unordered_map<u32, u8>     values;
+    std::set<u32>                   volatile_registers;
+};
@@ -0,0 +1,113 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_replay.cpp                                      |
+|                                                           |
+|   SMBus that answers transactions from a recorded trace,  |
+|   used to reproduce the traffic of a user's system        |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include "i2c_smbus_replay.h"
+#include "LogManager.h"
+
+i2c_smbus_replay::i2c_smbus_replay(const std::vector<i2c_smbus_trace_record>& records, bool timing)
+{
+    this->records   = records;
+    this->timing    = timing;
+    position        = 0;
+    matched         = 0;
+    unmatched       = 0;
+}
+
+i2c_smbus_replay::~i2c_smbus_replay()
+{
+    LOG_INFO("[i2c_smbus_replay] %s: %u transactions replayed, %u without a recorded match", device_name, matched, unmatched);
+}
+
+/*---------------------------------------------------------*\
+| Finds the next record of the same transaction.  Searching |
+| from the last match keeps repeated reads of a register in |
+| their recorded order, searching from the start again      |
+| covers callers that run in a different order than when    |
+| the trace was recorded                                    |
+\*---------------------------------------------------------*/
+const i2c_smbus_trace_record* i2c_smbus_replay::find(u8 addr, u8 flags, u8 command, u8 size)
+{
+    for(std::size_t searched = 0; searched < records.size(); searched++)
+    {
+        std::size_t             record_idx = (position + searched) % records.size();
+        i2c_smbus_trace_record* record     = &records[record_idx];
+
+        if(record->addr    == addr
+        && record->command == command
+        && record->size    == size
+        && (record->flags & ~I2C_SMBUS_TRACE_FLAG_BATCH) == flags)
+        {
+            position = record_idx + 1;
+            matched++;
+
+            return(record);
+        }
+    }
+
+    unmatched++;
+
+    return(NULL);
+}
+
+void i2c_smbus_replay::wait(const i2c_smbus_trace_record* record)
+{
+    if(timing)
+    {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(record->duration_ns));
+    }
+}
+
+s32 i2c_smbus_replay::i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data)
+{
+    u8                            flags  = (read_write == I2C_SMBUS_READ && size != I2C_SMBUS_QUICK) ? I2C_SMBUS_TRACE_FLAG_READ : 0;
+    const i2c_smbus_trace_record* record = find(addr, flags, command, (u8)size);
+
+    if(record == NULL)
+    {
+        LOG_TRACE("[i2c_smbus_replay] No recorded transaction for address %02X command %02X size %d", addr, command, size);
+        return(-1);
+    }
+
+    if((flags & I2C_SMBUS_TRACE_FLAG_READ) && data != NULL)
+    {
+        memcpy(data, record->data, record->length);
+    }
+
+    wait(record);
+
+    return(record->result);
+}
+
+s32 i2c_smbus_replay::i2c_xfer(u8 addr, char read_write, int* size, u8* data)
+{
+    u8                            flags  = I2C_SMBUS_TRACE_FLAG_I2C | ((read_write == I2C_SMBUS_READ) ? I2C_SMBUS_TRACE_FLAG_READ : 0);
+    const i2c_smbus_trace_record* record = find(addr, flags, 0, 0);
+
+    if(record == NULL)
+    {
+        LOG_TRACE("[i2c_smbus_replay] No recorded I2C transfer for address %02X", addr);
+        return(-1);
+    }
+
+    if(flags & I2C_SMBUS_TRACE_FLAG_READ)
+    {
+        *size = std::min(*size, (int)record->length);
+
+        memcpy(data, record->data, *size);
+    }
+
+    wait(record);
+
+    return(record->result);
+}
@@ -0,0 +1,39 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_replay.h                                        |
+|                                                           |
+|   SMBus that answers transactions from a recorded trace,  |
+|   used to reproduce the traffic of a user's system        |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <vector>
+#include "i2c_smbus.h"
+#include "i2c_smbus_trace.h"
+
+class i2c_smbus_replay : public i2c_smbus_interface
+{
+public:
+    //The records of one bus of a trace, oldest first.  With timing each transaction
+    //takes as long as it did when it was recorded
+    i2c_smbus_replay(const std::vector<i2c_smbus_trace_record>& records, bool timing);
+    ~i2c_smbus_replay();
+
+    //Transactions answered from the trace and transactions without a matching record
+    unsigned int matched;
+    unsigned int unmatched;
+
+private:
+    s32 i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
+    s32 i2c_xfer(u8 addr, char read_write, int* size, u8* data);
+
+    const i2c_smbus_trace_record* find(u8 addr, u8 flags, u8 command, u8 size);
+    void wait(const i2c_smbus_trace_record* record);
+
+    std::vector<i2c_smbus_trace_record> records;
+    std::size_t                         position;
+    bool                                timing;
+};
@@ -0,0 +1,79 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_replay_detect.cpp                               |
+|                                                           |
+|   Registers a replay bus for every bus of the SMBus       |
+|   trace configured in the settings                        |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include "Detector.h"
+#include "i2c_smbus_replay.h"
+#include "LogManager.h"
+#include "SettingsManager.h"
+
+/******************************************************************************************\
+*                                                                                          *
+*   i2c_smbus_replay_detect                                                                *
+*                                                                                          *
+*       Add a replay bus for every bus of the trace named by the SMBusReplay key in the    *
+*       settings json, e.g.                                                                *
+*                                                                                          *
+*       "SMBusReplay": { "file": "/home/user/SMBusTrace.bin", "timing": true }             *
+*                                                                                          *
+\******************************************************************************************/
+
+bool i2c_smbus_replay_detect()
+{
+    json replay_settings = ResourceManager::get()->GetSettingsManager()->GetSettings("SMBusReplay");
+
+    if(!replay_settings.contains("file"))
+    {
+        return(true);
+    }
+
+    std::string                         filename = replay_settings["file"];
+    bool                                timing   = replay_settings.value("timing", true);
+    i2c_smbus_trace_header              header;
+    std::vector<i2c_smbus_trace_record> records;
+
+    if(!i2c_smbus_tracer::load(filename, &header, &records))
+    {
+        LOG_WARNING("[i2c_smbus_replay] Cannot read SMBus trace %s", filename.c_str());
+        return(true);
+    }
+
+    LOG_INFO("[i2c_smbus_replay] Replaying %d transactions from %s", (int)records.size(), filename.c_str());
+
+    for(u32 bus_idx = 0; bus_idx < header.bus_count; bus_idx++)
+    {
+        std::vector<i2c_smbus_trace_record> bus_records;
+
+        for(std::size_t record_idx = 0; record_idx < records.size(); record_idx++)
+        {
+            if(records[record_idx].bus == bus_idx)
+            {
+                bus_records.push_back(records[record_idx]);
+            }
+        }
+
+        /*-------------------------------------------------*\
+        | Keep the recorded name and PCI IDs so the same    |
+        | detectors run on the bus                          |
+        \*-------------------------------------------------*/
+        i2c_smbus_replay* bus = new i2c_smbus_replay(bus_records, timing);
+
+        snprintf(bus->device_name, 512, "%.*s", (int)sizeof(header.busses[bus_idx].name), header.busses[bus_idx].name);
+        bus->pci_vendor             = header.busses[bus_idx].pci_vendor;
+        bus->pci_device             = header.busses[bus_idx].pci_device;
+        bus->pci_subsystem_vendor   = header.busses[bus_idx].pci_subsystem_vendor;
+        bus->pci_subsystem_device   = header.busses[bus_idx].pci_subsystem_device;
+
+        ResourceManager::get()->RegisterI2CBus(bus);
+    }
+
+    return(true);
+}   /* i2c_smbus_replay_detect() */
+
+REGISTER_I2C_BUS_DETECTOR(i2c_smbus_replay_detect);
@@ -0,0 +1,533 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_simulated.cpp                                   |
+|                                                           |
+|   In-memory SMBus with simulated device models, used to   |
+|   run the DRAM and motherboard detection and update paths |
+|   without the hardware                                    |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <chrono>
+#include <cstring>
+#include "CRC.h"
+#include "i2c_smbus_simulated.h"
+#include "LogManager.h"
+
+/*---------------------------------------------------------*\
+| ENE registers used by the model, see ENESMBusController.h |
+\*---------------------------------------------------------*/
+#define ENE_SIMULATED_REG_DEVICE_NAME       0x1000
+#define ENE_SIMULATED_REG_CONFIG_TABLE      0x1C00
+#define ENE_SIMULATED_REG_SLOT_INDEX        0x80F8
+#define ENE_SIMULATED_REG_I2C_ADDRESS       0x80F9
+#define ENE_SIMULATED_CONFIG_LED_COUNT      0x02
+#define ENE_SIMULATED_DRAM_REMAP_ADDR       0x77
+
+/*---------------------------------------------------------*\
+| SPD addresses, the EEPROM of slot n is on 0x50 + n        |
+\*---------------------------------------------------------*/
+#define SPD_SIMULATED_BASE_ADDR             0x50
+#define SPD_SIMULATED_DDR4_PAGE_ADDR        0x36
+#define SPD_SIMULATED_DDR5_MREG_PAGE        0x0B
+
+i2c_smbus_simulated::i2c_smbus_simulated()
+{
+    latency_ns = 0;
+}
+
+i2c_smbus_simulated::~i2c_smbus_simulated()
+{
+    for(std::size_t device_idx = 0; device_idx < devices.size(); device_idx++)
+    {
+        delete devices[device_idx];
+    }
+}
+
+void i2c_smbus_simulated::add_device(i2c_smbus_simulated_device* device)
+{
+    devices.push_back(device);
+}
+
+void i2c_smbus_simulated::set_latency_ns(unsigned long long latency_ns)
+{
+    this->latency_ns = latency_ns;
+}
+
+s32 i2c_smbus_simulated::i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data)
+{
+    /*-----------------------------------------------------*\
+    | Spin rather than sleep, a sleep overshoots latencies  |
+    | of a few hundred microseconds by too much             |
+    \*-----------------------------------------------------*/
+    if(latency_ns > 0)
+    {
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(latency_ns);
+
+        while(std::chrono::steady_clock::now() < end)
+        {
+        }
+    }
+
+    /*-----------------------------------------------------*\
+    | Writes reach every device on the address, like the    |
+    | ENE DRAM modules that share 0x77 before the remap.    |
+    | Reads are answered by the first device                |
+    \*-----------------------------------------------------*/
+    std::vector<i2c_smbus_simulated_device*> targets;
+
+    for(std::size_t device_idx = 0; device_idx < devices.size(); device_idx++)
+    {
+        if(devices[device_idx]->responds(addr))
+        {
+            targets.push_back(devices[device_idx]);
+        }
+    }
+
+    if(targets.empty())
+    {
+        return(-1);
+    }
+
+    if(read_write == I2C_SMBUS_READ && size != I2C_SMBUS_QUICK)
+    {
+        return(targets[0]->xfer(addr, read_write, command, size, data));
+    }
+
+    s32 result = -1;
+
+    for(std::size_t target_idx = 0; target_idx < targets.size(); target_idx++)
+    {
+        if(targets[target_idx]->xfer(addr, read_write, command, size, data) >= 0)
+        {
+            result = 0;
+        }
+    }
+
+    return(result);
+}
+
+s32 i2c_smbus_simulated::i2c_xfer(u8 /*addr*/, char /*read_write*/, int* /*size*/, u8* /*data*/)
+{
+    return(-1);
+}
+
+/*---------------------------------------------------------*\
+| ENE register file                                         |
+\*---------------------------------------------------------*/
+i2c_smbus_simulated_ene::i2c_smbus_simulated_ene(u8 addr, const std::string& name, unsigned char led_count)
+{
+    this->addr  = addr;
+    reg_select  = 0;
+
+    registers.resize(0x10000, 0x00);
+
+    /*-----------------------------------------------------*\
+    | The device name is a NUL terminated 16 byte string    |
+    \*-----------------------------------------------------*/
+    memcpy(&registers[ENE_SIMULATED_REG_DEVICE_NAME], name.c_str(), name.size() < 15 ? name.size() : 15);
+
+    registers[ENE_SIMULATED_REG_CONFIG_TABLE + ENE_SIMULATED_CONFIG_LED_COUNT] = led_count;
+}
+
+bool i2c_smbus_simulated_ene::responds(u8 addr)
+{
+    return(addr == this->addr);
+}
+
+s32 i2c_smbus_simulated_ene::xfer(u8 /*addr*/, char read_write, u8 command, int size, i2c_smbus_data* data)
+{
+    switch(size)
+    {
+        case I2C_SMBUS_QUICK:
+            return(0);
+
+        case I2C_SMBUS_BYTE:
+            if(read_write == I2C_SMBUS_READ)
+            {
+                data->byte = 0x00;
+            }
+            return(0);
+
+        case I2C_SMBUS_BYTE_DATA:
+            if(read_write == I2C_SMBUS_WRITE)
+            {
+                if(command == 0x01)
+                {
+                    registers[reg_select] = data->byte;
+                }
+            }
+            else if(command == 0x81)
+            {
+                data->byte = registers[reg_select];
+            }
+            else if(command >= 0xA0 && command <= 0xAF)
+            {
+                //Incrementing values checked by the detection
+                data->byte = command - 0xA0;
+            }
+            else
+            {
+                data->byte = 0x00;
+            }
+            return(0);
+
+        case I2C_SMBUS_WORD_DATA:
+            if(read_write == I2C_SMBUS_WRITE && command == 0x00)
+            {
+                reg_select = (u16)(((data->word << 8) & 0xFF00) | ((data->word >> 8) & 0x00FF));
+                return(0);
+            }
+            break;
+
+        case I2C_SMBUS_BLOCK_DATA:
+            if(read_write == I2C_SMBUS_WRITE && command == 0x03)
+            {
+                for(unsigned int byte_idx = 0; byte_idx < data->block[0]; byte_idx++)
+                {
+                    registers[(u16)(reg_select + byte_idx)] = data->block[byte_idx + 1];
+                }
+                return(0);
+            }
+            break;
+    }
+
+    return(-1);
+}
+
+/*---------------------------------------------------------*\
+| ENE DRAM controller                                       |
+\*---------------------------------------------------------*/
+i2c_smbus_simulated_ene_dram::i2c_smbus_simulated_ene_dram(unsigned char slot, unsigned char led_count)
+    : i2c_smbus_simulated_ene(ENE_SIMULATED_DRAM_REMAP_ADDR, "AUDA0-E6K5-0101", led_count)
+{
+    this->slot      = slot;
+    selected_slot   = 0xFF;
+}
+
+s32 i2c_smbus_simulated_ene_dram::xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data)
+{
+    s32 result = i2c_smbus_simulated_ene::xfer(addr, read_write, command, size, data);
+
+    if(result < 0 || read_write != I2C_SMBUS_WRITE || size != I2C_SMBUS_BYTE_DATA || command != 0x01)
+    {
+        return(result);
+    }
+
+    /*-----------------------------------------------------*\
+    | All modules on 0x77 latch the slot index, only the    |
+    | module in that slot takes the new address             |
+    \*-----------------------------------------------------*/
+    if(reg_select == ENE_SIMULATED_REG_SLOT_INDEX)
+    {
+        selected_slot = data->byte;
+    }
+    else if(reg_select == ENE_SIMULATED_REG_I2C_ADDRESS && this->addr == ENE_SIMULATED_DRAM_REMAP_ADDR && selected_slot == slot)
+    {
+        this->addr = data->byte >> 1;
+    }
+
+    return(result);
+}
+
+/*---------------------------------------------------------*\
+| Corsair Vengeance RGB Pro                                 |
+\*---------------------------------------------------------*/
+i2c_smbus_simulated_corsair_vengeance_pro::i2c_smbus_simulated_corsair_vengeance_pro(u8 addr)
+{
+    this->addr      = addr;
+    direct_packets  = 0;
+    crc_errors      = 0;
+    commits         = 0;
+    command_length  = 0;
+
+    memset(colors, 0, sizeof(colors));
+}
+
+bool i2c_smbus_simulated_corsair_vengeance_pro::responds(u8 addr)
+{
+    return(addr == this->addr);
+}
+
+s32 i2c_smbus_simulated_corsair_vengeance_pro::xfer(u8 /*addr*/, char read_write, u8 command, int size, i2c_smbus_data* data)
+{
+    switch(size)
+    {
+        case I2C_SMBUS_QUICK:
+            return(0);
+
+        case I2C_SMBUS_BYTE_DATA:
+            if(read_write == I2C_SMBUS_READ)
+            {
+                switch(command)
+                {
+                    case 0x43:
+                        data->byte = 0x1C;
+                        break;
+
+                    case 0x44:
+                        data->byte = 0x03;
+                        break;
+
+                    default:
+                        //Includes the 0x41 status register, always ready
+                        data->byte = 0x00;
+                        break;
+                }
+                return(0);
+            }
+
+            switch(command)
+            {
+                case 0x20:
+                    command_length++;
+                    break;
+
+                case 0x21:
+                    command_length = 0;
+                    break;
+
+                case 0x82:
+                    LOG_TRACE("[i2c_smbus_simulated] Corsair Vengeance Pro at 0x%02X committed %u command bytes", addr, command_length);
+                    commits++;
+                    command_length = 0;
+                    break;
+            }
+            return(0);
+
+        case I2C_SMBUS_BLOCK_DATA:
+            if(read_write == I2C_SMBUS_WRITE && command == 0x31)
+            {
+                direct_packets++;
+
+                /*-----------------------------------------*\
+                | 0x0A, 10 RGB triplets and the CRC-8 of    |
+                | the first 31 bytes                        |
+                \*-----------------------------------------*/
+                if(data->block[0] != 32
+                || data->block[1] != 0x0A
+                || CRCPP::CRC::Calculate(&data->block[1], 31, CRCPP::CRC::CRC_8()) != data->block[32])
+                {
+                    crc_errors++;
+                    LOG_WARNING("[i2c_smbus_simulated] Corsair Vengeance Pro at 0x%02X rejected a direct packet with a bad CRC", addr);
+                }
+                else
+                {
+                    memcpy(colors, &data->block[2], sizeof(colors));
+                }
+                return(0);
+            }
+            break;
+    }
+
+    return(-1);
+}
+
+/*---------------------------------------------------------*\
+| DDR4 SPD page select                                      |
+\*---------------------------------------------------------*/
+i2c_smbus_simulated_spd_ddr4_page::i2c_smbus_simulated_spd_ddr4_page()
+{
+    page = 0;
+}
+
+bool i2c_smbus_simulated_spd_ddr4_page::responds(u8 addr)
+{
+    return(addr == SPD_SIMULATED_DDR4_PAGE_ADDR || addr == SPD_SIMULATED_DDR4_PAGE_ADDR + 1);
+}
+
+s32 i2c_smbus_simulated_spd_ddr4_page::xfer(u8 addr, char read_write, u8 /*command*/, int /*size*/, i2c_smbus_data* /*data*/)
+{
+    if(read_write != I2C_SMBUS_WRITE)
+    {
+        return(-1);
+    }
+
+    page = addr - SPD_SIMULATED_DDR4_PAGE_ADDR;
+
+    return(0);
+}
+
+/*---------------------------------------------------------*\
+| Fills the manufacturer ID the way SPDAccessor decodes it, |
+| the continuation count and the code plus one              |
+\*---------------------------------------------------------*/
+static void spd_simulated_set_jedec_id(u8* id, u16 jedec_id)
+{
+    id[0] = (u8)(jedec_id >> 8);
+    id[1] = (u8)((jedec_id & 0x7F) + 1);
+}
+
+/*---------------------------------------------------------*\
+| DDR4 SPD EEPROM                                           |
+\*---------------------------------------------------------*/
+i2c_smbus_simulated_spd_ddr4::i2c_smbus_simulated_spd_ddr4(unsigned char slot, u16 jedec_id, i2c_smbus_simulated_spd_ddr4_page* page_select)
+{
+    this->addr          = SPD_SIMULATED_BASE_ADDR + slot;
+    this->page_select   = page_select;
+
+    memset(eeprom, 0, sizeof(eeprom));
+
+    eeprom[0x00]        = 0x23;         /* 384 bytes used, 512 total    */
+    eeprom[0x01]        = 0x11;         /* Revision 1.1                 */
+    eeprom[0x02]        = 0x0C;         /* DDR4 SDRAM                   */
+    eeprom[0x03]        = 0x02;         /* UDIMM                        */
+
+    spd_simulated_set_jedec_id(&eeprom[0x140], jedec_id);
+
+    u16 crc             = CRCPP::CRC::Calculate(eeprom, 126, CRCPP::CRC::CRC_16_XMODEM());
+
+    eeprom[0x7E]        = crc & 0xFF;
+    eeprom[0x7F]        = crc >> 8;
+}
+
+bool i2c_smbus_simulated_spd_ddr4::responds(u8 addr)
+{
+    return(addr == this->addr);
+}
+
+s32 i2c_smbus_simulated_spd_ddr4::xfer(u8 /*addr*/, char read_write, u8 command, int size, i2c_smbus_data* data)
+{
+    u8* page_data = &eeprom[page_select->page * 256];
+
+    if(size == I2C_SMBUS_QUICK)
+    {
+        return(0);
+    }
+
+    if(read_write != I2C_SMBUS_READ)
+    {
+        return(-1);
+    }
+
+    switch(size)
+    {
+        case I2C_SMBUS_BYTE_DATA:
+            data->byte = page_data[command];
+            return(0);
+
+        case I2C_SMBUS_WORD_DATA:
+            data->word = page_data[command] | (page_data[(u8)(command + 1)] << 8);
+            return(0);
+
+        case I2C_SMBUS_I2C_BLOCK_DATA:
+            if(data->block[0] > I2C_SMBUS_BLOCK_MAX)
+            {
+                data->block[0] = I2C_SMBUS_BLOCK_MAX;
+            }
+
+            for(unsigned int byte_idx = 0; byte_idx < data->block[0]; byte_idx++)
+            {
+                data->block[byte_idx + 1] = page_data[(u8)(command + byte_idx)];
+            }
+            return(0);
+    }
+
+    return(-1);
+}
+
+/*---------------------------------------------------------*\
+| DDR5 SPD hub and EEPROM                                   |
+\*---------------------------------------------------------*/
+i2c_smbus_simulated_spd_ddr5::i2c_smbus_simulated_spd_ddr5(unsigned char slot, u16 jedec_id)
+{
+    this->addr          = SPD_SIMULATED_BASE_ADDR + slot;
+    page                = 0;
+
+    memset(eeprom, 0, sizeof(eeprom));
+
+    eeprom[0x00]        = 0x30;         /* 1024 bytes used              */
+    eeprom[0x01]        = 0x10;         /* Revision 1.0                 */
+    eeprom[0x02]        = 0x12;         /* DDR5 SDRAM                   */
+    eeprom[0x03]        = 0x02;         /* UDIMM                        */
+
+    spd_simulated_set_jedec_id(&eeprom[0x200], jedec_id);
+
+    u16 crc             = CRCPP::CRC::Calculate(eeprom, 510, CRCPP::CRC::CRC_16_XMODEM());
+
+    eeprom[0x1FE]       = crc & 0xFF;
+    eeprom[0x1FF]       = crc >> 8;
+}
+
+bool i2c_smbus_simulated_spd_ddr5::responds(u8 addr)
+{
+    return(addr == this->addr);
+}
+
+s32 i2c_smbus_simulated_spd_ddr5::xfer(u8 /*addr*/, char read_write, u8 command, int size, i2c_smbus_data* data)
+{
+    /*-----------------------------------------------------*\
+    | Commands with bit 7 set address the selected 128 byte |
+    | EEPROM page, the others the hub registers             |
+    \*-----------------------------------------------------*/
+    u8* page_data = &eeprom[page * 128];
+
+    switch(size)
+    {
+        case I2C_SMBUS_QUICK:
+            return(0);
+
+        case I2C_SMBUS_BYTE_DATA:
+            if(read_write == I2C_SMBUS_WRITE)
+            {
+                if(command != SPD_SIMULATED_DDR5_MREG_PAGE)
+                {
+                    return(0);
+                }
+
+                if(data->byte >= sizeof(eeprom) / 128)
+                {
+                    return(-1);
+                }
+
+                page = data->byte;
+                return(0);
+            }
+
+            if(command & 0x80)
+            {
+                data->byte = page_data[command & 0x7F];
+                return(0);
+            }
+
+            switch(command)
+            {
+                case 0x00:
+                    data->byte = 0x51;          /* SPD5 hub device type         */
+                    break;
+
+                case 0x01:
+                    data->byte = 0x08;          /* With temperature sensor      */
+                    break;
+
+                case SPD_SIMULATED_DDR5_MREG_PAGE:
+                    data->byte = page;
+                    break;
+
+                default:
+                    data->byte = 0x00;
+                    break;
+            }
+            return(0);
+
+        case I2C_SMBUS_I2C_BLOCK_DATA:
+            if(read_write != I2C_SMBUS_READ || !(command & 0x80))
+            {
+                break;
+            }
+
+            if(data->block[0] > I2C_SMBUS_BLOCK_MAX)
+            {
+                data->block[0] = I2C_SMBUS_BLOCK_MAX;
+            }
+
+            for(unsigned int byte_idx = 0; byte_idx < data->block[0]; byte_idx++)
+            {
+                data->block[byte_idx + 1] = page_data[(command + byte_idx) & 0x7F];
+            }
+            return(0);
+    }
+
+    return(-1);
+}
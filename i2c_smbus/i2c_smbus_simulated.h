@@ -0,0 +1,165 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_simulated.h                                     |
+|                                                           |
+|   In-memory SMBus with simulated device models, used to   |
+|   run the DRAM and motherboard detection and update paths |
+|   without the hardware                                    |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "i2c_smbus.h"
+
+/*---------------------------------------------------------*\
+| A device model on the simulated bus.  A model may answer  |
+| on more than one address, e.g. an ENE DRAM controller     |
+| before and after it is remapped                           |
+\*---------------------------------------------------------*/
+class i2c_smbus_simulated_device
+{
+public:
+    virtual ~i2c_smbus_simulated_device() = default;
+
+    virtual bool responds(u8 addr) = 0;
+
+    //Same arguments and return value as i2c_smbus_xfer, only called for addresses the
+    //model responds on
+    virtual s32 xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data) = 0;
+};
+
+class i2c_smbus_simulated : public i2c_smbus_interface
+{
+public:
+    i2c_smbus_simulated();
+    ~i2c_smbus_simulated();
+
+    //The bus takes ownership of the device
+    void add_device(i2c_smbus_simulated_device* device);
+
+    //Time every transaction takes, in addition to the time the model takes
+    void set_latency_ns(unsigned long long latency_ns);
+
+private:
+    s32 i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
+    s32 i2c_xfer(u8 addr, char read_write, int* size, u8* data);
+
+    std::vector<i2c_smbus_simulated_device*>    devices;
+    unsigned long long                          latency_ns;
+};
+
+/*---------------------------------------------------------*\
+| ENE (ASUS Aura) controller register file.  Registers are  |
+| selected with a byte swapped word write to 0x00, then     |
+| written through 0x01 (byte) or 0x03 (block) and read      |
+| through 0x81                                              |
+\*---------------------------------------------------------*/
+class i2c_smbus_simulated_ene : public i2c_smbus_simulated_device
+{
+public:
+    i2c_smbus_simulated_ene(u8 addr, const std::string& name, unsigned char led_count);
+
+    bool responds(u8 addr);
+    s32  xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
+
+protected:
+    u8                  addr;
+    u16                 reg_select;
+    std::vector<u8>     registers;
+};
+
+/*---------------------------------------------------------*\
+| ENE DRAM controller, starts on 0x77 with the other        |
+| modules and moves to the address written to its I2C       |
+| address register once its slot has been selected          |
+\*---------------------------------------------------------*/
+class i2c_smbus_simulated_ene_dram : public i2c_smbus_simulated_ene
+{
+public:
+    i2c_smbus_simulated_ene_dram(unsigned char slot, unsigned char led_count);
+
+    s32  xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
+
+private:
+    unsigned char       slot;
+    unsigned char       selected_slot;
+};
+
+/*---------------------------------------------------------*\
+| Corsair Vengeance RGB Pro controller.  Checks the CRC-8   |
+| of direct mode packets and counts the rejected ones       |
+\*---------------------------------------------------------*/
+class i2c_smbus_simulated_corsair_vengeance_pro : public i2c_smbus_simulated_device
+{
+public:
+    i2c_smbus_simulated_corsair_vengeance_pro(u8 addr);
+
+    bool responds(u8 addr);
+    s32  xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
+
+    //Colors of the last accepted direct packet
+    u8                  colors[30];
+
+    unsigned int        direct_packets;
+    unsigned int        crc_errors;
+    unsigned int        commits;
+
+private:
+    u8                  addr;
+    unsigned int        command_length;
+};
+
+/*---------------------------------------------------------*\
+| Page select of the DDR4 SPD EEPROMs on the bus, a write   |
+| to 0x36 selects page 0 and a write to 0x37 page 1 of all  |
+| of the EEPROMs                                            |
+\*---------------------------------------------------------*/
+class i2c_smbus_simulated_spd_ddr4_page : public i2c_smbus_simulated_device
+{
+public:
+    i2c_smbus_simulated_spd_ddr4_page();
+
+    bool responds(u8 addr);
+    s32  xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
+
+    unsigned char       page;
+};
+
+/*---------------------------------------------------------*\
+| SPD EEPROM of a DDR4 module, 512 bytes in two pages       |
+\*---------------------------------------------------------*/
+class i2c_smbus_simulated_spd_ddr4 : public i2c_smbus_simulated_device
+{
+public:
+    i2c_smbus_simulated_spd_ddr4(unsigned char slot, u16 jedec_id, i2c_smbus_simulated_spd_ddr4_page* page_select);
+
+    bool responds(u8 addr);
+    s32  xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
+
+private:
+    u8                                  addr;
+    i2c_smbus_simulated_spd_ddr4_page*  page_select;
+    u8                                  eeprom[512];
+};
+
+/*---------------------------------------------------------*\
+| SPD5118 hub and EEPROM of a DDR5 module, 2048 bytes read  |
+| in 128 byte pages selected through the MR11 register      |
+\*---------------------------------------------------------*/
+class i2c_smbus_simulated_spd_ddr5 : public i2c_smbus_simulated_device
+{
+public:
+    i2c_smbus_simulated_spd_ddr5(unsigned char slot, u16 jedec_id);
+
+    bool responds(u8 addr);
+    s32  xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
+
+private:
+    u8                  addr;
+    u8                  page;
+    u8                  eeprom[2048];
+};
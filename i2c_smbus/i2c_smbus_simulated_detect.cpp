@@ -0,0 +1,109 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_simulated_detect.cpp                            |
+|                                                           |
+|   Registers the simulated SMBus busses configured         |
+|   in the settings                                         |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include "Detector.h"
+#include "i2c_smbus_simulated.h"
+#include "LogManager.h"
+#include "pci_ids.h"
+#include "SettingsManager.h"
+
+/******************************************************************************************\
+*                                                                                          *
+*   i2c_smbus_simulated_detect                                                             *
+*                                                                                          *
+*       Add simulated busses based on the SimulatedSMBus key in the settings json, e.g.    *
+*                                                                                          *
+*       "SimulatedSMBus": { "busses": [ { "name": "Simulated DRAM", "latency_ns": 500000,  *
+*           "devices": [ { "type": "ene_dram", "slot": 0, "leds": 5 },                     *
+*                        { "type": "spd_ddr4", "slot": 0, "jedec_id": 279 } ] } ] }        *
+*                                                                                          *
+*       Device types are ene (address, name, leds), ene_dram (slot, leds),                 *
+*       corsair_vengeance_pro (address), spd_ddr4 and spd_ddr5 (slot, jedec_id).  The PCI  *
+*       IDs default to an Intel chipset SMBus so the DRAM and motherboard detectors scan   *
+*       the bus                                                                            *
+*                                                                                          *
+\******************************************************************************************/
+
+bool i2c_smbus_simulated_detect()
+{
+    json simulated_settings = ResourceManager::get()->GetSettingsManager()->GetSettings("SimulatedSMBus");
+
+    if(!simulated_settings.contains("busses"))
+    {
+        return(true);
+    }
+
+    for(unsigned int bus_idx = 0; bus_idx < simulated_settings["busses"].size(); bus_idx++)
+    {
+        json                                bus_settings    = simulated_settings["busses"][bus_idx];
+        i2c_smbus_simulated*                bus             = new i2c_smbus_simulated();
+        i2c_smbus_simulated_spd_ddr4_page*  ddr4_page       = NULL;
+        std::string                         name            = bus_settings.value("name", "Simulated SMBus " + std::to_string(bus_idx));
+
+        snprintf(bus->device_name, 512, "%s", name.c_str());
+        bus->pci_vendor             = bus_settings.value("pci_vendor",           INTEL_VEN);
+        bus->pci_device             = bus_settings.value("pci_device",           INTEL_ALDER_LAKE_SMBUS_DEV);
+        bus->pci_subsystem_vendor   = bus_settings.value("pci_subsystem_vendor", 0);
+        bus->pci_subsystem_device   = bus_settings.value("pci_subsystem_device", 0);
+
+        bus->set_latency_ns(bus_settings.value("latency_ns", 0ULL));
+
+        if(bus_settings.contains("devices"))
+        {
+            for(unsigned int device_idx = 0; device_idx < bus_settings["devices"].size(); device_idx++)
+            {
+                json            device_settings = bus_settings["devices"][device_idx];
+                std::string     type            = device_settings.value("type", "");
+                unsigned char   slot            = device_settings.value("slot", 0) & 0x07;
+                u16             jedec_id        = device_settings.value("jedec_id", 0);
+
+                if(type == "ene")
+                {
+                    bus->add_device(new i2c_smbus_simulated_ene(device_settings.value("address", 0x40), device_settings.value("name", "AUMA0-E6K5-0106"), device_settings.value("leds", 8)));
+                }
+                else if(type == "ene_dram")
+                {
+                    bus->add_device(new i2c_smbus_simulated_ene_dram(slot, device_settings.value("leds", 5)));
+                }
+                else if(type == "corsair_vengeance_pro")
+                {
+                    bus->add_device(new i2c_smbus_simulated_corsair_vengeance_pro(device_settings.value("address", 0x58)));
+                }
+                else if(type == "spd_ddr4")
+                {
+                    //The DDR4 EEPROMs on a bus share one page select
+                    if(ddr4_page == NULL)
+                    {
+                        ddr4_page = new i2c_smbus_simulated_spd_ddr4_page();
+                        bus->add_device(ddr4_page);
+                    }
+
+                    bus->add_device(new i2c_smbus_simulated_spd_ddr4(slot, jedec_id, ddr4_page));
+                }
+                else if(type == "spd_ddr5")
+                {
+                    bus->add_device(new i2c_smbus_simulated_spd_ddr5(slot, jedec_id));
+                }
+                else
+                {
+                    LOG_WARNING("[i2c_smbus_simulated] Unknown device type \"%s\" on %s", type.c_str(), bus->device_name);
+                }
+            }
+        }
+
+        LOG_INFO("[i2c_smbus_simulated] Registering %s", bus->device_name);
+
+        ResourceManager::get()->RegisterI2CBus(bus);
+    }
+
+    return(true);
+}   /* i2c_smbus_simulated_detect() */
+
+REGISTER_I2C_BUS_DETECTOR(i2c_smbus_simulated_detect);
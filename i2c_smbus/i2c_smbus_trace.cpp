@@ -0,0 +1,248 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_trace.cpp                                       |
+|                                                           |
+|   Records the SMBus/I2C transactions of the registered    |
+|   interfaces into a binary ring file                      |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstring>
+#include "i2c_smbus_trace.h"
+
+/*---------------------------------------------------------*\
+| The record count in the header is brought up to date this |
+| often, the records themselves carry their sequence number |
+\*---------------------------------------------------------*/
+#define I2C_SMBUS_TRACE_HEADER_INTERVAL 1024
+
+static bool CompareTraceRecords(const i2c_smbus_trace_record& a, const i2c_smbus_trace_record& b)
+{
+    return(a.sequence < b.sequence);
+}
+
+i2c_smbus_tracer::i2c_smbus_tracer()
+{
+    file = NULL;
+
+    memset(&header, 0, sizeof(header));
+}
+
+i2c_smbus_tracer::~i2c_smbus_tracer()
+{
+    close();
+}
+
+bool i2c_smbus_tracer::open(const std::string& filename, unsigned int capacity)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if(file != NULL || capacity == 0)
+    {
+        return(false);
+    }
+
+    file = fopen(filename.c_str(), "wb+");
+
+    if(file == NULL)
+    {
+        return(false);
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, I2C_SMBUS_TRACE_MAGIC, sizeof(header.magic));
+    header.version      = I2C_SMBUS_TRACE_VERSION;
+    header.record_size  = sizeof(i2c_smbus_trace_record);
+    header.capacity     = capacity;
+
+    start_time          = std::chrono::steady_clock::now();
+
+    write_header();
+
+    return(true);
+}
+
+void i2c_smbus_tracer::close()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if(file == NULL)
+    {
+        return;
+    }
+
+    write_header();
+    fclose(file);
+
+    file = NULL;
+}
+
+bool i2c_smbus_tracer::is_open()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    return(file != NULL);
+}
+
+u8 i2c_smbus_tracer::add_bus(i2c_smbus_interface* bus)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if(file == NULL)
+    {
+        return(I2C_SMBUS_TRACE_NO_BUS);
+    }
+
+    i2c_smbus_trace_bus trace_bus;
+
+    memset(&trace_bus, 0, sizeof(trace_bus));
+    snprintf(trace_bus.name, sizeof(trace_bus.name), "%.*s", (int)sizeof(trace_bus.name) - 1, bus->device_name);
+    trace_bus.pci_vendor            = bus->pci_vendor;
+    trace_bus.pci_device            = bus->pci_device;
+    trace_bus.pci_subsystem_vendor  = bus->pci_subsystem_vendor;
+    trace_bus.pci_subsystem_device  = bus->pci_subsystem_device;
+
+    /*-----------------------------------------------------*\
+    | A rescan registers the same busses again, keep their  |
+    | index so one bus is one stream of records             |
+    \*-----------------------------------------------------*/
+    for(u32 bus_idx = 0; bus_idx < header.bus_count; bus_idx++)
+    {
+        if(memcmp(&header.busses[bus_idx], &trace_bus, sizeof(trace_bus)) == 0)
+        {
+            return((u8)bus_idx);
+        }
+    }
+
+    if(header.bus_count >= I2C_SMBUS_TRACE_MAX_BUSSES)
+    {
+        return(I2C_SMBUS_TRACE_NO_BUS);
+    }
+
+    header.busses[header.bus_count] = trace_bus;
+    header.bus_count++;
+
+    write_header();
+
+    return((u8)(header.bus_count - 1));
+}
+
+void i2c_smbus_tracer::record(u8 bus, u8 addr, u8 flags, u8 command, int size, const u8* data, unsigned int length, s32 result, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if(file == NULL || bus == I2C_SMBUS_TRACE_NO_BUS)
+    {
+        return;
+    }
+
+    i2c_smbus_trace_record trace_record;
+
+    memset(&trace_record, 0, sizeof(trace_record));
+
+    if(length > sizeof(trace_record.data) || data == NULL)
+    {
+        length = (data == NULL) ? 0 : sizeof(trace_record.data);
+    }
+
+    trace_record.start_us       = (u32)std::chrono::duration_cast<std::chrono::microseconds>(start - start_time).count();
+    trace_record.duration_ns    = (u32)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    trace_record.result         = (short)std::max(-32768, std::min(32767, (int)result));
+    trace_record.bus            = bus;
+    trace_record.addr           = addr;
+    trace_record.flags          = flags;
+    trace_record.command        = command;
+    trace_record.size           = (u8)size;
+    trace_record.length         = (u8)length;
+
+    if(length > 0)
+    {
+        memcpy(trace_record.data, data, length);
+    }
+
+    trace_record.sequence = header.records;
+
+    fseek(file, (long)(sizeof(header) + (header.records % header.capacity) * sizeof(trace_record)), SEEK_SET);
+    fwrite(&trace_record, sizeof(trace_record), 1, file);
+
+    header.records++;
+
+    if((header.records % I2C_SMBUS_TRACE_HEADER_INTERVAL) == 0)
+    {
+        write_header();
+        fflush(file);
+    }
+}
+
+unsigned int i2c_smbus_tracer::data_length(int size, const i2c_smbus_data* data)
+{
+    if(data == NULL)
+    {
+        return(0);
+    }
+
+    switch(size)
+    {
+        case I2C_SMBUS_BYTE:
+        case I2C_SMBUS_BYTE_DATA:
+            return(1);
+
+        case I2C_SMBUS_WORD_DATA:
+        case I2C_SMBUS_PROC_CALL:
+            return(2);
+
+        case I2C_SMBUS_BLOCK_DATA:
+        case I2C_SMBUS_I2C_BLOCK_BROKEN:
+        case I2C_SMBUS_BLOCK_PROC_CALL:
+        case I2C_SMBUS_I2C_BLOCK_DATA:
+            return(std::min((unsigned int)data->block[0], (unsigned int)I2C_SMBUS_BLOCK_MAX) + 1);
+    }
+
+    return(0);
+}
+
+bool i2c_smbus_tracer::load(const std::string& filename, i2c_smbus_trace_header* header, std::vector<i2c_smbus_trace_record>* records)
+{
+    FILE* trace_file = fopen(filename.c_str(), "rb");
+
+    if(trace_file == NULL)
+    {
+        return(false);
+    }
+
+    bool valid = fread(header, sizeof(*header), 1, trace_file) == 1
+              && memcmp(header->magic, I2C_SMBUS_TRACE_MAGIC, sizeof(header->magic)) == 0
+              && header->version     == I2C_SMBUS_TRACE_VERSION
+              && header->record_size == sizeof(i2c_smbus_trace_record)
+              && header->bus_count   <= I2C_SMBUS_TRACE_MAX_BUSSES;
+
+    records->clear();
+
+    if(valid)
+    {
+        i2c_smbus_trace_record trace_record;
+
+        /*-------------------------------------------------*\
+        | The header count may be behind if the trace was   |
+        | not closed, so read every record in the file      |
+        \*-------------------------------------------------*/
+        while(records->size() < header->capacity && fread(&trace_record, sizeof(trace_record), 1, trace_file) == 1)
+        {
+            records->push_back(trace_record);
+        }
+
+        std::sort(records->begin(), records->end(), CompareTraceRecords);
+    }
+
+    fclose(trace_file);
+
+    return(valid);
+}
+
+void i2c_smbus_tracer::write_header()
+{
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+}
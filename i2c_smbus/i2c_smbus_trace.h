@@ -0,0 +1,104 @@
+/*---------------------------------------------------------*\
+| i2c_smbus_trace.h                                         |
+|                                                           |
+|   Records the SMBus/I2C transactions of the registered    |
+|   interfaces into a binary ring file                      |
+|                                                           |
+|   This file is part of the OpenRGB project                |
+|   SPDX-License-Identifier: GPL-2.0-only                   |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "i2c_smbus.h"
+
+#define I2C_SMBUS_TRACE_MAGIC           "ORGBSMBT"
+#define I2C_SMBUS_TRACE_VERSION         1
+#define I2C_SMBUS_TRACE_MAX_BUSSES      16
+#define I2C_SMBUS_TRACE_NO_BUS          0xFF
+
+// Record flags
+#define I2C_SMBUS_TRACE_FLAG_READ       0x01        /* Read transaction                     */
+#define I2C_SMBUS_TRACE_FLAG_I2C        0x02        /* Plain I2C transfer, not SMBus        */
+#define I2C_SMBUS_TRACE_FLAG_BATCH      0x04        /* Part of a batch, the result is that  */
+                                                    /* of the batch and its duration is     */
+                                                    /* split between its transactions       */
+
+/*---------------------------------------------------------*\
+| File layout: the header, then up to capacity records.     |
+| Record n of the trace is stored in slot n % capacity, so  |
+| once the ring is full the oldest records are overwritten. |
+| Readers order the records by their sequence number        |
+\*---------------------------------------------------------*/
+typedef struct
+{
+    char                name[64];
+    s32                 pci_vendor;
+    s32                 pci_device;
+    s32                 pci_subsystem_vendor;
+    s32                 pci_subsystem_device;
+} i2c_smbus_trace_bus;
+
+typedef struct
+{
+    char                magic[8];
+    u32                 version;
+    u32                 record_size;
+    u32                 capacity;
+    u32                 records;                /* Records written in total             */
+    u32                 bus_count;
+    u32                 reserved;
+    i2c_smbus_trace_bus busses[I2C_SMBUS_TRACE_MAX_BUSSES];
+} i2c_smbus_trace_header;
+
+typedef struct
+{
+    u32                 sequence;
+    u32                 start_us;               /* Time since the trace was opened      */
+    u32                 duration_ns;            /* Bus time including the handoff       */
+    short               result;
+    u8                  bus;
+    u8                  addr;
+    u8                  flags;
+    u8                  command;
+    u8                  size;                   /* SMBus transaction type               */
+    u8                  length;                 /* Bytes of data recorded               */
+    u8                  data[I2C_SMBUS_BLOCK_MAX + 2];
+    u8                  reserved[2];
+} i2c_smbus_trace_record;
+
+class i2c_smbus_tracer
+{
+public:
+    i2c_smbus_tracer();
+    ~i2c_smbus_tracer();
+
+    bool open(const std::string& filename, unsigned int capacity);
+    void close();
+    bool is_open();
+
+    //Returns the index of the bus in the trace, a bus seen before keeps its index
+    u8   add_bus(i2c_smbus_interface* bus);
+
+    //data holds the write data or the read result, length bytes of it are recorded
+    void record(u8 bus, u8 addr, u8 flags, u8 command, int size, const u8* data, unsigned int length, s32 result, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    //Bytes of an i2c_smbus_data that hold data for a transaction type
+    static unsigned int data_length(int size, const i2c_smbus_data* data);
+
+    //Reads a trace file, the records are returned oldest first
+    static bool load(const std::string& filename, i2c_smbus_trace_header* header, std::vector<i2c_smbus_trace_record>* records);
+
+private:
+    void write_header();
+
+    std::mutex                              mutex;
+    FILE*                                   file;
+    i2c_smbus_trace_header                  header;
+    std::chrono::steady_clock::time_point   start_time;
+};
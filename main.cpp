@@ -75,6 +75,8 @@ void WaitWhileServerOnline(NetworkServer* srv)
     while (srv->GetOnline())
     {
         std::this_thread::sleep_for(1s);
+
+        ResourceManager::get()->CheckForResume();
     };
 }
 
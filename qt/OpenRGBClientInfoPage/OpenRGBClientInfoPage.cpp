@@ -255,14 +255,16 @@ void Ui::OpenRGBClientInfoPage::on_ClientConnectButton_clicked()
     rgb_client->SetName(titleString.c_str());
     rgb_client->SetPort(port);
 
-    rgb_client->StartClient();
-
     /*-----------------------------------------------------*\
     | Add new client to list and register update callback   |
+    | before it starts, so its controllers go through the   |
+    | resource manager                                      |
     \*-----------------------------------------------------*/
     ResourceManager::get()->RegisterNetworkClient(rgb_client);
 
     rgb_client->RegisterClientInfoChangeCallback(UpdateInfoCallback, this);
+
+    rgb_client->StartClient();
 }
 
 void Ui::OpenRGBClientInfoPage::onClientDisconnectButton_clicked(QObject * arg)
@@ -1430,6 +1430,8 @@ void OpenRGBDialog2::OnSuspend()
 
 void OpenRGBDialog2::OnResume()
 {
+    ResourceManager::get()->InvalidateI2CRegisterCaches();
+
     if(SelectConfigProfile("resume_profile"))
     {
         on_ButtonLoadProfile_clicked();